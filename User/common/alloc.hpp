@@ -6,17 +6,24 @@
 
 #pragma once
 
+#include "arena.hpp"
+#include "dma_mem.h"
+#include "placement.h"
 #include <cmsis_os.h>
 #include <memory>  // std::unique_ptr
 #include <utility> // std::move
 
 namespace satoh
 {
+void *allocMem(std::size_t size, MemTag tag = MemTag::NORMAL) noexcept;
+
+void freeMem(void *ptr) noexcept;
+
 template <typename T, class... Args>
 T *alloc(Args... args) noexcept;
 
 template <typename T>
-T *allocArray(std::size_t size) noexcept;
+T *allocArray(std::size_t size, MemTag tag = MemTag::NORMAL) noexcept;
 
 template <typename T>
 class Deleter;
@@ -25,24 +32,58 @@ template <typename T>
 using UniquePtr = std::unique_ptr<T, Deleter<T>>;
 } // namespace satoh
 
-/// @brief RTOSからメモリ確保し、コンストラクタを呼び出しポインタを返す
+/// @brief メモリ確保する（アリーナ指定中ならばアリーナから、それ以外はRTOSから）
+/// @param [in] size バイト数
+/// @param [in] tag 置き場所（DTCMに空きがなければ通常の置き場所から確保する）
+/// @retval 0以外 確保したメモリ
+/// @retval 0 確保失敗
+inline void *satoh::allocMem(std::size_t size, MemTag tag) noexcept
+{
+  Arena *arena = Arena::getCurrent();
+  if (tag == MemTag::DTCM && !(arena && arena->isMeasuring())) // 計測中は、DTCMが足りない時に備えて通常の置き場所で数える
+  {
+    void *ptr = allocDspMem(size);
+    if (ptr)
+    {
+      return ptr;
+    }
+  }
+  return arena ? arena->alloc(size) : pvPortMalloc(size);
+}
+
+/// @brief satoh::allocMemで確保したメモリを開放する（アリーナのメモリはアリーナごとまとめて捨てるので何もしない）
+/// @param [in] ptr メモリ
+inline void satoh::freeMem(void *ptr) noexcept
+{
+  if (isDspMem(ptr))
+  {
+    freeDspMem(ptr);
+  }
+  else if (!Arena::contains(ptr))
+  {
+    vPortFree(ptr);
+  }
+}
+
+/// @brief satoh::allocMemでメモリ確保し、コンストラクタを呼び出しポインタを返す
 /// @tparam T メモリ確保する型
 /// @tparam Args コンストラクタ引数型
 /// @param [in] args コンストラクタ引数
 template <typename T, class... Args>
 T *satoh::alloc(Args... args) noexcept
 {
-  void *ptr = pvPortMalloc(sizeof(T));
+  void *ptr = allocMem(sizeof(T));
   return new (ptr) T(args...);
 }
 
-/// @brief RTOSからメモリ確保し、コンストラクタを呼ばずにポインタを返す
+/// @brief satoh::allocMemでメモリ確保し、コンストラクタを呼ばずにポインタを返す
 /// @tparam T メモリ確保する型
 /// @param [in] size メモリ確保する数
+/// @param [in] tag 置き場所
 template <typename T>
-T *satoh::allocArray(std::size_t size) noexcept
+T *satoh::allocArray(std::size_t size, MemTag tag) noexcept
 {
-  return static_cast<T *>(pvPortMalloc(size * sizeof(T)));
+  return static_cast<T *>(allocMem(size * sizeof(T), tag));
 }
 
 /// @brief satoh::allocでメモリ確保したオブジェクトを破棄する
@@ -63,7 +104,7 @@ public:
   void operator()(T *ptr) const
   {
     ptr->~T(); // 配置newしているので意図的にデストラクタを呼び出す必要がある
-    vPortFree(ptr);
+    freeMem(ptr);
   }
 };
 
@@ -82,5 +123,5 @@ public:
   }
   /// @brief オブジェクト破棄
   /// @param [in] ptr オブジェクトのポインタ
-  void operator()(T *ptr) const { vPortFree(ptr); }
+  void operator()(T *ptr) const { freeMem(ptr); }
 };
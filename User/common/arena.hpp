@@ -0,0 +1,183 @@
+/// @file      common/arena.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include <cmsis_os.h>
+#include <cstddef> // std::size_t
+#include <cstdint>
+
+namespace satoh
+{
+class Arena;
+} // namespace satoh
+
+/// @brief アリーナ（前から順に切り出し、まとめて捨てるメモリ領域）
+/// @note init() で一度だけ RTOS から領域を確保し、以降は開放しない（製品の動作中ずっと使う）。
+///   Scope で指定している間、そのスレッドの satoh::alloc・satoh::allocArray はアリーナから切り出す。
+///   アリーナから切り出したメモリは個別には開放せず、reset() でまとめて捨てる。
+///   init() していないアリーナは、RTOS から確保しつつ確保量だけを数える（必要量の計測に使う）。
+///   Scope はアプリタスクがエフェクターを生成する間だけ使う（同時に複数のスレッドからは指定しない）。
+class satoh::Arena
+{
+public:
+  static constexpr std::size_t ALIGNMENT = 8; ///< 切り出す境界
+
+private:
+  static constexpr std::size_t MAX_RANGE = 4; ///< 登録できる領域数
+
+  /// @brief 領域
+  struct Range
+  {
+    uint8_t const *top; ///< 先頭
+    uint8_t const *end; ///< 末尾の次
+  };
+
+  uint8_t *top_;       ///< 領域の先頭（0ならば計測のみ）
+  std::size_t size_;   ///< 領域のバイト数
+  std::size_t used_;   ///< 使用中のバイト数
+  std::size_t peak_;   ///< 使用量の最大値
+  uint32_t failCount_; ///< 容量不足で切り出せなかった回数
+
+  /// @brief 指定中のアリーナ
+  static Arena *&current() noexcept
+  {
+    static Arena *arena = 0;
+    return arena;
+  }
+  /// @brief アリーナを指定したスレッド
+  static osThreadId &owner() noexcept
+  {
+    static osThreadId id = 0;
+    return id;
+  }
+  /// @brief 登録した領域
+  static Range *ranges() noexcept
+  {
+    static Range range[MAX_RANGE] = {};
+    return range;
+  }
+
+public:
+  class Scope;
+
+  /// @brief コンストラクタ
+  Arena() noexcept : top_(0), size_(0), used_(0), peak_(0), failCount_(0) {}
+  /// @brief バイト数を境界に切り上げる
+  /// @param [in] size バイト数
+  /// @return 切り上げたバイト数
+  static constexpr std::size_t roundUp(std::size_t size) noexcept { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+  /// @brief 領域を確保する
+  /// @param [in] size バイト数
+  /// @retval true 成功
+  /// @retval false 失敗（RTOSの空き不足・登録できる領域数を超えた）
+  bool init(std::size_t size) noexcept
+  {
+    Range *range = ranges();
+    std::size_t n = 0;
+    for (; n < MAX_RANGE && range[n].top; ++n)
+    {
+    }
+    if (n == MAX_RANGE || size == 0)
+    {
+      return false;
+    }
+    size = roundUp(size);
+    top_ = static_cast<uint8_t *>(pvPortMalloc(size));
+    if (!top_)
+    {
+      return false;
+    }
+    size_ = size;
+    range[n] = Range{top_, top_ + size_};
+    reset();
+    return true;
+  }
+  /// @brief メモリを切り出す
+  /// @param [in] size バイト数
+  /// @retval 0以外 切り出したメモリ
+  /// @retval 0 容量不足
+  void *alloc(std::size_t size) noexcept
+  {
+    size = roundUp(size);
+    void *ptr = 0;
+    if (!top_)
+    {
+      ptr = pvPortMalloc(size); // 計測のみ
+    }
+    else if (size <= size_ - used_)
+    {
+      ptr = top_ + used_;
+    }
+    if (!ptr)
+    {
+      ++failCount_;
+      return 0;
+    }
+    used_ += size;
+    peak_ = used_ < peak_ ? peak_ : used_;
+    return ptr;
+  }
+  /// @brief 切り出したメモリをまとめて捨てる（使用量の最大値・失敗回数は残す）
+  void reset() noexcept { used_ = 0; }
+  /// @brief 領域のバイト数を取得 @return バイト数
+  std::size_t getSize() const noexcept { return size_; }
+  /// @brief 使用中のバイト数を取得 @return バイト数
+  std::size_t getUsedSize() const noexcept { return used_; }
+  /// @brief 空きバイト数を取得 @return バイト数
+  std::size_t getFreeSize() const noexcept { return size_ - used_; }
+  /// @brief 使用量の最大値を取得 @return バイト数
+  std::size_t getPeakSize() const noexcept { return peak_; }
+  /// @brief 容量不足で切り出せなかった回数を取得 @return 回数
+  uint32_t getFailCount() const noexcept { return failCount_; }
+  /// @brief 確保量を数えるだけのアリーナか（init() していない） @retval true 計測のみ @retval false 領域あり
+  bool isMeasuring() const noexcept { return !top_; }
+  /// @brief 呼び出したスレッドで指定中のアリーナを取得
+  /// @retval 0以外 アリーナ
+  /// @retval 0 指定なし（RTOSから確保する）
+  static Arena *getCurrent() noexcept { return current() && owner() == osThreadGetId() ? current() : 0; }
+  /// @brief いずれかのアリーナから切り出したメモリか
+  /// @param [in] ptr メモリ
+  /// @retval true アリーナのメモリ（個別には開放しない）
+  /// @retval false RTOSから確保したメモリ
+  static bool contains(void const *ptr) noexcept
+  {
+    auto const *p = static_cast<uint8_t const *>(ptr);
+    Range const *range = ranges();
+    for (std::size_t n = 0; n < MAX_RANGE && range[n].top; ++n)
+    {
+      if (range[n].top <= p && p < range[n].end)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/// @brief アリーナの指定（生存期間中、呼び出したスレッドの確保をアリーナから行う）
+class satoh::Arena::Scope
+{
+  Arena *prev_;      ///< 前に指定していたアリーナ
+  osThreadId owner_; ///< 前に指定していたスレッド
+
+public:
+  /// @brief コンストラクタ
+  /// @param [in] arena アリーナ
+  explicit Scope(Arena *arena) noexcept : prev_(current()), owner_(owner())
+  {
+    owner() = osThreadGetId();
+    current() = arena;
+  }
+  /// @brief デストラクタ
+  ~Scope()
+  {
+    current() = prev_;
+    owner() = owner_;
+  }
+  Scope(Scope const &) = delete;
+  Scope &operator=(Scope const &) = delete;
+};
@@ -5,37 +5,323 @@
 /// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
 
 #include "dma_mem.h"
+#include "cmsis_os.h"
+#include "placement.h"
 #include <cstdint>
 
 #define DMA_MEM_ALIGNMENT_SIZE 8
-#define DTCM_MEM __attribute__((section(".dtcm"))) __attribute__((aligned(DMA_MEM_ALIGNMENT_SIZE)))
+
+// 確保方法
+// - ブロック毎に先頭へヘッダー（自身のバイト数・直前のブロックのバイト数）を置き、前後のブロックを辿れるようにする。
+// - 空きブロックは、バイト数の2のべき乗毎のリスト（サイズクラス）に繋ぐ。
+//   確保は要求サイズのクラスから順に探し、最初に収まったブロックを使う（余りが最小ブロック以上ならば分割する）。
+// - 開放したブロックは、前後の空きブロックとすぐに結合する（空きブロックが隣り合うことはない）。
+// - 各タスクから呼ばれるので、RTOSのヒープと同じくスケジューラーを止めて排他する（割り込みからは呼ばない）。
+// - DMA転送用と演算用（MemTag::DTCM）は別の領域にし、エフェクターの状態がDMA転送用の容量を使わないようにする。
 
 namespace
 {
-/// メモリ全体のサイズ
-constexpr std::size_t TOTAL_SIZE = 24232;
+/// DMA転送用メモリ全体のサイズ
+constexpr std::size_t DMA_SIZE = 24232;
+/// 演算用メモリ全体のサイズ（Chorus・Ensemble のディレイバッファ 約2.9KB を4つ分）
+constexpr std::size_t DSP_SIZE = 12288;
+/// ブロックのヘッダーのバイト数
+constexpr uint32_t HEADER_SIZE = 8;
+/// ブロックの最小バイト数（ヘッダー + 空きリストのリンク）
+constexpr uint32_t MIN_BLOCK_SIZE = 16;
+/// 使用中フラグ（ブロックのバイト数の最下位ビット）
+constexpr uint32_t USED = 1;
+/// リンクなし
+constexpr uint32_t NIL = 0xFFFFFFFF;
+/// サイズクラス数（16 ～ 31 バイトのクラスから 16KB ～ 32KB のクラスまで）
+constexpr uint32_t CLASS_COUNT = 11;
+static_assert(DMA_SIZE % DMA_MEM_ALIGNMENT_SIZE == 0 && DSP_SIZE % DMA_MEM_ALIGNMENT_SIZE == 0, "pool size must be aligned");
+static_assert((DMA_SIZE >> (CLASS_COUNT + 4)) == 0 && (DSP_SIZE >> (CLASS_COUNT + 4)) == 0, "CLASS_COUNT must cover pool size");
+
+/// @brief ブロックのヘッダー
+struct Header
+{
+  uint32_t size; ///< ヘッダーを含むバイト数（使用中ならば USED を立てる）
+  uint32_t prev; ///< 直前のブロックのバイト数（先頭のブロックは0）
+};
+/// @brief 空きブロックのリンク（ヘッダーの直後に置く）
+struct Links
+{
+  uint32_t next; ///< 同じクラスの次の空きブロックの位置
+  uint32_t prev; ///< 同じクラスの前の空きブロックの位置
+};
+
+/// @brief 1つのメモリ領域の確保・開放
+class Pool
+{
+  std::uint8_t *const mem_;    ///< メモリ
+  const uint32_t total_;       ///< 全体のバイト数
+  uint32_t head_[CLASS_COUNT]; ///< サイズクラス毎の空きリストの先頭位置
+  bool ready_;                 ///< 初期化済み
+  std::size_t used_;           ///< 使用中のバイト数（ヘッダーを含む）
+  std::size_t peak_;           ///< 使用中のバイト数の最大値
+  uint32_t usedCount_;         ///< 使用中のブロック数
+  uint32_t failCount_;         ///< 確保に失敗した回数
+
+  /// @brief ブロックのヘッダーを取得 @param[in] pos ブロックの位置 @return ヘッダー
+  Header &header(uint32_t pos) noexcept { return *reinterpret_cast<Header *>(&mem_[pos]); }
+  /// @brief 空きブロックのリンクを取得 @param[in] pos ブロックの位置 @return リンク
+  Links &links(uint32_t pos) noexcept { return *reinterpret_cast<Links *>(&mem_[pos + HEADER_SIZE]); }
+  /// @brief ブロックのバイト数を取得 @param[in] pos ブロックの位置 @return バイト数
+  uint32_t blockSize(uint32_t pos) noexcept { return header(pos).size & ~USED; }
+  /// @brief ブロックが使用中か @param[in] pos ブロックの位置 @retval true 使用中 @retval false 空き
+  bool isUsed(uint32_t pos) noexcept { return header(pos).size & USED; }
+  /// @brief サイズクラスを求める @param[in] size バイト数（MIN_BLOCK_SIZE以上） @return サイズクラス
+  static uint32_t classOf(uint32_t size) noexcept
+  {
+    const uint32_t c = 31 - __builtin_clz(size) - 4; // 16 ～ 31 バイトがクラス0
+    return c < CLASS_COUNT ? c : CLASS_COUNT - 1;
+  }
+  /// @brief 空きブロックをリストに繋ぐ @param[in] pos ブロックの位置
+  void insert(uint32_t pos) noexcept
+  {
+    const uint32_t c = classOf(blockSize(pos));
+    Links &l = links(pos);
+    l.prev = NIL;
+    l.next = head_[c];
+    if (l.next != NIL)
+    {
+      links(l.next).prev = pos;
+    }
+    head_[c] = pos;
+  }
+  /// @brief 空きブロックをリストから外す @param[in] pos ブロックの位置
+  void remove(uint32_t pos) noexcept
+  {
+    Links const &l = links(pos);
+    if (l.prev != NIL)
+    {
+      links(l.prev).next = l.next;
+    }
+    else
+    {
+      head_[classOf(blockSize(pos))] = l.next;
+    }
+    if (l.next != NIL)
+    {
+      links(l.next).prev = l.prev;
+    }
+  }
+  /// @brief 後ろのブロックに、直前のブロックのバイト数を設定する @param[in] pos ブロックの位置
+  void linkNext(uint32_t pos) noexcept
+  {
+    const uint32_t next = pos + blockSize(pos);
+    if (next < total_)
+    {
+      header(next).prev = blockSize(pos);
+    }
+  }
+  /// @brief 全体を1つの空きブロックにする（初回の呼び出し時に行う）
+  void init() noexcept
+  {
+    for (auto &h : head_)
+    {
+      h = NIL;
+    }
+    header(0) = Header{total_, 0};
+    insert(0);
+    ready_ = true;
+  }
+  /// @brief 要求サイズが収まる空きブロックを探す @param[in] size バイト数（ヘッダーを含む） @return ブロックの位置（見つからなければ NIL）
+  uint32_t search(uint32_t size) noexcept
+  {
+    for (uint32_t c = classOf(size); c < CLASS_COUNT; ++c)
+    {
+      for (uint32_t pos = head_[c]; pos != NIL; pos = links(pos).next)
+      {
+        if (size <= blockSize(pos))
+        {
+          return pos;
+        }
+      }
+    }
+    return NIL;
+  }
+
+public:
+  /// @brief コンストラクタ（定数初期化できるようにし、他の静的オブジェクトの初期化より前に使えるようにする）
+  /// @param [in] mem メモリ
+  /// @param [in] total 全体のバイト数
+  constexpr Pool(std::uint8_t *mem, uint32_t total) noexcept
+      : mem_(mem), total_(total), head_{}, ready_(false), used_(0), peak_(0), usedCount_(0), failCount_(0)
+  {
+  }
+  /// @brief 確保する @param [in] size バイト数 @return メモリ（0は失敗）
+  void *alloc(std::size_t size) noexcept;
+  /// @brief 開放する @param [in] ptr メモリ（0・範囲外・二重開放は無視する）
+  void free(void *ptr) noexcept;
+  /// @brief この領域のメモリか @param [in] ptr メモリ @retval true この領域 @retval false それ以外
+  bool contains(void const *ptr) const noexcept
+  {
+    auto const *p = static_cast<std::uint8_t const *>(ptr);
+    return mem_ <= p && p < mem_ + total_;
+  }
+  /// @brief 残量を取得 @return バイト数（管理用のヘッダーを含む）
+  std::size_t getFreeSize() const noexcept { return total_ - used_; }
+  /// @brief 使用状況を取得 @return 使用状況
+  satoh::DmaMemStat getStat() noexcept;
+};
+
+void *Pool::alloc(std::size_t size) noexcept
+{
+  if (total_ < size)
+  {
+    ++failCount_;
+    return 0;
+  }
+  uint32_t need = (size + HEADER_SIZE + DMA_MEM_ALIGNMENT_SIZE - 1) & ~(DMA_MEM_ALIGNMENT_SIZE - 1);
+  need = need < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : need;
+  if (!ready_)
+  {
+    init();
+  }
+  const uint32_t pos = search(need);
+  if (pos == NIL)
+  {
+    ++failCount_;
+    return 0;
+  }
+  remove(pos);
+  const uint32_t rest = blockSize(pos) - need;
+  if (MIN_BLOCK_SIZE <= rest)
+  {
+    // 余りを空きブロックとして切り分ける
+    header(pos).size = need;
+    header(pos + need) = Header{rest, need};
+    linkNext(pos + need);
+    insert(pos + need);
+  }
+  header(pos).size |= USED;
+  used_ += blockSize(pos);
+  peak_ = used_ < peak_ ? peak_ : used_;
+  ++usedCount_;
+  return &mem_[pos + HEADER_SIZE];
+}
+void Pool::free(void *ptr) noexcept
+{
+  auto *p = static_cast<std::uint8_t *>(ptr);
+  if (p < mem_ + HEADER_SIZE || mem_ + total_ <= p)
+  {
+    return; // 0・範囲外は無視する
+  }
+  uint32_t pos = static_cast<uint32_t>(p - mem_) - HEADER_SIZE;
+  if (!isUsed(pos))
+  {
+    return; // 二重開放は無視する
+  }
+  header(pos).size &= ~USED;
+  used_ -= blockSize(pos);
+  --usedCount_;
+  const uint32_t next = pos + blockSize(pos);
+  if (next < total_ && !isUsed(next))
+  {
+    remove(next);
+    header(pos).size += blockSize(next);
+  }
+  if (header(pos).prev != 0 && !isUsed(pos - header(pos).prev))
+  {
+    const uint32_t prev = pos - header(pos).prev;
+    remove(prev);
+    header(prev).size += blockSize(pos);
+    pos = prev;
+  }
+  linkNext(pos);
+  insert(pos);
+}
+satoh::DmaMemStat Pool::getStat() noexcept
+{
+  if (!ready_)
+  {
+    init();
+  }
+  satoh::DmaMemStat stat{};
+  stat.total = total_;
+  stat.used = used_;
+  stat.peak = peak_;
+  stat.usedCount = usedCount_;
+  stat.failCount = failCount_;
+  for (uint32_t c = 0; c < CLASS_COUNT; ++c)
+  {
+    for (uint32_t pos = head_[c]; pos != NIL; pos = links(pos).next)
+    {
+      const std::size_t size = blockSize(pos) - HEADER_SIZE;
+      stat.largest = stat.largest < size ? size : stat.largest;
+      ++stat.freeCount;
+    }
+  }
+  return stat;
+}
+
+/// @brief 排他区間（スケジューラーを止める）
+class Lock
+{
+public:
+  /// @brief コンストラクタ（スケジューラーを止める）
+  Lock() noexcept { vTaskSuspendAll(); }
+  /// @brief デストラクタ（スケジューラーを再開する）
+  ~Lock() { xTaskResumeAll(); }
+};
+
 /// DTCM領域に確保したDMA専用メモリ（D-Cacheの影響を受けない）
-std::uint8_t s_dmaMem[TOTAL_SIZE] DTCM_MEM;
-/// 現在位置
-size_t s_pos = 0;
+std::uint8_t s_dmaMem[DMA_SIZE] DTCM_MEM __attribute__((aligned(DMA_MEM_ALIGNMENT_SIZE)));
+/// DTCM領域に確保した演算用メモリ（0ウェイトで読み書きする短いバッファ）
+std::uint8_t s_dspMem[DSP_SIZE] DTCM_MEM __attribute__((aligned(DMA_MEM_ALIGNMENT_SIZE)));
+/// DMA転送用メモリの管理
+Pool s_dma(s_dmaMem, DMA_SIZE);
+/// 演算用メモリの管理
+Pool s_dsp(s_dspMem, DSP_SIZE);
 } // namespace
 
 void *satoh::allocDmaMem(std::size_t size) noexcept
 {
-  size = (size + DMA_MEM_ALIGNMENT_SIZE - 1) & ~(DMA_MEM_ALIGNMENT_SIZE - 1);
-  if (size + s_pos <= TOTAL_SIZE)
+  Lock lock;
+  return s_dma.alloc(size);
+}
+void satoh::freeDmaMem(void *ptr) noexcept
+{
+  if (s_dma.contains(ptr))
   {
-    auto res = &s_dmaMem[s_pos];
-    s_pos += size;
-    return res;
+    Lock lock;
+    s_dma.free(ptr);
   }
-  return 0;
 }
-void satoh::freeDmaMem(void *ptr) noexcept
+bool satoh::isDmaMem(void const *ptr) noexcept
 {
-  static_cast<void>(ptr); // unused
+  return s_dma.contains(ptr);
 }
 size_t satoh::getFreeDmaMemSize() noexcept
 {
-  return TOTAL_SIZE - s_pos;
+  return s_dma.getFreeSize();
+}
+satoh::DmaMemStat satoh::getDmaMemStat() noexcept
+{
+  Lock lock;
+  return s_dma.getStat();
+}
+void *satoh::allocDspMem(std::size_t size) noexcept
+{
+  Lock lock;
+  return s_dsp.alloc(size);
+}
+void satoh::freeDspMem(void *ptr) noexcept
+{
+  if (s_dsp.contains(ptr))
+  {
+    Lock lock;
+    s_dsp.free(ptr);
+  }
+}
+bool satoh::isDspMem(void const *ptr) noexcept
+{
+  return s_dsp.contains(ptr);
+}
+satoh::DmaMemStat satoh::getDspMemStat() noexcept
+{
+  Lock lock;
+  return s_dsp.getStat();
 }
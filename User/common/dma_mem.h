@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstddef> // std::size_t
+#include <cstdint>
 #include <memory>
 
 namespace satoh
@@ -17,12 +18,47 @@ namespace satoh
 /// @retval 0 確保失敗（容量不足）
 void *allocDmaMem(std::size_t size) noexcept;
 /// @brief DMA転送に使うメモリを開放する
-/// @param [in] ptr 開放するメモリ
-/// @note 現在は開放できない
+/// @param [in] ptr 開放するメモリ（0・二重開放は無視する）
+/// @note 前後の空き領域と結合し、再び確保できるようにする
 void freeDmaMem(void *ptr) noexcept;
+/// @brief DMA転送に使うメモリか
+/// @param [in] ptr メモリ
+/// @retval true satoh::allocDmaMem で確保したメモリ（DTCM）
+/// @retval false それ以外
+bool isDmaMem(void const *ptr) noexcept;
 /// @brief DMA転送に使うメモリの残量を取得する
-/// @return DMA転送に使うメモリの残量
+/// @return DMA転送に使うメモリの残量（管理用のヘッダーを含む 断片化していると一度には確保できない）
 size_t getFreeDmaMemSize() noexcept;
+/// @brief DMA転送に使うメモリの使用状況
+struct DmaMemStat
+{
+  std::size_t total;   ///< 全体のバイト数
+  std::size_t used;    ///< 使用中のバイト数（管理用のヘッダーを含む）
+  std::size_t peak;    ///< 使用中のバイト数の最大値
+  std::size_t largest; ///< 一度に確保できる最大のバイト数
+  uint32_t usedCount;  ///< 使用中のブロック数
+  uint32_t freeCount;  ///< 空きブロック数（断片化の目安）
+  uint32_t failCount;  ///< 確保に失敗した回数
+};
+/// @brief DMA転送に使うメモリの使用状況を取得する
+/// @return 使用状況
+DmaMemStat getDmaMemStat() noexcept;
+/// @brief 演算用のDTCMメモリを確保する（MemTag::DTCM DMA転送用とは別の領域）
+/// @param [in] size 確保するバイト数
+/// @retval 0以外 確保したメモリのポインタ
+/// @retval 0 確保失敗（容量不足 呼び出し側は通常のヒープから確保する）
+void *allocDspMem(std::size_t size) noexcept;
+/// @brief 演算用のDTCMメモリを開放する
+/// @param [in] ptr 開放するメモリ（0・範囲外・二重開放は無視する）
+void freeDspMem(void *ptr) noexcept;
+/// @brief 演算用のDTCMメモリか
+/// @param [in] ptr メモリ
+/// @retval true satoh::allocDspMem で確保したメモリ
+/// @retval false それ以外
+bool isDspMem(void const *ptr) noexcept;
+/// @brief 演算用のDTCMメモリの使用状況を取得する
+/// @return 使用状況
+DmaMemStat getDspMemStat() noexcept;
 /// @brief DMA転送メモリを開放するクラス
 /// @tparam T データ型
 template <typename T>
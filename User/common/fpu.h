@@ -0,0 +1,36 @@
+/// @file      common/fpu.h
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#if defined(__ARM_FP)
+#include "main.h" // __get_FPSCR, __set_FPSCR, FPU
+#elif defined(__SSE__)
+#include <pmmintrin.h> // _MM_SET_DENORMALS_ZERO_MODE
+#include <xmmintrin.h> // _MM_SET_FLUSH_ZERO_MODE
+#endif
+#include <cstdint>
+
+namespace satoh
+{
+/// @brief 非正規化数を0にする（Flush-to-zero）
+/// @note リバーブ・ディレイのフィードバックやIIRフィルタが0へ減衰する途中で非正規化数になると、
+///   ホスト（x86）では演算が極端に遅くなり、ツールチェーンによって結果も変わってしまう。
+///   Cortex-M7 は FPSCR の FZ ビット、x86 は MXCSR の FTZ・DAZ ビットを立てる。
+///   FPSCR はタスク毎に退避・復帰されるので、浮動小数点演算を行うタスクの先頭で呼ぶこと。
+///   FPDSCR（初めて浮動小数点演算を行うコンテキストの FPSCR 初期値）にも FZ を立てておく。
+inline void enableFlushToZero() noexcept
+{
+#if defined(__ARM_FP)
+  constexpr uint32_t FZ = 1UL << 24; // FPSCR Flush-to-zero mode
+  __set_FPSCR(__get_FPSCR() | FZ);
+  FPU->FPDSCR |= FPU_FPDSCR_FZ_Msk;
+#elif defined(__SSE__)
+  _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+  _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+#endif
+}
+} // namespace satoh
@@ -0,0 +1,30 @@
+/// @file      common/placement.h
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include <cstdint>
+
+/// @brief 関数を ITCM に置く（0ウェイトで命令を読み出す 起動時にフラッシュからコピーする）
+/// @note ITCM は 16KB しかないので、音声処理のブロック毎に呼ばれる内側のループだけに使う。
+///   置いた関数と置かれた場所は、ビルド時に出力する配置レポート（ReactiveEffector.placement.txt）で確認する。
+///   ITCM（0番地～）とフラッシュ・libm の間は BL が届かないので、呼び出しはリンカーが加える中継（__*_veneer）を経由する。
+///   呼び出し元が ITCM の中継も ITCM に置かれるので、ループの中からフラッシュの関数を呼ばないようにする。
+///   ITCM の先頭（_itcm_guard バイト）は未定義命令で埋めてあり、0番地への関数呼び出しは関数を実行せずに例外になる。
+#define ITCM_CODE __attribute__((section(".itcm"), noinline))
+
+/// @brief 静的変数を DTCM に置く（0ウェイトで読み書きでき、D-Cacheの影響を受けない 初期化はしない）
+#define DTCM_MEM __attribute__((section(".dtcm")))
+
+namespace satoh
+{
+/// @brief 動的に確保するメモリの置き場所
+enum class MemTag : uint8_t
+{
+  NORMAL = 0, ///< 通常（アリーナ指定中ならばアリーナ、それ以外はRTOSのヒープ）
+  DTCM,       ///< DTCM（DMA転送用とは別の演算用の領域 空きがなければ通常の置き場所）
+};
+} // namespace satoh
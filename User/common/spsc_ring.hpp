@@ -0,0 +1,102 @@
+/// @file      common/spsc_ring.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "alloc.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring> // memcpy
+
+namespace satoh
+{
+template <typename T>
+class SpscRing;
+} // namespace satoh
+
+/// @brief ロックフリーのリングバッファ（書き込み1タスク・読み出し1タスク専用）
+/// @tparam T 要素型（memcpyでコピーできる型）
+/// @note 書き込み位置は書き込み側だけ、読み出し位置は読み出し側だけが更新するので、ミューテックス不要。
+///   音声タスクから書き込み、低優先度タスクで読み出すといった用途を想定している。
+template <typename T>
+class satoh::SpscRing
+{
+  /// @brief コピーコンストラクタ削除
+  SpscRing(SpscRing const &) = delete;
+  /// @brief 代入演算子削除
+  SpscRing &operator=(SpscRing const &) = delete;
+
+  UniquePtr<T> buf_;           ///< バッファ
+  uint32_t size_;              ///< バッファ要素数（2のべき乗）
+  std::atomic<uint32_t> wcnt_; ///< 書き込み済み要素数（書き込み側のみ更新）
+  std::atomic<uint32_t> rcnt_; ///< 読み出し済み要素数（読み出し側のみ更新）
+
+  /// @brief 2のべき乗に切り上げる @param [in] n 値 @return 切り上げた値
+  static uint32_t ceilPow2(uint32_t n) noexcept
+  {
+    uint32_t v = 1;
+    while (v < n)
+    {
+      v *= 2;
+    }
+    return v;
+  }
+
+public:
+  /// @brief コンストラクタ
+  /// @param [in] size バッファ要素数（2のべき乗に切り上げる）
+  explicit SpscRing(uint32_t size) noexcept  //
+      : buf_(allocArray<T>(ceilPow2(size))), //
+        size_(ceilPow2(size)),               //
+        wcnt_(0),                            //
+        rcnt_(0)                             //
+  {
+  }
+  /// @brief デストラクタ
+  virtual ~SpscRing() {}
+  /// @brief メモリ確保成功・失敗を取得
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return static_cast<bool>(buf_); }
+  /// @brief バッファ要素数取得 @return バッファ要素数
+  uint32_t capacity() const noexcept { return size_; }
+  /// @brief 読み出し可能な要素数取得 @return 要素数
+  uint32_t size() const noexcept { return wcnt_.load(std::memory_order_acquire) - rcnt_.load(std::memory_order_acquire); }
+  /// @brief 書き込む（書き込み側タスクから呼ぶこと）
+  /// @param [in] src 書き込むデータ
+  /// @param [in] n 要素数
+  /// @return 書き込んだ要素数（空きが足りない分は捨てる）
+  uint32_t push(T const *src, uint32_t n) noexcept
+  {
+    uint32_t w = wcnt_.load(std::memory_order_relaxed);
+    uint32_t r = rcnt_.load(std::memory_order_acquire);
+    n = std::min(n, size_ - (w - r));
+    uint32_t pos = w & (size_ - 1);
+    uint32_t n1 = std::min(n, size_ - pos);
+    memcpy(buf_.get() + pos, src, n1 * sizeof(T));
+    memcpy(buf_.get(), src + n1, (n - n1) * sizeof(T));
+    wcnt_.store(w + n, std::memory_order_release);
+    return n;
+  }
+  /// @brief 読み出す（読み出し側タスクから呼ぶこと）
+  /// @param [out] dst 読み出し先
+  /// @param [in] n 要素数
+  /// @return 読み出した要素数
+  uint32_t pop(T *dst, uint32_t n) noexcept
+  {
+    uint32_t r = rcnt_.load(std::memory_order_relaxed);
+    uint32_t w = wcnt_.load(std::memory_order_acquire);
+    n = std::min(n, w - r);
+    uint32_t pos = r & (size_ - 1);
+    uint32_t n1 = std::min(n, size_ - pos);
+    memcpy(dst, buf_.get() + pos, n1 * sizeof(T));
+    memcpy(dst + n1, buf_.get(), (n - n1) * sizeof(T));
+    rcnt_.store(r + n, std::memory_order_release);
+    return n;
+  }
+  /// @brief 読み出さずに捨てる（読み出し側タスクから呼ぶこと）
+  void clear() noexcept { rcnt_.store(wcnt_.load(std::memory_order_acquire), std::memory_order_release); }
+};
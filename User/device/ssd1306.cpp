@@ -218,7 +218,7 @@ bool satoh::SSD1306::update(msg::OLED_DISP_EFFECTOR const &src) noexcept
   memset(disp, 0, BUF_SIZE);
   satoh::FontDef const &titleFont = satoh::Font_11x18;
   satoh::FontDef const &paramFont = satoh::Font_7x10;
-  if (!src.fx)
+  if (!src.name)
   {
     drawString(BYPASS_NAME, titleFont, false, 0, 0, disp);
     return sendBufferToDevice();
@@ -228,18 +228,18 @@ bool satoh::SSD1306::update(msg::OLED_DISP_EFFECTOR const &src) noexcept
     char txt[16] = {0};
     sprintf(txt, "FX%d ", src.patch);
     drawString(txt, paramFont, false, 0, 0, disp);
-    drawString(src.fx->getName(), titleFont, false, paramFont.width * 4, 0, disp);
+    drawString(src.name, titleFont, false, paramFont.width * 4, 0, disp);
   }
   uint8_t n = 0;
   for (uint8_t col = 0; col < 2; ++col)
   {
-    for (uint8_t row = 0; row < 3 && n < src.fx->getParamCount(); ++row, ++n)
+    for (uint8_t row = 0; row < 3 && n < src.paramCount; ++row, ++n)
     {
       uint8_t y = titleFont.height + 6 + row * (paramFont.height + 5);
       uint8_t cx = col * WIDTH / 2;
-      const char *key = src.fx->getParamName(n);
+      const char *key = src.paramName[n];
       drawString(key, paramFont, n == src.selectedParam, cx, y, disp);
-      const char *value = src.fx->getValueTxt(n);
+      const char *value = src.value[n];
       size_t len = strlen(value);
       uint8_t px = cx + 43;
       if (2 < len)
@@ -264,14 +264,14 @@ bool satoh::SSD1306::update(msg::OLED_DISP_BANK const &src) noexcept
   {
     drawString("EDIT", titleFont, true, titleFont.width * 7, 0, disp);
   }
-  for (size_t i = 0; i < countof(src.fx); ++i)
+  for (size_t i = 0; i < countof(src.name); ++i)
   {
     constexpr uint8_t margin = 5;
     uint8_t y = titleFont.height + margin + (paramFont.height + margin) * i;
     uint8_t patch = i + 1;
     int n = sprintf(txt, "FX%d:", i + 1);
     drawString(txt, paramFont, src.editMode && src.selectedFx == patch, 0, y, disp);
-    const char *name = src.fx[i] ? src.fx[i]->getName() : BYPASS_NAME;
+    const char *name = src.name[i] ? src.name[i] : BYPASS_NAME;
     drawString(name, paramFont, false, paramFont.width * (n + 1), y, disp);
   }
   return sendBufferToDevice();
@@ -303,6 +303,35 @@ bool satoh::SSD1306::update(msg::OLED_DISP_TUNER const &src) noexcept
   const auto &font = Font_7x10;
   uint8_t *disp = getDispBuffer();
   memset(disp, 0, BUF_SIZE);
+  if (src.poly)
+  {
+    // 弦毎に縦のメーターを並べる（上がシャープ側、合っていれば音名を反転）
+    constexpr uint8_t COUNT = sizeof(src.strDiff) / sizeof(src.strDiff[0]);
+    constexpr uint8_t COL_WIDTH = WIDTH / COUNT;
+    constexpr uint8_t CENTER = 32;
+    drawString("POLY TUNER", font, false, 29, 0, disp);
+    for (uint8_t n = 0; n < COUNT; ++n)
+    {
+      uint8_t x = n * COL_WIDTH + (COL_WIDTH - font.width) / 2;
+      for (uint8_t dx = 0; dx < font.width; ++dx)
+      {
+        drawPixel(1, x + dx, CENTER, disp);
+      }
+      if (src.strEstimated[n])
+      {
+        uint8_t y = CENTER - src.strDiff[n] * 2;
+        for (uint8_t dy = 0; dy < 3; ++dy)
+        {
+          for (uint8_t dx = 0; dx < font.width; ++dx)
+          {
+            drawPixel(1, x + dx, y + dy - 1, disp);
+          }
+        }
+      }
+      drawString(src.strName[n], font, src.strEstimated[n] && src.strDiff[n] == 0, x, HEIGHT - font.height, disp);
+    }
+    return sendBufferToDevice();
+  }
   drawString("TUNER", font, false, 40, 0, disp);
   if (src.estimated)
   {
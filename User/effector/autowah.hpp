@@ -41,6 +41,7 @@ class satoh::fx::AutoWah : public satoh::fx::EffectorBase
   float q_;                    ///< Q 1.0～9.0
   float hifreq_;               ///< HIGH FREQ BPF中心周波数 最高 1000～9000Hz
   float lofreq_;               ///< LOW FREQ BPF中心周波数 最低 100～900Hz
+  float work_[BLOCK_SIZE];     ///< エンベロープ・周波数の作業領域
 
   /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
   /// @param [in] n 変換対象のパラメータ番号
@@ -121,23 +122,28 @@ public:
   /// @brief エフェクト処理実行
   /// @param[inout] left L音声データ
   /// @param[inout] right R音声データ
-  /// @param [in] size 音声データ数
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
   void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    float *work = work_;
     for (uint32_t i = 0; i < size; ++i)
     {
-      float fx = right[i];
-      float env = std::abs(fx);
-      env = lpf1.process(env);                              // 絶対値とLPFでエンベロープ取得
-      env = gainToDb(env);                                  // dB換算
-      env = env + sens_;                                    // SENSITIVITY 感度(エンベロープ補正)
-      compress(-20.0f, env, 0.0f);                          // -20～0dBまででクリップ
-      env = lpf2.process(env);                              // 急激な変化を避ける
-      float freq = hifreq_ * dbToGain(logFreqRatio_ * env); // エンベロープに応じた周波数を計算 指数的変化
-      bpf1.setBPF(freq, q_);                                // フィルタ周波数を設定
-      fx = bpf1.process(fx);                                // フィルタ(ワウ)実行
-      fx = level_ * fx;                                     // LEVEL
-      right[i] = fx;
+      work[i] = lpf1.process(std::abs(right[i])); // 絶対値とLPFでエンベロープ取得
+    }
+    gainToDb(work, work, size); // dB換算
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      float env = work[i] + sens_;   // SENSITIVITY 感度(エンベロープ補正)
+      compress(-20.0f, env, 0.0f);   // -20～0dBまででクリップ
+      env = lpf2.process(env);       // 急激な変化を避ける
+      work[i] = logFreqRatio_ * env; // 周波数変化比 dB
+    }
+    dbToGain(work, work, size); // エンベロープに応じた周波数を計算 指数的変化
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      bpf1.setBPF(hifreq_ * work[i], q_); // フィルタ周波数を設定
+      float fx = bpf1.process(right[i]);  // フィルタ(ワウ)実行
+      right[i] = level_ * fx;             // LEVEL
     }
   }
 };
@@ -107,4 +107,13 @@ public:
       right[i] = fx;
     }
   }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数
+  uint32_t getTailLength() const noexcept override { return iirTail(90.0f, 130.0f); } // HPF・LPFとも約100Hz以上 後段に LEVEL 最大 +10dB がある
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  void clearState() noexcept override
+  {
+    hpf_.reset();
+    lpf_.reset();
+  }
 };
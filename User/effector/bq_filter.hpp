@@ -140,4 +140,9 @@ public:
       right[i] = fx;
     }
   }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数
+  uint32_t getTailLength() const noexcept override { return bqTail(freq_, q_); }
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  void clearState() noexcept override { bqf1.reset(); }
 };
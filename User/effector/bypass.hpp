@@ -47,4 +47,7 @@ public:
   {
     // do nothing
   }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数
+  uint32_t getTailLength() const noexcept override { return 0; }
 };
@@ -0,0 +1,143 @@
+/// @file      effector/cabinet.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "cabinet_ir.h"
+#include "effector_base.h"
+#include "lib/lib_calc.hpp"
+#include "lib/lib_conv.hpp"
+#include <cstdio> // sprintf
+
+namespace satoh
+{
+namespace fx
+{
+class Cabinet;
+}
+} // namespace satoh
+
+/// @brief キャビネットシミュレーター（内蔵IRの畳み込み）
+class satoh::fx::Cabinet : public satoh::fx::EffectorBase
+{
+  enum
+  {
+    LEVEL = 0, ///< レベル
+    MIX,       ///< ミックス
+    TYPE,      ///< IR選択
+    COUNT,     ///< パラメータ総数
+  };
+
+  /// @brief IR1つあたりの分割数
+  static constexpr uint32_t PARTS = UniformConvolver::partitionCount(cabinet::IR_LENGTH);
+  /// @brief IR1つあたりのスペクトル要素数
+  static constexpr uint32_t SPEC_SIZE = PARTS * UniformConvolver::FFT_SIZE;
+
+  EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
+  mutable char valueTxt_[16];  ///< パラメータ文字列格納バッファ
+  UniformConvolver conv_;      ///< 畳み込み
+  UniquePtr<float> spec_;      ///< 全IRのスペクトル（IR切替時に再計算しないよう事前に計算しておく）
+  float wet_[BLOCK_SIZE];      ///< 畳み込み結果
+  float level_;                ///< レベル
+  float mix_;                  ///< ミックス
+  uint32_t type_;              ///< IR番号
+
+  /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
+  /// @param [in] n 変換対象のパラメータ番号
+  void convUiToFx(uint8_t n) noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+      level_ = dbToGain(ui_[LEVEL].getValue()); // LEVEL -20...+20 dB
+      break;
+    case MIX:
+      mix_ = mixPot(ui_[MIX].getValue(), -20.0f); // MIX
+      break;
+    case TYPE:
+      type_ = static_cast<uint32_t>(ui_[TYPE].getValue()); // IR選択
+      break;
+    }
+  }
+  /// @brief パラメータ値文字列取得
+  /// @param [in] n パラメータ番号
+  /// @return 文字列のポインタ
+  const char *getValueTxtImpl(uint8_t n) const noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+    {
+      int v = static_cast<int>(ui_[n].getValue());
+      if (v <= 0)
+      {
+        sprintf(valueTxt_, "%d", v);
+      }
+      else
+      {
+        sprintf(valueTxt_, "+%d", v);
+      }
+      return valueTxt_;
+    }
+    case MIX:
+      sprintf(valueTxt_, "%d", static_cast<int>(ui_[n].getValue()));
+      return valueTxt_;
+    case TYPE:
+      return cabinet::IR_NAME[type_];
+    default:
+      return 0;
+    }
+  }
+
+public:
+  /// @brief コンストラクタ
+  Cabinet()                                                            //
+      : EffectorBase(CABINET, "Cabinet", "CB", RGB{0x10, 0x20, 0x00}), //
+        ui_{
+            EffectParameterF(-20, 20, 1, "LV"),                    //
+            EffectParameterF(0, 100, 1, "MIX"),                    //
+            EffectParameterF(0, cabinet::IR_COUNT - 1, 1, "TYPE"), //
+        },                                                         //
+        conv_(PARTS),                                              //
+        spec_(allocArray<float>(cabinet::IR_COUNT * SPEC_SIZE)),   //
+        level_(1),                                                 //
+        mix_(1),                                                   //
+        type_(0)                                                   //
+  {
+    if (*this)
+    {
+      for (uint32_t i = 0; i < cabinet::IR_COUNT; ++i)
+      {
+        conv_.makeSpectrum(cabinet::IR[i], cabinet::IR_LENGTH, spec_.get() + i * SPEC_SIZE);
+      }
+      init(ui_, COUNT);
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~Cabinet() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return conv_ && spec_; }
+  /// @brief エフェクト処理実行
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数（BLOCK_SIZE固定）
+  void effect(float *left, float *right, uint32_t size) noexcept override
+  {
+    conv_.process(right, wet_, spec_.get() + type_ * SPEC_SIZE, PARTS);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      float fx = (1.0f - mix_) * right[i] + mix_ * wet_[i];
+      right[i] = level_ * fx;
+    }
+  }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数
+  uint32_t getTailLength() const noexcept override { return cabinet::IR_LENGTH; }
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  void clearState() noexcept override { conv_.clear(); }
+};
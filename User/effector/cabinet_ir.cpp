@@ -0,0 +1,204 @@
+/// @file      effector/cabinet_ir.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#include "cabinet_ir.h"
+
+// サンプリング周波数 44433Hz
+// 各IRは周波数特性の最大値が 0dB になるよう正規化済み
+
+const float satoh::fx::cabinet::IR[IR_COUNT][IR_LENGTH] = {
+    // 1x12 open
+    {
+        5.47053888e-03f, 3.21409561e-02f, 8.43444112e-02f, 1.32270442e-01f, 1.39226807e-01f, 1.01251135e-01f, 4.36102003e-02f, -6.01101228e-03f,
+        -3.38363733e-02f, -4.07741392e-02f, -3.52654829e-02f, -2.60631496e-02f, -1.85050782e-02f, -1.41732360e-02f, -1.23001598e-02f, -1.13916524e-02f,
+        -1.02740213e-02f, -8.44770957e-03f, -5.97864280e-03f, -3.21882579e-03f, -5.56622654e-04f, 1.72341179e-03f, 3.47676326e-03f, 4.67317573e-03f,
+        5.35108828e-03f, 5.57863341e-03f, 5.43047081e-03f, 4.97862705e-03f, 4.29129529e-03f, 3.43401964e-03f, 2.47007914e-03f, 1.45921892e-03f,
+        4.55279559e-04f, -4.96295224e-04f, -1.36028635e-03f, -2.11249539e-03f, -2.73951538e-03f, -1.87006619e-03f, 4.42361099e-03f, 1.72137972e-02f,
+        2.90322780e-02f, 3.06875706e-02f, 2.11694425e-02f, 6.77512564e-03f, -5.59227307e-03f, -1.25046594e-02f, -1.42022322e-02f, -1.28052795e-02f,
+        -1.05087517e-02f, -8.65078717e-03f, -7.62771187e-03f, -7.24609060e-03f, -7.12889652e-03f, -6.97785238e-03f, -6.66236794e-03f, -6.19287296e-03f,
+        -5.65140454e-03f, -5.12954060e-03f, -4.69363643e-03f, -4.37595808e-03f, -4.18123388e-03f, -4.09807337e-03f, -4.10867879e-03f, -4.19454335e-03f,
+        -4.33860807e-03f, -4.52540269e-03f, -4.74057803e-03f, -4.97063809e-03f, -5.20309515e-03f, -5.42691807e-03f, -5.63303427e-03f, -5.81469236e-03f,
+        -5.96759465e-03f, -6.08980071e-03f, -6.18145599e-03f, -6.24441476e-03f, -6.28181897e-03f, -6.29767699e-03f, -6.29647061e-03f, -6.28280658e-03f,
+        -6.26112227e-03f, -6.23545098e-03f, -6.20924923e-03f, -7.00586673e-03f, -1.09867333e-02f, -1.88031123e-02f, -2.59840287e-02f, -2.70256258e-02f,
+        -2.13330151e-02f, -1.26952869e-02f, -5.26399133e-03f, -1.10419809e-03f, -7.82756637e-05f, -9.18705697e-04f, -2.31136049e-03f, -3.45451585e-03f,
+        -4.11006227e-03f, -4.39254104e-03f, -4.52574039e-03f, -4.68559604e-03f, -4.94712183e-03f, -5.30067505e-03f, -5.69382970e-03f, -6.06879543e-03f,
+        -6.38340468e-03f, -6.61651220e-03f, -6.76409702e-03f, -6.83240301e-03f, -6.83206981e-03f, -6.77464536e-03f, -6.67120540e-03f, -6.53217236e-03f,
+        -6.36749662e-03f, -6.18672130e-03f, -5.99880185e-03f, -5.81176197e-03f, -5.63233201e-03f, -5.46568692e-03f, -5.31533812e-03f, -5.18317784e-03f,
+        -5.06964187e-03f, -4.97394692e-03f, -4.89436330e-03f, -4.82849384e-03f, -4.77353959e-03f, -4.72654020e-03f, -4.68458104e-03f, -4.64496239e-03f,
+        -4.60532770e-03f, -4.56375042e-03f, -4.51878082e-03f, -4.46945629e-03f, -4.41528027e-03f, -4.35617612e-03f, -4.29242280e-03f, -4.22457930e-03f,
+        -4.15340415e-03f, -4.07977579e-03f, -4.00461844e-03f, -3.92883698e-03f, -3.85326341e-03f, -3.77861614e-03f, -3.70547249e-03f, -3.63425403e-03f,
+        -3.56522345e-03f, -3.49849144e-03f, -3.43403151e-03f, -3.37170062e-03f, -3.31126354e-03f, -3.25241884e-03f, -3.19482476e-03f, -3.13812346e-03f,
+        -3.08196253e-03f, -3.02601279e-03f, -2.96998218e-03f, -2.91362528e-03f, -2.85674881e-03f, -2.79921336e-03f, -2.74093183e-03f, -2.68186525e-03f,
+        -2.62201661e-03f, -2.56142342e-03f, -2.50014957e-03f, -2.43827715e-03f, -2.37589871e-03f, -2.31311021e-03f, -2.25000516e-03f, -2.18666993e-03f,
+        -2.12318033e-03f, -2.05959957e-03f, -1.99597728e-03f, -1.93234969e-03f, -1.86874055e-03f, -1.80516277e-03f, -1.74162049e-03f, -1.67811132e-03f,
+        -1.61462874e-03f, -1.55116426e-03f, -1.48770952e-03f, -1.42425793e-03f, -1.36080599e-03f, -1.29735427e-03f, -1.23390791e-03f, -1.17047680e-03f,
+        -1.10707544e-03f, -1.04372256e-03f, -9.80440434e-04f, -9.17254235e-04f, -8.54191152e-04f, -7.91279591e-04f, -7.28548377e-04f, -6.66026042e-04f,
+        -6.03740212e-04f, -5.41717122e-04f, -4.79981257e-04f, -4.18555131e-04f, -3.57459181e-04f, -2.96711777e-04f, -2.36329320e-04f, -1.76326411e-04f,
+        -1.16716073e-04f, -5.75099984e-05f, 1.28118819e-06f, 5.96476759e-05f, 1.17580231e-04f, 1.75069989e-04f, 2.32108284e-04f, 2.88686514e-04f,
+        3.44796048e-04f, 4.00428169e-04f, 4.55574054e-04f, 5.10224780e-04f, 5.64371354e-04f, 6.18004757e-04f, 6.71116004e-04f, 7.23696202e-04f,
+        7.75736613e-04f, 8.27228706e-04f, 8.78164210e-04f, 9.28535147e-04f, 9.78333859e-04f, 1.02755303e-03f, 1.07618567e-03f, 1.12422514e-03f,
+        1.17166512e-03f, 1.21849958e-03f, 1.26472278e-03f, 1.31032922e-03f, 1.35531362e-03f, 1.39967090e-03f, 1.44339614e-03f, 1.48648460e-03f,
+        1.52893163e-03f, 1.57073273e-03f, 1.61188349e-03f, 1.65237961e-03f, 1.69221690e-03f, 1.73139128e-03f, 1.76989876e-03f, 1.80773550e-03f,
+        1.84489775e-03f, 1.88138192e-03f, 1.91718457e-03f, 1.95230237e-03f, 1.98673221e-03f, 2.02047110e-03f, 2.05351623e-03f, 2.08586500e-03f,
+        2.11751493e-03f, 2.14846378e-03f, 2.17870946e-03f, 2.20825006e-03f, 2.23708387e-03f, 2.26520934e-03f, 2.29262511e-03f, 2.31933001e-03f,
+        2.34532301e-03f, 2.37060329e-03f, 2.39517017e-03f, 2.41902317e-03f, 2.44216196e-03f, 2.46458639e-03f, 2.48629647e-03f, 2.50729238e-03f,
+        2.52757448e-03f, 2.54714329e-03f, 2.56599948e-03f, 2.58414392e-03f, 2.60157762e-03f, 2.61830178e-03f, 2.63431773e-03f, 2.64962702e-03f,
+        2.66423130e-03f, 2.67813244e-03f, 2.69133244e-03f, 2.70383346e-03f, 2.71563784e-03f, 2.72674804e-03f, 2.73716671e-03f, 2.74689664e-03f,
+        2.75594077e-03f, 2.76430217e-03f, 2.77198409e-03f, 2.77898989e-03f, 2.78532310e-03f, 2.79098737e-03f, 2.79598648e-03f, 2.80032437e-03f,
+        2.80400510e-03f, 2.80703285e-03f, 2.80941194e-03f, 2.81114682e-03f, 2.81224204e-03f, 2.81270230e-03f, 2.81253240e-03f, 2.81173727e-03f,
+        2.81032194e-03f, 2.80829157e-03f, 2.80565142e-03f, 2.80240685e-03f, 2.79856335e-03f, 2.79412650e-03f, 2.78910197e-03f, 2.78349555e-03f,
+        2.77731311e-03f, 2.77056063e-03f, 2.76324418e-03f, 2.75536990e-03f, 2.74694405e-03f, 2.73797294e-03f, 2.72846300e-03f, 2.71842071e-03f,
+        2.70785265e-03f, 2.69676547e-03f, 2.68516588e-03f, 2.67306069e-03f, 2.66045675e-03f, 2.64736100e-03f, 2.63378044e-03f, 2.61972212e-03f,
+        2.60519317e-03f, 2.59020076e-03f, 2.57475213e-03f, 2.55885457e-03f, 2.54251543e-03f, 2.52574208e-03f, 2.50854198e-03f, 2.49092259e-03f,
+        2.47289146e-03f, 2.45445615e-03f, 2.43562425e-03f, 2.41640342e-03f, 2.39680133e-03f, 2.37682569e-03f, 2.35648423e-03f, 2.33578472e-03f,
+        2.31473495e-03f, 2.29334273e-03f, 2.27161590e-03f, 2.24956232e-03f, 2.22718985e-03f, 2.20450637e-03f, 2.18151980e-03f, 2.15823802e-03f,
+        2.13466897e-03f, 2.11082057e-03f, 2.08670074e-03f, 2.06231741e-03f, 2.03767852e-03f, 2.01279200e-03f, 1.98766576e-03f, 1.96230773e-03f,
+        1.93672582e-03f, 1.91092794e-03f, 1.88492197e-03f, 1.85871579e-03f, 1.83231728e-03f, 1.80573426e-03f, 1.77897457e-03f, 1.75204602e-03f,
+        1.72495638e-03f, 1.69771343e-03f, 1.67032488e-03f, 1.64279845e-03f, 1.61514182e-03f, 1.58736261e-03f, 1.55946846e-03f, 1.53146694e-03f,
+        1.50336557e-03f, 1.47517188e-03f, 1.44689332e-03f, 1.41853732e-03f, 1.39011124e-03f, 1.36162244e-03f, 1.33307820e-03f, 1.30448577e-03f,
+        1.27585233e-03f, 1.24718503e-03f, 1.21849098e-03f, 1.18977720e-03f, 1.16105068e-03f, 1.13231836e-03f, 1.10358711e-03f, 1.07486374e-03f,
+        1.04587496e-03f, 1.01637841e-03f, 9.86427551e-04f, 9.56076138e-04f, 9.25378062e-04f, 8.94387248e-04f, 8.63157542e-04f, 8.31742587e-04f,
+        8.00195716e-04f, 7.68569833e-04f, 7.36917310e-04f, 7.05289873e-04f, 6.73738500e-04f, 6.42313315e-04f, 6.11063494e-04f, 5.80037159e-04f,
+        5.49281295e-04f, 5.18841651e-04f, 4.88762659e-04f, 4.59087350e-04f, 4.29857274e-04f, 4.01112429e-04f, 3.72891186e-04f, 3.45230228e-04f,
+        3.18164485e-04f, 2.91727078e-04f, 2.65949269e-04f, 2.40860410e-04f, 2.16487904e-04f, 1.92857162e-04f, 1.69991578e-04f, 1.47912493e-04f,
+        1.26639176e-04f, 1.06188806e-04f, 8.65764563e-05f, 6.78150888e-05f, 4.99155493e-05f, 3.28865690e-05f, 1.67347709e-05f, 1.46468046e-06f,
+        -1.29212585e-05f, -2.64226638e-05f, -3.90411900e-05f, -5.07804996e-05f, -6.16462295e-05f, -7.16459535e-05f, -8.07891406e-05f, -8.90871098e-05f,
+        -9.65529806e-05f, -1.03201620e-04f, -1.09049587e-04f, -1.14115072e-04f, -1.18417833e-04f, -1.21979135e-04f, -1.24821673e-04f, -1.26969510e-04f,
+        -1.28447996e-04f, -1.29283697e-04f, -1.29504317e-04f, -1.29138615e-04f, -1.28216328e-04f, -1.26768086e-04f, -1.24825328e-04f, -1.22420220e-04f,
+        -1.19585566e-04f, -1.16354724e-04f, -1.12761520e-04f, -1.08840157e-04f, -1.04625135e-04f, -1.00151159e-04f, -9.54530554e-05f, -9.05656856e-05f,
+        -8.55238620e-05f, -8.03622639e-05f, -7.51153550e-05f, -6.98173023e-05f, -6.45018964e-05f, -5.92024737e-05f, -5.39518399e-05f, -4.87821965e-05f,
+        -4.37250682e-05f, -3.88112338e-05f, -3.40706589e-05f, -2.95324312e-05f, -2.52246989e-05f, -2.11746111e-05f, -1.74082624e-05f, -1.39506394e-05f,
+        -1.08255705e-05f, -8.05567993e-06f, -5.66234346e-06f, -3.66564882e-06f, -2.08435888e-06f, -9.35878396e-07f, -2.36224398e-07f, -0.00000000e+00f,
+    },
+    // 2x12
+    {
+        3.24487594e-03f, 1.98012090e-02f, 5.48273211e-02f, 9.27602138e-02f, 1.08700176e-01f, 9.27391864e-02f, 5.46048721e-02f, 1.19423771e-02f,
+        -2.10909097e-02f, -3.86265628e-02f, -4.20638064e-02f, -3.64793897e-02f, -2.72352166e-02f, -1.80674610e-02f, -1.06862373e-02f, -5.29939803e-03f,
+        -1.40801202e-03f, 1.55831540e-03f, 3.92447933e-03f, 5.73299456e-03f, 6.86332324e-03f, 7.18473904e-03f, 6.66495074e-03f, 5.40818721e-03f,
+        3.63335513e-03f, 1.61939326e-03f, -3.54992031e-04f, -2.05880979e-03f, -3.33578023e-03f, -3.13801063e-03f, 1.55464035e-03f, 1.22316291e-02f,
+        2.41270271e-02f, 2.96536957e-02f, 2.57181910e-02f, 1.51270532e-02f, 3.08093209e-03f, -6.24094824e-03f, -1.11184531e-02f, -1.19844956e-02f,
+        -1.03509471e-02f, -7.79584904e-03f, -5.39629947e-03f, -3.61494204e-03f, -2.46337777e-03f, -1.74614845e-03f, -1.25531029e-03f, -8.67923836e-04f,
+        -5.57935781e-04f, -3.59782326e-04f, -3.20809405e-04f, -4.66208721e-04f, -7.84744585e-04f, -1.23244888e-03f, -1.74644884e-03f, -2.26099369e-03f,
+        -2.72029124e-03f, -3.08588528e-03f, -3.33872646e-03f, -3.47737792e-03f, -3.51409250e-03f, -3.47019304e-03f, -3.37167131e-03f, -3.24545617e-03f,
+        -3.11649702e-03f, -3.00566113e-03f, -2.92839759e-03f, -2.89411418e-03f, -2.90620530e-03f, -2.96264528e-03f, -3.05702589e-03f, -2.59580679e-03f,
+        2.44066555e-04f, 6.40237045e-03f, 1.30880442e-02f, 1.58275042e-02f, 1.28431885e-02f, 5.88925397e-03f, -1.85758256e-03f, -7.85063173e-03f,
+        -1.10369123e-02f, -1.16726869e-02f, -1.06766036e-02f, -9.01849114e-03f, -7.37493290e-03f, -6.05688089e-03f, -5.10376495e-03f, -4.42665004e-03f,
+        -3.92268985e-03f, -3.53237072e-03f, -3.24639992e-03f, -3.08449994e-03f, -3.06815716e-03f, -3.20129856e-03f, -3.46361183e-03f, -3.81458902e-03f,
+        -4.20340995e-03f, -4.57977775e-03f, -4.90240515e-03f, -5.14377889e-03f, -5.29133098e-03f, -5.34595555e-03f, -5.31901032e-03f, -5.22876787e-03f,
+        -5.09696869e-03f, -4.94583581e-03f, -4.79570713e-03f, -4.66332849e-03f, -4.56079811e-03f, -4.49512569e-03f, -4.46834595e-03f, -4.47809852e-03f,
+        -4.51855744e-03f, -4.58157259e-03f, -4.65787779e-03f, -4.73823043e-03f, -4.81437194e-03f, -4.87973384e-03f, -4.92985324e-03f, -4.96249950e-03f,
+        -4.97754483e-03f, -4.97663435e-03f, -4.96272322e-03f, -4.93955151e-03f, -4.91112245e-03f, -4.88123818e-03f, -4.85313242e-03f, -4.82922265e-03f,
+        -4.81098832e-03f, -4.79896731e-03f, -4.79285185e-03f, -5.11614528e-03f, -6.77405781e-03f, -1.02807371e-02f, -1.40781776e-02f, -1.56748639e-02f,
+        -1.40787475e-02f, -1.02617258e-02f, -5.98785863e-03f, -2.67282355e-03f, -9.03738466e-04f, -5.41210832e-04f, -1.07825454e-03f, -1.97943026e-03f,
+        -2.87184643e-03f, -3.58512147e-03f, -4.09895507e-03f, -4.46355434e-03f, -4.73609809e-03f, -4.94905569e-03f, -5.10652841e-03f, -5.19622057e-03f,
+        -5.20476768e-03f, -5.12863900e-03f, -4.97798078e-03f, -4.77445854e-03f, -4.54580926e-03f, -4.31982185e-03f, -4.11958674e-03f, -3.96078691e-03f,
+        -3.85096940e-03f, -3.79028664e-03f, -3.77308412e-03f, -3.78980579e-03f, -3.82885976e-03f, -3.87824704e-03f, -3.92686641e-03f, -3.96546954e-03f,
+        -3.98726804e-03f, -3.98820839e-03f, -3.96694362e-03f, -3.92454613e-03f, -3.86402298e-03f, -3.78970721e-03f, -3.70660424e-03f, -3.61976800e-03f,
+        -3.53376842e-03f, -3.45229360e-03f, -3.37790811e-03f, -3.31196867e-03f, -3.25468088e-03f, -3.20526792e-03f, -3.16221521e-03f, -3.12355257e-03f,
+        -3.08713809e-03f, -3.05091368e-03f, -3.01310996e-03f, -2.97238743e-03f, -2.92790954e-03f, -2.87935091e-03f, -2.82685067e-03f, -2.77092438e-03f,
+        -2.71235074e-03f, -2.65204890e-03f, -2.59096083e-03f, -2.52995020e-03f, -2.46972577e-03f, -2.41079331e-03f, -2.35343656e-03f, -2.29772439e-03f,
+        -2.24353934e-03f, -2.19062094e-03f, -2.13861701e-03f, -2.08713619e-03f, -2.03579600e-03f, -1.98426220e-03f, -1.93227661e-03f, -1.87967252e-03f,
+        -1.82637788e-03f, -1.77240815e-03f, -1.71785099e-03f, -1.66284597e-03f, -1.60756202e-03f, -1.55217554e-03f, -1.49685120e-03f, -1.44172710e-03f,
+        -1.38690513e-03f, -1.33244671e-03f, -1.27837342e-03f, -1.22467175e-03f, -1.17130075e-03f, -1.11820135e-03f, -1.06530604e-03f, -1.01254790e-03f,
+        -9.59868128e-04f, -9.07221490e-04f, -8.54579474e-04f, -8.01931207e-04f, -7.49282375e-04f, -6.96652597e-04f, -6.44071775e-04f, -5.91575966e-04f,
+        -5.39203295e-04f, -4.86990313e-04f, -4.34969130e-04f, -3.83165483e-04f, -3.31597791e-04f, -2.80277146e-04f, -2.29208073e-04f, -1.78389867e-04f,
+        -1.27818269e-04f, -7.74872428e-05f, -2.73906606e-05f, 2.24762738e-05f, 7.21159676e-05f, 1.21527801e-04f, 1.70707910e-04f, 2.19649337e-04f,
+        2.68342492e-04f, 3.16775804e-04f, 3.64936481e-04f, 4.12811279e-04f, 4.60387191e-04f, 5.07652005e-04f, 5.54594692e-04f, 6.01205612e-04f,
+        6.47476542e-04f, 6.93400564e-04f, 7.38971833e-04f, 7.84185277e-04f, 8.29036278e-04f, 8.73520360e-04f, 9.17632918e-04f, 9.61369019e-04f,
+        1.00472327e-03f, 1.04768979e-03f, 1.09026219e-03f, 1.13243369e-03f, 1.17419723e-03f, 1.21554560e-03f, 1.25647158e-03f, 1.29696809e-03f,
+        1.33702828e-03f, 1.37664563e-03f, 1.41581396e-03f, 1.45452747e-03f, 1.49278071e-03f, 1.53056856e-03f, 1.56788614e-03f, 1.60472878e-03f,
+        1.64109197e-03f, 1.67697127e-03f, 1.71236230e-03f, 1.74726074e-03f, 1.78166226e-03f, 1.81556256e-03f, 1.84895737e-03f, 1.88184249e-03f,
+        1.91421378e-03f, 1.94606724e-03f, 1.97739897e-03f, 2.00820524e-03f, 2.03848247e-03f, 2.06822728e-03f, 2.09743646e-03f, 2.12610696e-03f,
+        2.15423592e-03f, 2.18182062e-03f, 2.20885851e-03f, 2.23534715e-03f, 2.26128424e-03f, 2.28666761e-03f, 2.31149518e-03f, 2.33576499e-03f,
+        2.35947518e-03f, 2.38262403e-03f, 2.40520989e-03f, 2.42723127e-03f, 2.44868676e-03f, 2.46957512e-03f, 2.48989520e-03f, 2.50964600e-03f,
+        2.52882666e-03f, 2.54743643e-03f, 2.56547471e-03f, 2.58294102e-03f, 2.59983502e-03f, 2.61615646e-03f, 2.63190526e-03f, 2.64708142e-03f,
+        2.66168507e-03f, 2.67571646e-03f, 2.68917594e-03f, 2.70206399e-03f, 2.71438118e-03f, 2.72612821e-03f, 2.73730589e-03f, 2.74791513e-03f,
+        2.75795696e-03f, 2.76743251e-03f, 2.77634304e-03f, 2.78468990e-03f, 2.79247457e-03f, 2.79969862e-03f, 2.80636374e-03f, 2.81247172e-03f,
+        2.81802445e-03f, 2.82302394e-03f, 2.82747228e-03f, 2.83137168e-03f, 2.83472444e-03f, 2.83753295e-03f, 2.83979971e-03f, 2.84152732e-03f,
+        2.84271846e-03f, 2.84337591e-03f, 2.84350255e-03f, 2.84310134e-03f, 2.84217534e-03f, 2.84072770e-03f, 2.83876166e-03f, 2.83628054e-03f,
+        2.83328775e-03f, 2.82978679e-03f, 2.82578125e-03f, 2.82127478e-03f, 2.81627113e-03f, 2.81077413e-03f, 2.80478769e-03f, 2.79831578e-03f,
+        2.79136248e-03f, 2.78393191e-03f, 2.77602828e-03f, 2.76765588e-03f, 2.75881905e-03f, 2.74952223e-03f, 2.73976991e-03f, 2.72956664e-03f,
+        2.71891705e-03f, 2.70782584e-03f, 2.69629776e-03f, 2.68433763e-03f, 2.67195032e-03f, 2.65914077e-03f, 2.64591398e-03f, 2.63227501e-03f,
+        2.61822896e-03f, 2.60378099e-03f, 2.58893632e-03f, 2.57370022e-03f, 2.55807800e-03f, 2.54207502e-03f, 2.52569670e-03f, 2.50894850e-03f,
+        2.49116883e-03f, 2.47171558e-03f, 2.45062535e-03f, 2.42793721e-03f, 2.40369263e-03f, 2.37793539e-03f, 2.35071145e-03f, 2.32206885e-03f,
+        2.29205763e-03f, 2.26072971e-03f, 2.22813876e-03f, 2.19434008e-03f, 2.15939052e-03f, 2.12334832e-03f, 2.08627297e-03f, 2.04822516e-03f,
+        2.00926656e-03f, 1.96945976e-03f, 1.92886810e-03f, 1.88755558e-03f, 1.84558668e-03f, 1.80302625e-03f, 1.75993941e-03f, 1.71639138e-03f,
+        1.67244735e-03f, 1.62817239e-03f, 1.58363127e-03f, 1.53888839e-03f, 1.49400761e-03f, 1.44905215e-03f, 1.40408448e-03f, 1.35916617e-03f,
+        1.31435780e-03f, 1.26971886e-03f, 1.22530761e-03f, 1.18118100e-03f, 1.13739454e-03f, 1.09400226e-03f, 1.05105654e-03f, 1.00860808e-03f,
+        9.66705793e-04f, 9.25396727e-04f, 8.84725983e-04f, 8.44736653e-04f, 8.05469748e-04f, 7.66964139e-04f, 7.29256502e-04f, 6.92381260e-04f,
+        6.56370547e-04f, 6.21254159e-04f, 5.87059522e-04f, 5.53811663e-04f, 5.21533183e-04f, 4.90244238e-04f, 4.59962528e-04f, 4.30703285e-04f,
+        4.02479270e-04f, 3.75300780e-04f, 3.49175648e-04f, 3.24109263e-04f, 3.00104584e-04f, 2.77162161e-04f, 2.55280169e-04f, 2.34454436e-04f,
+        2.14678484e-04f, 1.95943567e-04f, 1.78238723e-04f, 1.61550821e-04f, 1.45864622e-04f, 1.31162831e-04f, 1.17426168e-04f, 1.04633433e-04f,
+        9.27615735e-05f, 8.17857654e-05f, 7.16794860e-05f, 6.24145965e-05f, 5.39614259e-05f, 4.62888564e-05f, 3.93644129e-05f, 3.31543536e-05f,
+        2.76237632e-05f, 2.27366472e-05f, 1.84560285e-05f, 1.47440452e-05f, 1.15620491e-05f, 8.87070526e-06f, 6.63009277e-06f, 4.79980508e-06f,
+        3.33905116e-06f, 2.20675646e-06f, 1.36166365e-06f, 7.62432905e-07f, 3.67741551e-07f, 1.36382796e-07f, 2.73633930e-08f, 0.00000000e+00f,
+    },
+    // 4x12 closed
+    {
+        1.98898304e-03f, 1.25715190e-02f, 3.65766297e-02f, 6.63051032e-02f, 8.54143757e-02f, 8.31418990e-02f, 6.04940253e-02f, 2.66381855e-02f,
+        -7.29298541e-03f, -3.28519822e-02f, -4.61612630e-02f, -4.75443175e-02f, -4.00045564e-02f, -2.75323444e-02f, -1.38205323e-02f, -1.57445410e-03f,
+        7.65971067e-03f, 1.33373399e-02f, 1.56202635e-02f, 1.50809241e-02f, 1.24742522e-02f, 8.59086863e-03f, 4.17406303e-03f, 5.70012349e-04f,
+        6.16917159e-04f, 6.38346780e-03f, 1.53862819e-02f, 2.19416199e-02f, 2.21527541e-02f, 1.61051112e-02f, 6.65006338e-03f, -2.70644838e-03f,
+        -9.37313091e-03f, -1.22829772e-02f, -1.17299775e-02f, -8.82257242e-03f, -4.89720224e-03f, -1.09186263e-03f, 1.86089043e-03f, 3.65488476e-03f,
+        4.31801434e-03f, 4.07913829e-03f, 3.24555592e-03f, 2.11635963e-03f, 9.35754323e-04f, -1.22089555e-04f, -9.49307841e-04f, -1.49291948e-03f,
+        -1.74278303e-03f, -1.72175588e-03f, -1.47791326e-03f, -1.07741653e-03f, -5.96750908e-04f, -1.13944024e-04f, 3.00616009e-04f, 5.92476670e-04f,
+        7.29109560e-04f, 7.02529352e-04f, 5.28151638e-04f, 7.37491703e-04f, 3.02783990e-03f, 8.65641189e-03f, 1.57444195e-02f, 2.02420337e-02f,
+        1.94802683e-02f, 1.37168651e-02f, 5.23548776e-03f, -3.20011785e-03f, -9.50433971e-03f, -1.27361229e-02f, -1.30023017e-02f, -1.10738410e-02f,
+        -7.96044573e-03f, -4.58875436e-03f, -1.63050610e-03f, 5.38628318e-04f, 1.79723512e-03f, 2.20173757e-03f, 1.90997485e-03f, 1.12222161e-03f,
+        4.32626034e-05f, -1.13878698e-03f, -2.26363340e-03f, -3.20541421e-03f, -3.87753541e-03f, -4.23598474e-03f, -4.27994849e-03f, -4.04840555e-03f,
+        -3.61215701e-03f, -3.06192696e-03f, -2.49422463e-03f, -1.99724497e-03f, -1.63908155e-03f, -1.46000202e-03f, -1.46968521e-03f, -1.64937308e-03f,
+        -1.95806289e-03f, -2.04295082e-03f, -8.55149899e-04f, 2.38261931e-03f, 6.55607178e-03f, 9.23779965e-03f, 8.81951321e-03f, 5.44190649e-03f,
+        4.57200232e-04f, -4.49518802e-03f, -8.18073091e-03f, -1.00474938e-02f, -1.01668809e-02f, -9.00307667e-03f, -7.15836717e-03f, -5.18127290e-03f,
+        -3.46506186e-03f, -2.22477265e-03f, -1.52387591e-03f, -1.32134569e-03f, -1.51824941e-03f, -1.99335054e-03f, -2.62559466e-03f, -3.30616825e-03f,
+        -3.94430547e-03f, -4.47029322e-03f, -4.83748493e-03f, -5.02359078e-03f, -5.03061574e-03f, -4.88267636e-03f, -4.62135204e-03f, -4.29889619e-03f,
+        -3.97024157e-03f, -3.68507707e-03f, -3.48127634e-03f, -3.38066094e-03f, -3.38759386e-03f, -3.49035898e-03f, -3.66481074e-03f, -3.87945959e-03f,
+        -4.10102827e-03f, -4.29956524e-03f, -4.45239527e-03f, -4.54646753e-03f, -4.57896846e-03f, -4.55634713e-03f, -4.49211718e-03f, -4.40392784e-03f,
+        -4.31043411e-03f, -4.22844968e-03f, -4.17075692e-03f, -4.14480041e-03f, -4.15233110e-03f, -4.18992195e-03f, -4.25016130e-03f, -4.32325940e-03f,
+        -4.39878030e-03f, -4.46723250e-03f, -4.52130844e-03f, -4.55664173e-03f, -4.57203826e-03f, -4.56921895e-03f, -4.55217710e-03f, -4.52629497e-03f,
+        -4.49737944e-03f, -4.47076661e-03f, -4.45061526e-03f, -4.43946550e-03f, -4.43809068e-03f, -4.44562422e-03f, -4.45990608e-03f, -4.67686757e-03f,
+        -5.75372920e-03f, -8.17039118e-03f, -1.11545670e-02f, -1.30705280e-02f, -1.28415329e-02f, -1.05686543e-02f, -7.16981026e-03f, -3.75990815e-03f,
+        -1.18551240e-03f, 1.63922672e-04f, 3.19388530e-04f, -4.19640125e-04f, -1.65444446e-03f, -3.01553761e-03f, -4.23176543e-03f, -5.14761750e-03f,
+        -5.70763414e-03f, -5.92705520e-03f, -5.86236619e-03f, -5.58857168e-03f, -5.18455086e-03f, -4.72474189e-03f, -4.27449545e-03f, -3.88697629e-03f,
+        -3.60060683e-03f, -3.43706539e-03f, -3.40041300e-03f, -3.47796283e-03f, -3.64316192e-03f, -3.86025008e-03f, -4.09000650e-03f, -4.29563430e-03f,
+        -4.44781736e-03f, -4.52818689e-03f, -4.53077917e-03f, -4.46145535e-03f, -4.33560251e-03f, -4.17468071e-03f, -4.00229468e-03f, -3.84045362e-03f,
+        -3.70656110e-03f, -3.61148881e-03f, -3.55887239e-03f, -3.54556487e-03f, -3.56301985e-03f, -3.59927261e-03f, -3.64114663e-03f, -3.67633366e-03f,
+        -3.69506291e-03f, -3.69117477e-03f, -3.66252577e-03f, -3.61075814e-03f, -3.54055409e-03f, -3.45855260e-03f, -3.37213066e-03f, -3.28824300e-03f,
+        -3.21247939e-03f, -3.14844612e-03f, -3.09751667e-03f, -3.05893796e-03f, -3.03022862e-03f, -3.00777269e-03f, -2.98749674e-03f, -2.96552147e-03f,
+        -2.93869739e-03f, -2.90496284e-03f, -2.86349670e-03f, -2.81467142e-03f, -2.75984012e-03f, -2.70101075e-03f, -2.64046963e-03f, -2.58041554e-03f,
+        -2.52265567e-03f, -2.46839903e-03f, -2.41816397e-03f, -2.37179780e-03f, -2.32859051e-03f, -2.28745361e-03f, -2.24712931e-03f, -2.20639604e-03f,
+        -2.16424083e-03f, -2.11997846e-03f, -2.07330713e-03f, -2.02430131e-03f, -1.97335121e-03f, -1.92106486e-03f, -1.86815194e-03f, -1.81530860e-03f,
+        -1.76311972e-03f, -1.71199043e-03f, -1.66211280e-03f, -1.61346773e-03f, -1.56585705e-03f, -1.51895717e-03f, -1.47238352e-03f, -1.42575516e-03f,
+        -1.37875010e-03f, -1.33114468e-03f, -1.28283345e-03f, -1.23382928e-03f, -1.18424642e-03f, -1.13427118e-03f, -1.08412619e-03f, -1.03403424e-03f,
+        -9.84186929e-04f, -9.34722135e-04f, -8.85712172e-04f, -8.37163074e-04f, -7.89023520e-04f, -7.41200830e-04f, -6.93580775e-04f, -6.46047833e-04f,
+        -5.98502885e-04f, -5.50876177e-04f, -5.03134281e-04f, -4.55280886e-04f, -4.07352123e-04f, -3.59407838e-04f, -3.11520624e-04f, -2.63764487e-04f,
+        -2.16204840e-04f, -1.68891082e-04f, -1.21852495e-04f, -7.50975857e-05f, -2.86165206e-05f, 1.76141267e-05f, 6.36253075e-05f, 1.09449165e-04f,
+        1.55113385e-04f, 2.00636957e-04f, 2.46027762e-04f, 2.91282091e-04f, 3.36385909e-04f, 3.81317441e-04f, 4.26050522e-04f, 4.70558148e-04f,
+        5.14815661e-04f, 5.58803175e-04f, 6.02506994e-04f, 6.45919947e-04f, 6.89040745e-04f, 7.31872577e-04f, 7.74421262e-04f, 8.16693270e-04f,
+        8.58693928e-04f, 9.00426038e-04f, 9.41889048e-04f, 9.83078834e-04f, 1.02398803e-03f, 1.06460678e-03f, 1.10492379e-03f, 1.14492739e-03f,
+        1.18460659e-03f, 1.22395184e-03f, 1.26295554e-03f, 1.30161215e-03f, 1.33991808e-03f, 1.37787122e-03f, 1.41547043e-03f, 1.45271487e-03f,
+        1.48960349e-03f, 1.52613455e-03f, 1.56230532e-03f, 1.59811202e-03f, 1.63354992e-03f, 1.66861351e-03f, 1.70329684e-03f, 1.73759387e-03f,
+        1.77149878e-03f, 1.80500624e-03f, 1.83811156e-03f, 1.87081075e-03f, 1.90310048e-03f, 1.93497799e-03f, 1.96644086e-03f, 1.99748689e-03f,
+        2.02811387e-03f, 2.05831942e-03f, 2.08810098e-03f, 2.11745568e-03f, 2.14638041e-03f, 2.17487188e-03f, 2.20292669e-03f, 2.23054148e-03f,
+        2.25771299e-03f, 2.28443817e-03f, 2.31071422e-03f, 2.33653860e-03f, 2.36190908e-03f, 2.38682363e-03f, 2.41128041e-03f, 2.43527772e-03f,
+        2.45881391e-03f, 2.48188735e-03f, 2.50449641e-03f, 2.52663943e-03f, 2.54831473e-03f, 2.56952062e-03f, 2.59025545e-03f, 2.61051762e-03f,
+        2.63030562e-03f, 2.64961807e-03f, 2.66845371e-03f, 2.68681143e-03f, 2.70469027e-03f, 2.72208939e-03f, 2.73900808e-03f, 2.75544571e-03f,
+        2.77140175e-03f, 2.78687573e-03f, 2.80186722e-03f, 2.81637585e-03f, 2.83040131e-03f, 2.84394332e-03f, 2.85700168e-03f, 2.86957626e-03f,
+        2.88089558e-03f, 2.89017662e-03f, 2.89740456e-03f, 2.90256792e-03f, 2.90565858e-03f, 2.90667184e-03f, 2.90560634e-03f, 2.90246411e-03f,
+        2.89725055e-03f, 2.88997438e-03f, 2.88064765e-03f, 2.86928570e-03f, 2.85590710e-03f, 2.84053364e-03f, 2.82319029e-03f, 2.80390513e-03f,
+        2.78270929e-03f, 2.75963693e-03f, 2.73472511e-03f, 2.70801376e-03f, 2.67954558e-03f, 2.64936597e-03f, 2.61752292e-03f, 2.58406691e-03f,
+        2.54905082e-03f, 2.51252981e-03f, 2.47456124e-03f, 2.43520451e-03f, 2.39452099e-03f, 2.35257387e-03f, 2.30942805e-03f, 2.26515003e-03f,
+        2.21980772e-03f, 2.17347042e-03f, 2.12620856e-03f, 2.07809368e-03f, 2.02919822e-03f, 1.97959541e-03f, 1.92935912e-03f, 1.87856374e-03f,
+        1.82728403e-03f, 1.77559498e-03f, 1.72357164e-03f, 1.67128907e-03f, 1.61882209e-03f, 1.56624522e-03f, 1.51363253e-03f, 1.46105749e-03f,
+        1.40859283e-03f, 1.35631046e-03f, 1.30428129e-03f, 1.25257511e-03f, 1.20126050e-03f, 1.15040470e-03f, 1.10007345e-03f, 1.05033096e-03f,
+        1.00123971e-03f, 9.52860404e-04f, 9.05251864e-04f, 8.58470909e-04f, 8.12572280e-04f, 7.67608546e-04f, 7.23630025e-04f, 6.80684702e-04f,
+        6.38818157e-04f, 5.98073500e-04f, 5.58491302e-04f, 5.20109543e-04f, 4.82963558e-04f, 4.47085989e-04f, 4.12506747e-04f, 3.79252973e-04f,
+        3.47349012e-04f, 3.16816385e-04f, 2.87673774e-04f, 2.59937009e-04f, 2.33619059e-04f, 2.08730033e-04f, 1.85277183e-04f, 1.63264914e-04f,
+        1.42694803e-04f, 1.23565613e-04f, 1.05873329e-04f, 8.96111829e-05f, 7.47696920e-05f, 6.13367037e-05f, 4.92974410e-05f, 3.86345555e-05f,
+        2.93281841e-05f, 2.13560111e-05f, 1.46933345e-05f, 9.31313610e-06f, 5.18615662e-06f, 2.28097427e-06f, 5.64087288e-07f, 0.00000000e+00f,
+    },
+};
+
+const char *const satoh::fx::cabinet::IR_NAME[IR_COUNT] = {"1x12", "2x12", "4x12"};
@@ -0,0 +1,25 @@
+/// @file      effector/cabinet_ir.h
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include <cstdint>
+
+namespace satoh
+{
+namespace fx
+{
+namespace cabinet
+{
+constexpr uint32_t IR_COUNT = 3;    ///< 内蔵IR数
+constexpr uint32_t IR_LENGTH = 480; ///< IR長（サンプル数 約10.8ms）
+/// @brief 内蔵キャビネットIR（フラッシュに配置）
+extern const float IR[IR_COUNT][IR_LENGTH];
+/// @brief 内蔵キャビネットIRの表示名
+extern const char *const IR_NAME[IR_COUNT];
+} // namespace cabinet
+} // namespace fx
+} // namespace satoh
@@ -10,7 +10,7 @@
 #include "lib/lib_calc.hpp"
 #include "lib/lib_delay.hpp"
 #include "lib/lib_filter.hpp"
-#include "lib/lib_osc.hpp"
+#include "lib/lib_lfo.hpp"
 #include <cstdio> // sprintf
 
 namespace satoh
@@ -37,7 +37,7 @@ class satoh::fx::Chorus : public satoh::fx::EffectorBase
 
   EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
   mutable char valueTxt_[8];   ///< パラメータ文字列格納バッファ
-  SinWave sin1;
+  LfoPool::Handle lfoHandle_;  ///< LFO 購読情報
   delayBuf<float> del1_;
   hpf hpf1;
   lpf2nd lpf2nd1;
@@ -46,6 +46,7 @@ class satoh::fx::Chorus : public satoh::fx::EffectorBase
   float mix_;
   float fback_;
   float depth_;
+  float freq_; ///< LFO 周波数
 
   /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
   /// @param [in] n 変換対象のパラメータ番号
@@ -65,7 +66,7 @@ class satoh::fx::Chorus : public satoh::fx::EffectorBase
     case RATE:
     {
       float rate = 0.02f * (105.0f - ui_[RATE].getValue()); // RATE 周期 2.1～0.1 秒;
-      sin1.set(1.0f / rate);
+      freq_ = 1.0f / rate;
       break;
     }
     case DEPTH:
@@ -112,11 +113,13 @@ public:
             EffectParameterF(1, 100, 1, "DEPTH"), //
             EffectParameterF(1, 100, 1, "TONE"),  //
         },                                        //
-        del1_(16),                                //
+        lfoHandle_{},                             //
+        del1_(16, MemTag::DTCM),                  //
         level_(0),                                //
         mix_(0),                                  //
         fback_(0),                                //
-        depth_(0)                                 //
+        depth_(0),                                //
+        freq_(1)                                  //
   {
     hpf1.set(100.0f); // ディレイ音のローカット設定
     init(ui_, COUNT);
@@ -131,11 +134,12 @@ public:
   /// @param[inout] left L音声データ
   /// @param[inout] right R音声データ
   /// @param [in] size 音声データ数
-  void effect(float *left, float *right, uint32_t size) noexcept override
+  ITCM_CODE void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    float const *lfo = LfoPool::get(lfo_, lfoHandle_, LfoPool::SIN, freq_, TempoClock::OFF, 0.0f); // LFO -1～1 正弦波
     for (uint32_t i = 0; i < size; ++i)
     {
-      float dtime = 5.0f + depth_ * (1.0f + sin1.output());
+      float dtime = 5.0f + depth_ * (1.0f + lfo[i]);
       del1_.setInterval(dtime);
       float fx = del1_.readLerp(); // ディレイ音読込(線形補間)
       fx = lpf2nd1.process(fx);    // ディレイ音のTONE(ハイカット)
@@ -8,7 +8,7 @@
 
 #include "effector_base.h"
 #include "lib/lib_calc.hpp"
-#include "lib/lib_filter.hpp"
+#include "lib/lib_env.hpp"
 #include <cstdio> // sprintf
 
 namespace satoh
@@ -35,14 +35,12 @@ class satoh::fx::Compressor : public satoh::fx::EffectorBase
 
   EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
   mutable char valueTxt_[8];   ///< パラメータ文字列格納バッファ
-  lpf lpfEnv;                  ///< エンベロープ用ローパスフィルタ
-  lpf lpfAtkRel;               ///< アタック・リリース用ローパスフィルタ
+  EnvelopeFollower env_;       ///< エンベロープ検出（ATTACK 4～100ms、RELEASE 5～400ms）
   float level_;                ///< LEVEL 0～+30dB
   float threshold_;            ///< THRESHOLD -90～0dB
   float ratio_;                ///< RATIO 1:Infinity, 1:2～1:10
-  float attack_;               ///< ATTACK 4～100ms(LPF周波数1～25Hz)
-  float release_;              ///< RELEASE 5～400ms(LPF周波数1～80Hz)
   float knee_;                 ///< KNEE 0～20dB
+  float work_[BLOCK_SIZE];     ///< エンベロープ・音量圧縮幅の作業領域
 
   /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
   /// @param [in] n 変換対象のパラメータ番号
@@ -64,16 +62,10 @@ class satoh::fx::Compressor : public satoh::fx::EffectorBase
       }
       break;
     case ATTACK:
-      if (v != 0)
-      {
-        attack_ = 100.0f / v;
-      }
+      env_.setAttack(v);
       break;
     case RELEASE:
-      if (v != 0)
-      {
-        release_ = 400.0f / v;
-      }
+      env_.setRelease(v);
       break;
     case KNEE:
       knee_ = v;
@@ -119,8 +111,6 @@ public:
             EffectParameterF(0, 20, 1, "KNEE"),   //
         }                                         //
   {
-    lpfEnv.set(500.0f); // エンベロープ用ローパスフィルタ設定
-    lpfAtkRel.set(100.0f);
     init(ui_, COUNT);
   }
   /// @brief デストラクタ
@@ -128,36 +118,40 @@ public:
   /// @brief エフェクト処理実行
   /// @param[inout] left L音声データ
   /// @param[inout] right R音声データ
-  /// @param [in] size 音声データ数
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
   void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    float *work = work_;
+    env_.processDb(right, work, size); // アタック・リリースを反映したエンベロープ dB
+    const float lo = threshold_ - knee_;
+    const float hi = threshold_ + knee_;
     for (uint32_t i = 0; i < size; ++i)
     {
-      float fx = right[i];
-      float th = threshold_;     // スレッショルド 一時変数
-      float dbGain = 0.0f;       // コンプレッション(音量圧縮)幅 dB
-      float env = abs(fx);       // エンベロープ
-      env = lpfEnv.process(env); // 絶対値とLPFでエンベロープ取得
-      env = gainToDb(env);       // dB換算
-      if (env < th - knee_)
+      float env = work[i];   // エンベロープ dB
+      float th = threshold_; // スレッショルド 一時変数
+      float dbGain = 0.0f;   // コンプレッション(音量圧縮)幅 dB
+      if (lo <= env)
       {
-        dbGain = 0.0f;
-        lpfAtkRel.set(release_);            // リリース用LPF周波数を設定
-        dbGain = lpfAtkRel.process(dbGain); // リリース用LPFで音量変化を遅らせる
-      }
-      else
-      {
-        if (env < th + knee_) // THRESHOLD ± KNEE の範囲では2次関数の曲線を使用
+        if (env < hi) // THRESHOLD ± KNEE の範囲では2次関数の曲線を使用
         {
-          th = -0.25f / knee_ * (env - th - knee_) * (env - th - knee_) + th;
+          th = -0.25f / knee_ * (env - hi) * (env - hi) + th;
         }
         dbGain = (env - th) * ratio_ + th - env; // 音量圧縮幅計算
-        lpfAtkRel.set(attack_);                  // アタック用LPF周波数を設定
-        dbGain = lpfAtkRel.process(dbGain);      // アタック用LPFで音量変化を遅らせる
       }
-      fx = dbToGain(dbGain) * fx; // コンプレッション実行
-      fx = level_ * fx;           // LEVEL
-      right[i] = fx;
+      work[i] = dbGain;
+    }
+    dbToGain(work, work, size); // 倍率換算
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      right[i] = level_ * work[i] * right[i]; // コンプレッション実行、LEVEL
     }
   }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数
+  uint32_t getTailLength() const noexcept override
+  {
+    return static_cast<uint32_t>(13.8155106f * 0.001f * ui_[RELEASE].getValue() * SAMPLING_FREQ); // リリース時定数で -120dB
+  }
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  void clearState() noexcept override { env_.reset(); }
 };
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "effector_base.h"
+#include "lib/lib_filter.hpp"
+#include "lib/lib_tempo.hpp"
 #include <cstdio> // sprintf
 
 namespace satoh
@@ -27,6 +29,7 @@ protected:
     ELEVEL,
     FBACK,
     TONE,
+    SYNC,  ///< テンポ同期（音符の長さ）
     COUNT, ///< パラメータ総数
   };
 
@@ -36,6 +39,26 @@ protected:
   float fback_;
   float elevel_;
 
+  /// @brief ディレイタイムを取得
+  /// @return ディレイタイム（ミリ秒 テンポ同期中はTAPのテンポから求め、最大値を超える場合は半分にしていく）
+  float getDelayTime() const noexcept
+  {
+    const auto div = static_cast<uint8_t>(ui_[SYNC].getValue());
+    if (div == TempoClock::OFF || !tempo_)
+    {
+      return ui_[DTIME].getValue();
+    }
+    return tempo_->getTime(div, ui_[DTIME].getMax());
+  }
+  /// @brief テンポ同期中ならば、ディレイタイムをテンポに合わせる（ブロック毎に呼ぶ）
+  void followTempo() noexcept
+  {
+    if (static_cast<uint8_t>(ui_[SYNC].getValue()) != TempoClock::OFF)
+    {
+      updateDtime();
+    }
+  }
+
 private:
   /// @brief DTIMEを更新する
   virtual void updateDtime() noexcept = 0;
@@ -47,6 +70,7 @@ private:
     switch (n)
     {
     case DTIME:
+    case SYNC:
       updateDtime();
       break;
     case ELEVEL:
@@ -76,6 +100,8 @@ private:
     case TONE:
       sprintf(valueTxt_, "%d", static_cast<int>(ui_[n].getValue()));
       return valueTxt_;
+    case SYNC:
+      return TempoClock::getDivisionName(static_cast<uint8_t>(ui_[n].getValue()));
     default:
       return 0;
     }
@@ -90,10 +116,11 @@ public:
   DelayBase(ID id, const char *name, const char *shortName, RGB const &ledColor) //
       : EffectorBase(id, name, shortName, ledColor),                             //
         ui_{
-            EffectParameterF(10, 900, 100, 5, "TIME"), //
-            EffectParameterF(0, 100, 1, "E.LV"),       //
-            EffectParameterF(0, 99, 1, "F.BACK"),      //
-            EffectParameterF(0, 100, 1, "TONE"),       //
+            EffectParameterF(10, 900, 100, 5, "TIME"),                         //
+            EffectParameterF(0, 100, 1, "E.LV"),                               //
+            EffectParameterF(0, 99, 1, "F.BACK"),                              //
+            EffectParameterF(0, 100, 1, "TONE"),                               //
+            EffectParameterF(0, TempoClock::DIVISION_COUNT - 1, 0, 1, "SYNC"), //
         },
         fback_(0), //
         elevel_(0) //
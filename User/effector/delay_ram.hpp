@@ -22,7 +22,7 @@ class satoh::fx::DelayRam : public satoh::fx::DelayBase
 {
   delayBuf<int16_t> delayBuf_;
   /// @brief DTIMEを更新する
-  void updateDtime() noexcept override { delayBuf_.setInterval(ui_[DTIME].getValue()); }
+  void updateDtime() noexcept override { delayBuf_.setInterval(getDelayTime()); }
 
 public:
   /// @brief コンストラクタ
@@ -47,6 +47,7 @@ public:
   /// @param [in] size 音声データ数
   void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    followTempo();
     for (uint32_t i = 0; i < size; ++i)
     {
       float fx = delayBuf_.read();
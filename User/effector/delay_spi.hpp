@@ -26,7 +26,7 @@ class satoh::fx::DelaySpi : public satoh::fx::DelayBase
   UniquePtr<float> wbuf_;
 
   /// @brief DTIMEを更新する
-  void updateDtime() noexcept override { delayBuf_.setInterval(ui_[DTIME].getValue()); }
+  void updateDtime() noexcept override { delayBuf_.setInterval(getDelayTime()); }
 
 public:
   /// @brief コンストラクタ
@@ -56,6 +56,7 @@ public:
   /// @param [in] size 音声データ数
   void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    followTempo();
     float *r = rbuf_.get();
     float *w = wbuf_.get();
     delayBuf_.read(r);
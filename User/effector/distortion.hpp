@@ -128,4 +128,17 @@ public:
       right[i] = fx;
     }
   }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数
+  uint32_t getTailLength() const noexcept override { return iirTail(30.0f, 165.0f); } // ローカット2 30Hz の後段に GAIN 最大 +45dB がある
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  void clearState() noexcept override
+  {
+    hpf1.reset();
+    hpf2.reset();
+    hpfTone.reset();
+    lpf1.reset();
+    lpf2.reset();
+    lpfTone.reset();
+  }
 };
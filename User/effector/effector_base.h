@@ -14,6 +14,8 @@
 
 namespace satoh
 {
+class LfoPool;
+class TempoClock;
 namespace fx
 {
 class EffectorBase;
@@ -21,6 +23,8 @@ template <typename T>
 class EffectParameter;
 /// エフェクトパラメータ型（float版）
 using EffectParameterF = EffectParameter<float>;
+/// 残響などが無限に続く（無音入力時も処理を省略しない）
+constexpr uint32_t TAIL_INFINITE = UINT32_MAX;
 
 /// @brief データ圧縮
 /// @param [in] min 最小値
@@ -160,6 +164,11 @@ class satoh::fx::EffectorBase
   virtual const char *getValueTxtImpl(uint8_t n) const noexcept = 0;
 
 protected:
+  /// テンポクロック（音声タスクが設定する 未設定は0）
+  TempoClock const *tempo_ = 0;
+  /// LFO プール（音声タスクが設定する 未設定は0）
+  LfoPool *lfo_ = 0;
+
   /// @brief 属性初期化
   /// @param [in] uiParam UIパラメータ
   /// @param [in] paramCount パラメータ総数
@@ -196,6 +205,17 @@ public:
   /// @retval true 成功
   /// @retval false 失敗
   virtual explicit operator bool() const noexcept { return true; }
+  /// @brief 直近のエフェクト処理で無音を出力したか
+  /// @retval true 無音（後段の処理を省略してよい）
+  /// @retval false 音を出力した
+  virtual bool isOutputSilent() const noexcept { return false; }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数（TAIL_INFINITE は落ち着かない = 処理を省略しない）
+  /// @note この長さだけ無音を入力した後は、clearState() で内部状態を初期化し処理を省略できる。
+  ///   clearState() の後に無音を入力した場合、出力は無音で内部状態も変化しないこと。
+  virtual uint32_t getTailLength() const noexcept { return TAIL_INFINITE; }
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  virtual void clearState() noexcept {}
   /// @brief エフェクターIDを取得
   /// @return エフェクターID
   virtual ID getID() const noexcept { return id_; }
@@ -369,9 +389,18 @@ public:
     }
     return 0;
   }
-  /// @brief タップ間隔を設定する
-  /// @param [in] ms タップ間隔（ミリ秒）
-  virtual void setTapInterval(uint32_t ms) noexcept {}
+  /// @brief テンポクロックを設定する（音声タスクから呼ぶ）
+  /// @param [in] clock テンポクロック
+  void setTempoClock(TempoClock const *clock) noexcept { tempo_ = clock; }
+  /// @brief LFO プールを設定する（音声タスクから呼ぶ）
+  /// @param [in] pool LFO プール
+  void setLfoPool(LfoPool *pool) noexcept { lfo_ = pool; }
+  /// @brief TAPボタンが押されたことを通知する
+  virtual void notifyTap() noexcept {}
+  /// @brief 選択中のパッチのエフェクトボタンが押されたことを通知する
+  /// @retval true ボタンを操作に使った（パッチを読み込み直さない）
+  /// @retval false 使わない
+  virtual bool notifyEffectKey() noexcept { return false; }
   /// @brief LED色を取得
   /// @return LED色
   virtual RGB getColor() const noexcept { return ledColor_; }
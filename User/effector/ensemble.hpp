@@ -0,0 +1,251 @@
+/// @file      effector/ensemble.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "effector_base.h"
+#include "lib/lib_calc.hpp"
+#include "lib/lib_delay.hpp"
+#include "lib/lib_filter.hpp"
+#include <algorithm>
+#include <cmath>   // sin, cos, sqrt
+#include <cstdio>  // snprintf
+#include <cstring> // memcpy
+
+namespace satoh
+{
+namespace fx
+{
+class Ensemble;
+}
+} // namespace satoh
+
+/// @brief アンサンブル（複数ボイスのステレオコーラス）
+/// @note 1本のディレイバッファから、ボイス毎に別々に揺らした位置を読み出し、左右に振り分けて出力する。
+///   ボイスを増やしてもバッファは増えない。
+///   LFO はブロック毎に計算し、ブロック内のディレイタイムは直線で補間する。
+class satoh::fx::Ensemble : public satoh::fx::EffectorBase
+{
+  enum
+  {
+    LEVEL = 0, ///< レベル
+    MIX,       ///< ミックス
+    VOICE,     ///< ボイス数
+    RATE,      ///< 周期
+    DEPTH,     ///< 深さ
+    TONE,      ///< トーン
+    COUNT,     ///< パラメータ総数
+  };
+
+  static constexpr uint32_t MAX_VOICE = 4;    ///< 最大ボイス数
+  static constexpr float BASE_TIME = 6.0f;    ///< ディレイタイムの中心（ミリ秒）
+  static constexpr float SPREAD_TIME = 1.5f;  ///< ボイス毎にずらすディレイタイム（ミリ秒）
+  static constexpr float MAX_DEPTH = 3.0f;    ///< 最大の揺れ幅（±ミリ秒）
+  static constexpr float BUFFER_TIME = 16.0f; ///< ディレイバッファの長さ（ミリ秒 最大ディレイタイムは 13.5ms）
+
+  EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
+  mutable char valueTxt_[12];  ///< パラメータ文字列格納バッファ（intの最大桁数まで）
+  delayBuf<float> del_;        ///< 全ボイス共通のディレイバッファ
+  hpf hpfIn_;                  ///< ディレイ音のローカット
+  lpf2nd lpfL1_;               ///< L ディレイ音のハイカット
+  lpf2nd lpfL2_;               ///< L ディレイ音のハイカット
+  lpf2nd lpfR1_;               ///< R ディレイ音のハイカット
+  lpf2nd lpfR2_;               ///< R ディレイ音のハイカット
+  float level_;                ///< レベル
+  float mix_;                  ///< ミックス
+  uint32_t voice_;             ///< ボイス数
+  uint32_t active_;            ///< 直前のブロックで鳴らしたボイス数
+  float freq_;                 ///< LFO 周波数
+  float depth_;                ///< 揺れ幅（サンプル数）
+  float phase_[MAX_VOICE];     ///< ボイス毎の LFO 位相（0 ～ 1）
+  float interval_[MAX_VOICE];  ///< ボイス毎の直前のブロック終わりのディレイタイム（サンプル数）
+  float next_[MAX_VOICE];      ///< ボイス毎の今回のブロック終わりのディレイタイム（サンプル数）
+  float gainL_[MAX_VOICE];     ///< ボイス毎の L への振り分け（直前のブロック終わり）
+  float gainR_[MAX_VOICE];     ///< ボイス毎の R への振り分け（直前のブロック終わり）
+  float targetL_[MAX_VOICE];   ///< ボイス毎の L への振り分けの目標
+  float targetR_[MAX_VOICE];   ///< ボイス毎の R への振り分けの目標
+
+  /// @brief ボイス数から、左右への振り分けを求める
+  /// @note 左端から右端まで等間隔に並べ、パワーが一定になるように振り分ける。
+  ///   使わないボイスは 0 にする（次のブロックで徐々に変えるので、ボイス数を変えてもプチノイズが出ない）。
+  void updatePan() noexcept
+  {
+    const float norm = std::sqrt(2.0f / voice_); // ボイス数によらずディレイ音の音量を揃える
+    for (uint32_t k = 0; k < MAX_VOICE; ++k)
+    {
+      const float angle = 0.5f * PI * k / (voice_ - 1);
+      targetL_[k] = k < voice_ ? norm * std::cos(angle) : 0.0f;
+      targetR_[k] = k < voice_ ? norm * std::sin(angle) : 0.0f;
+    }
+  }
+  /// @brief ボイスの LFO を1ブロック進めたディレイタイムを求める
+  /// @param [in] k ボイス番号
+  /// @param [in] size 音声データ数
+  /// @return ディレイタイム（サンプル数）
+  float advance(uint32_t k, uint32_t size) noexcept
+  {
+    static const float RATE_RATIO[MAX_VOICE] = {1.0f, 1.13f, 0.89f, 1.27f}; // 揺れが揃わないようにボイス毎に周波数を変える
+    float ph = phase_[k] + RATE_RATIO[k] * freq_ * size / SAMPLING_FREQ;
+    ph -= static_cast<float>(static_cast<uint32_t>(ph));
+    phase_[k] = ph;
+    constexpr float ms = 0.001f * SAMPLING_FREQ;
+    return (BASE_TIME + SPREAD_TIME * k) * ms + depth_ * std::sin(2.0f * PI * ph);
+  }
+  /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
+  /// @param [in] n 変換対象のパラメータ番号
+  void convUiToFx(uint8_t n) noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+      level_ = dbToGain(ui_[LEVEL].getValue()); // LEVEL -20...+20 dB
+      break;
+    case MIX:
+      mix_ = mixPot(ui_[MIX].getValue(), -20.0f); // MIX
+      break;
+    case VOICE:
+      voice_ = static_cast<uint32_t>(ui_[VOICE].getValue()); // 2...4 ボイス
+      updatePan();
+      break;
+    case RATE:
+      freq_ = 1.0f / (0.02f * (105.0f - ui_[RATE].getValue())); // RATE 周期 2.1～0.1 秒
+      break;
+    case DEPTH:
+      depth_ = 0.01f * ui_[DEPTH].getValue() * MAX_DEPTH * 0.001f * SAMPLING_FREQ; // DEPTH ±0～3ms
+      break;
+    case TONE:
+    {
+      float tone = 800.0f * logPot(ui_[TONE].getValue(), 0.0f, 20.0f); // HI CUT FREQ 800 ～ 8000 Hz
+      lpfL1_.set(tone);
+      lpfL2_.set(tone);
+      lpfR1_.set(tone);
+      lpfR2_.set(tone);
+      break;
+    }
+    }
+  }
+  /// @brief パラメータ値文字列取得
+  /// @param [in] n パラメータ番号
+  /// @return 文字列のポインタ
+  const char *getValueTxtImpl(uint8_t n) const noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+    {
+      int v = static_cast<int>(ui_[n].getValue());
+      if (v <= 0)
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "%d", v);
+      }
+      else
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "+%d", v);
+      }
+      return valueTxt_;
+    }
+    case MIX:
+    case VOICE:
+    case RATE:
+    case DEPTH:
+    case TONE:
+      snprintf(valueTxt_, sizeof(valueTxt_), "%d", static_cast<int>(ui_[n].getValue()));
+      return valueTxt_;
+    default:
+      return 0;
+    }
+  }
+
+public:
+  /// @brief コンストラクタ
+  Ensemble()                                                             //
+      : EffectorBase(ENSEMBLE, "Ensemble", "EN", RGB{0x00, 0x20, 0x10}), //
+        ui_{
+            EffectParameterF(-20, 20, 0, 1, "LV"),    //
+            EffectParameterF(0, 100, 50, 1, "MIX"),   //
+            EffectParameterF(2, 4, 3, 1, "VOICE"),    //
+            EffectParameterF(1, 100, 40, 1, "RATE"),  //
+            EffectParameterF(1, 100, 50, 1, "DEPTH"), //
+            EffectParameterF(1, 100, 70, 1, "TONE"),  //
+        },                                            //
+        del_(BUFFER_TIME, MemTag::DTCM),              //
+        level_(1),                                    //
+        mix_(1),                                      //
+        voice_(MAX_VOICE),                            //
+        active_(MAX_VOICE),                           //
+        freq_(1),                                     //
+        depth_(0),                                    //
+        phase_{},                                     //
+        interval_{},                                  //
+        next_{},                                      //
+        gainL_{},                                     //
+        gainR_{},                                     //
+        targetL_{},                                   //
+        targetR_{}                                    //
+  {
+    if (*this)
+    {
+      hpfIn_.set(100.0f); // ディレイ音のローカット設定
+      init(ui_, COUNT);
+      for (uint32_t k = 0; k < MAX_VOICE; ++k)
+      {
+        phase_[k] = static_cast<float>(k) / MAX_VOICE; // 揺れの位相をボイス毎にずらす
+        interval_[k] = advance(k, 0);
+        gainL_[k] = targetL_[k];
+        gainR_[k] = targetR_[k];
+      }
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~Ensemble() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return static_cast<bool>(del_); }
+  /// @brief エフェクト処理実行
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
+  ITCM_CODE void effect(float *left, float *right, uint32_t size) noexcept override
+  {
+    // LFO はブロック毎に進め、ブロック内のディレイタイムと振り分けは直線で補間する
+    // 使っていないボイスも進めておき、ボイス数を変えた時にディレイタイムが飛ばないようにする
+    float step[MAX_VOICE];
+    float stepL[MAX_VOICE];
+    float stepR[MAX_VOICE];
+    const float div = 1.0f / size;
+    for (uint32_t k = 0; k < MAX_VOICE; ++k)
+    {
+      next_[k] = advance(k, size);
+      step[k] = (next_[k] - interval_[k]) * div;
+      stepL[k] = (targetL_[k] - gainL_[k]) * div;
+      stepR[k] = (targetR_[k] - gainR_[k]) * div;
+    }
+    const uint32_t active = std::max(voice_, active_); // 減らしたボイスはこのブロックでフェードアウトする
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      const float dry = right[i];
+      del_.write(hpfIn_.process(dry)); // 原音はローカットして書込
+      float wetL = 0.0f;
+      float wetR = 0.0f;
+      const float t = static_cast<float>(i + 1);
+      for (uint32_t k = 0; k < active; ++k)
+      {
+        const float v = del_.readLerpAt(interval_[k] + step[k] * t);
+        wetL += (gainL_[k] + stepL[k] * t) * v;
+        wetR += (gainR_[k] + stepR[k] * t) * v;
+      }
+      wetL = lpfL2_.process(lpfL1_.process(wetL)); // ディレイ音のTONE(ハイカット)
+      wetR = lpfR2_.process(lpfR1_.process(wetR));
+      left[i] = level_ * ((1.0f - mix_) * dry + mix_ * wetL);
+      right[i] = level_ * ((1.0f - mix_) * dry + mix_ * wetR);
+    }
+    memcpy(interval_, next_, sizeof(interval_));
+    memcpy(gainL_, targetL_, sizeof(gainL_));
+    memcpy(gainR_, targetR_, sizeof(gainR_));
+    active_ = voice_;
+  }
+};
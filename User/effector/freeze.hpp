@@ -0,0 +1,211 @@
+/// @file      effector/freeze.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "common/alloc.hpp"
+#include "effector_base.h"
+#include "lib/lib_calc.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>  // snprintf
+#include <cstring> // memset
+
+namespace satoh
+{
+namespace fx
+{
+class Freeze;
+}
+} // namespace satoh
+
+/// @brief フリーズ（直前の短い音を切り出し、繰り返して伸ばし続ける）
+/// @note 選択中のパッチのエフェクトボタンでフリーズ・解除を切り替える。
+///   フリーズしていない間は直近の音をリングバッファに取り込み続け、フリーズした時点の LEN + LEN / 4 サンプルを使う。
+///   ループの終わり LEN / 4 サンプルは、ループ先頭の直前の音とクロスフェードしてつなぎ目を目立たなくする。
+///   バッファは構築時に一度だけ確保し、1サンプルあたりの処理量はフリーズ中も一定。
+class satoh::fx::Freeze : public satoh::fx::EffectorBase
+{
+  enum
+  {
+    LEVEL = 0, ///< レベル
+    MIX,       ///< ミックス
+    LENGTH,    ///< ループ長
+    COUNT,     ///< パラメータ総数
+  };
+
+  static constexpr uint32_t MAX_LENGTH = static_cast<uint32_t>(0.08f * SAMPLING_FREQ); ///< 最大ループ長（80ms）
+  static constexpr uint32_t RING_SIZE = MAX_LENGTH + MAX_LENGTH / 4;                   ///< 取り込み用リングバッファのサンプル数
+  static constexpr float FADE_STEP = 1.0f / (0.01f * SAMPLING_FREQ);                  ///< フリーズ音のフェードイン・アウト（10ms）
+
+  EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
+  mutable char valueTxt_[12];  ///< パラメータ文字列格納バッファ（intの最大桁数まで）
+  UniquePtr<float> buf_;       ///< 取り込み用リングバッファ
+  std::atomic<bool> toggle_;   ///< 未処理のフリーズ切り替え要求
+  float level_;                ///< レベル
+  float mix_;                  ///< ミックス
+  uint32_t length_;            ///< 次にフリーズする時のループ長（サンプル数）
+  bool frozen_;                ///< フリーズ中
+  float fade_;                 ///< フリーズ音の音量（0 ～ 1）
+  uint32_t wpos_;              ///< 取り込み位置
+  uint32_t loopLength_;        ///< フリーズ中のループ長（サンプル数）
+  uint32_t xfade_;             ///< フリーズ中のクロスフェード長（サンプル数）
+  float xfadeStep_;            ///< 1 / xfade_
+  uint32_t top_;               ///< フリーズ中のループ先頭位置（リングバッファ上）
+  uint32_t pos_;               ///< ループ内の再生位置
+
+  /// @brief フリーズ・解除を切り替える
+  void toggle() noexcept
+  {
+    if (frozen_)
+    {
+      frozen_ = false; // フェードアウトし終わってから取り込みを再開する
+      return;
+    }
+    frozen_ = true;
+    if (0.0f < fade_)
+    {
+      return; // フェードアウト中ならば同じ音のままフェードインし直す
+    }
+    loopLength_ = length_;
+    xfade_ = length_ / 4;
+    xfadeStep_ = 1.0f / xfade_;
+    top_ = (wpos_ + RING_SIZE - loopLength_) % RING_SIZE; // 直前の xfade_ サンプルはクロスフェードに使う
+    pos_ = 0;
+  }
+  /// @brief フリーズした音を1サンプル読み出す
+  /// @return 音声データ
+  float read() noexcept
+  {
+    float const *buf = buf_.get();
+    uint32_t a = top_ + pos_;
+    a = a < RING_SIZE ? a : a - RING_SIZE;
+    float v = buf[a];
+    const uint32_t fadeTop = loopLength_ - xfade_;
+    if (fadeTop <= pos_)
+    {
+      // ループ先頭の直前の音へクロスフェードし、先頭に戻った時に連続させる
+      uint32_t b = a + RING_SIZE - loopLength_;
+      b = b < RING_SIZE ? b : b - RING_SIZE;
+      v += static_cast<float>(pos_ - fadeTop) * xfadeStep_ * (buf[b] - v);
+    }
+    pos_ = pos_ + 1 < loopLength_ ? pos_ + 1 : 0;
+    return v;
+  }
+  /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
+  /// @param [in] n 変換対象のパラメータ番号
+  void convUiToFx(uint8_t n) noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+      level_ = dbToGain(ui_[LEVEL].getValue()); // LEVEL -20...+20 dB
+      break;
+    case MIX:
+      mix_ = mixPot(ui_[MIX].getValue(), -20.0f); // MIX
+      break;
+    case LENGTH:
+      length_ = std::min(static_cast<uint32_t>(ui_[LENGTH].getValue() * 0.001f * SAMPLING_FREQ), MAX_LENGTH); // 20...80 ms
+      break;
+    }
+  }
+  /// @brief パラメータ値文字列取得
+  /// @param [in] n パラメータ番号
+  /// @return 文字列のポインタ
+  const char *getValueTxtImpl(uint8_t n) const noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+    {
+      int v = static_cast<int>(ui_[n].getValue());
+      if (v <= 0)
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "%d", v);
+      }
+      else
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "+%d", v);
+      }
+      return valueTxt_;
+    }
+    case MIX:
+    case LENGTH:
+      snprintf(valueTxt_, sizeof(valueTxt_), "%d", static_cast<int>(ui_[n].getValue()));
+      return valueTxt_;
+    default:
+      return 0;
+    }
+  }
+
+public:
+  /// @brief コンストラクタ
+  Freeze()                                                           //
+      : EffectorBase(FREEZE, "Freeze", "FZ", RGB{0x00, 0x18, 0x20}), //
+        ui_{
+            EffectParameterF(-20, 20, 0, 1, "LV"),   //
+            EffectParameterF(0, 100, 50, 1, "MIX"),  //
+            EffectParameterF(20, 80, 50, 5, "LEN"),  //
+        },                                           //
+        buf_(allocArray<float>(RING_SIZE)),          //
+        toggle_(false),                              //
+        level_(1),                                   //
+        mix_(1),                                     //
+        length_(MAX_LENGTH),                         //
+        frozen_(false),                              //
+        fade_(0),                                    //
+        wpos_(0),                                    //
+        loopLength_(MAX_LENGTH),                     //
+        xfade_(MAX_LENGTH / 4),                      //
+        xfadeStep_(1.0f / xfade_),                   //
+        top_(0),                                     //
+        pos_(0)                                      //
+  {
+    if (*this)
+    {
+      memset(buf_.get(), 0, RING_SIZE * sizeof(float));
+      init(ui_, COUNT);
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~Freeze() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return static_cast<bool>(buf_); }
+  /// @brief エフェクト処理実行
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
+  void effect(float *left, float *right, uint32_t size) noexcept override
+  {
+    if (toggle_.exchange(false))
+    {
+      toggle();
+    }
+    float *buf = buf_.get();
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      if (!frozen_ && fade_ <= 0.0f)
+      {
+        buf[wpos_] = right[i];
+        wpos_ = wpos_ + 1 < RING_SIZE ? wpos_ + 1 : 0;
+        right[i] *= level_;
+        continue;
+      }
+      fade_ = frozen_ ? std::min(fade_ + FADE_STEP, 1.0f) : std::max(fade_ - FADE_STEP, 0.0f);
+      const float wet = mix_ * fade_;
+      right[i] = level_ * ((1.0f - wet) * right[i] + wet * read());
+    }
+  }
+  /// @brief 選択中のパッチのエフェクトボタンが押されたことを通知する
+  /// @retval true フリーズ・解除に使う
+  bool notifyEffectKey() noexcept override
+  {
+    toggle_ = true;
+    return true;
+  }
+};
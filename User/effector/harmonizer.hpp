@@ -0,0 +1,208 @@
+/// @file      effector/harmonizer.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "effector_base.h"
+#include "lib/lib_calc.hpp"
+#include "lib/lib_pitch.hpp"
+#include "lib/lib_pitch_shift.hpp"
+#include <cmath>  // log2, abs
+#include <cstdio> // snprintf
+
+namespace satoh
+{
+namespace fx
+{
+class Harmonizer;
+}
+} // namespace satoh
+
+/// @brief ハーモナイザー（選択したキーの音階に沿って3度・5度の音を加える）
+/// @note 入力音の高さを PitchDetector で検出し、音階上で INTV 度離れた音までの半音数だけ PitchShift でずらす。
+///   検出は Tuner のように専用モードにせず、毎ブロック detectStep() で差分関数を STEP_TAUS 周期分ずつ計算する。
+///   音階にない音（経過音）は、すぐ下の音階の音と同じ半音数ずらす。
+///   音が検出できない間（無音・和音）は直前の半音数を保つ。
+class satoh::fx::Harmonizer : public satoh::fx::EffectorBase
+{
+  enum
+  {
+    LEVEL = 0, ///< レベル
+    MIX,       ///< ミックス
+    KEY,       ///< キー（主音）
+    SCALE,     ///< 音階（メジャー・マイナー）
+    INTERVAL,  ///< 加える音の度数
+    COUNT,     ///< パラメータ総数
+  };
+
+  static constexpr uint32_t STEP_TAUS = 30;      ///< 1ブロックで差分関数を計算する周期の数（約10ブロックで1回検出）
+  static constexpr float NOTE_HYSTERESIS = 0.7f; ///< 音名を切り替える半音のずれ（ベンド・ビブラートで揺れないように）
+
+  EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
+  mutable char valueTxt_[12];  ///< パラメータ文字列格納バッファ（intの最大桁数まで）
+  PitchDetector detector_;     ///< ピッチ検出
+  PitchShift shift_;           ///< ピッチシフト
+  float wet_[BLOCK_SIZE];      ///< ピッチシフト音
+  float level_;                ///< レベル
+  float mix_;                  ///< ミックス
+  int8_t semitone_[12];        ///< 音名（キーからの半音数）毎にずらす半音数
+  int note_;                   ///< 直近に検出した音（MIDIノート番号 -1は未検出）
+
+  /// @brief キーの表示文字列を取得
+  /// @param [in] n キー（0:C ～ 11:B）
+  /// @return 文字列のポインタ
+  static const char *keyName(uint32_t n) noexcept
+  {
+    static const char *const NAME[] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+    return NAME[n % 12];
+  }
+  /// @brief 音階とずらす度数から、音名毎にずらす半音数を求める
+  /// @note 例 C メジャー +3RD : C→E(+4) D→F(+3) E→G(+3) F→A(+4) G→B(+4) A→C(+3) B→D(+3)
+  void updateTable() noexcept
+  {
+    static const int8_t MAJOR[] = {0, 2, 4, 5, 7, 9, 11};
+    static const int8_t MINOR[] = {0, 2, 3, 5, 7, 8, 10};
+    static const int8_t DEGREE[] = {-4, -2, 2, 4}; // -5度, -3度, +3度, +5度（音階上の隔たり）
+    int8_t const *scale = ui_[SCALE].getValue() < 0.5f ? MAJOR : MINOR;
+    const int step = DEGREE[static_cast<uint32_t>(ui_[INTERVAL].getValue())];
+    int deg = 0;
+    for (int pc = 0; pc < 12; ++pc)
+    {
+      while (deg < 6 && scale[deg + 1] <= pc)
+      {
+        ++deg;
+      }
+      const int to = deg + step + 7; // 負にならないよう1オクターブ上げて計算する
+      semitone_[pc] = static_cast<int8_t>(scale[to % 7] + 12 * (to / 7) - 12 - scale[deg]);
+    }
+  }
+  /// @brief 直近に検出した音からずらす半音数を設定する
+  void applyShift() noexcept
+  {
+    if (0 <= note_)
+    {
+      const int pc = (note_ - static_cast<int>(ui_[KEY].getValue()) + 120) % 12;
+      shift_.setSemitone(semitone_[pc]);
+    }
+  }
+  /// @brief 検出した周波数から、ずらす半音数を更新する
+  /// @param [in] freq 周波数（0は検出なし）
+  void updateShift(float freq) noexcept
+  {
+    if (freq <= 0.0f)
+    {
+      return;
+    }
+    const float note = 69.0f + 12.0f * std::log2(freq / 440.0f);
+    if (note_ < 0 || NOTE_HYSTERESIS < std::abs(note - note_))
+    {
+      note_ = static_cast<int>(note + 0.5f);
+    }
+    applyShift();
+  }
+  /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
+  /// @param [in] n 変換対象のパラメータ番号
+  void convUiToFx(uint8_t n) noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+      level_ = dbToGain(ui_[LEVEL].getValue()); // LEVEL -20...+20 dB
+      break;
+    case MIX:
+      mix_ = mixPot(ui_[MIX].getValue(), -20.0f); // MIX
+      break;
+    case KEY:
+    case SCALE:
+    case INTERVAL:
+      updateTable();
+      applyShift();
+      break;
+    }
+  }
+  /// @brief パラメータ値文字列取得
+  /// @param [in] n パラメータ番号
+  /// @return 文字列のポインタ
+  const char *getValueTxtImpl(uint8_t n) const noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+    {
+      int v = static_cast<int>(ui_[n].getValue());
+      if (v <= 0)
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "%d", v);
+      }
+      else
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "+%d", v);
+      }
+      return valueTxt_;
+    }
+    case MIX:
+      snprintf(valueTxt_, sizeof(valueTxt_), "%d", static_cast<int>(ui_[n].getValue()));
+      return valueTxt_;
+    case KEY:
+      return keyName(static_cast<uint32_t>(ui_[n].getValue()));
+    case SCALE:
+      return ui_[n].getValue() < 0.5f ? "MAJ" : "MIN";
+    case INTERVAL:
+    {
+      static const char *const NAME[] = {"-5TH", "-3RD", "+3RD", "+5TH"};
+      return NAME[static_cast<uint32_t>(ui_[n].getValue())];
+    }
+    default:
+      return 0;
+    }
+  }
+
+public:
+  /// @brief コンストラクタ
+  Harmonizer()                                                               //
+      : EffectorBase(HARMONIZER, "Harmonizer", "HM", RGB{0x10, 0x20, 0x00}), //
+        ui_{
+            EffectParameterF(-20, 20, 0, 1, "LV"),  //
+            EffectParameterF(0, 100, 50, 1, "MIX"), //
+            EffectParameterF(0, 11, 0, 1, "KEY"),   //
+            EffectParameterF(0, 1, 0, 1, "SCALE"),  //
+            EffectParameterF(0, 3, 2, 1, "INTV"),   //
+        },                                          //
+        level_(1),                                  //
+        mix_(1),                                    //
+        semitone_{},                                //
+        note_(-1)                                   //
+  {
+    if (*this)
+    {
+      init(ui_, COUNT);
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~Harmonizer() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return static_cast<bool>(detector_) && static_cast<bool>(shift_); }
+  /// @brief エフェクト処理実行
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
+  void effect(float *left, float *right, uint32_t size) noexcept override
+  {
+    detector_.push(right, size);
+    if (detector_.detectStep(STEP_TAUS))
+    {
+      updateShift(detector_.getFreq());
+    }
+    shift_.process(right, wet_, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      float fx = (1.0f - mix_) * right[i] + mix_ * wet_[i];
+      right[i] = level_ * fx;
+    }
+  }
+};
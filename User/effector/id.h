@@ -45,15 +45,29 @@ constexpr ID DELAY_RAM = 4 | cat::SPACE;
 constexpr ID DELAY_SPI = 5 | cat::SPACE;
 /// リバーブ
 constexpr ID REVERB = 6 | cat::SPACE;
+/// フリーズ
+constexpr ID FREEZE = 7 | cat::SPACE;
+/// アンサンブル
+constexpr ID ENSEMBLE = 8 | cat::SPACE;
 /// BQフィルター
 constexpr ID BQ_FILTER = 1 | cat::FILTER;
 /// オートワウ
 constexpr ID AUTO_WAH = 2 | cat::FILTER;
+/// キャビネット
+constexpr ID CABINET = 3 | cat::FILTER;
+/// ピッチシフター
+constexpr ID PITCH_SHIFTER = 1 | cat::PITCH;
+/// ハーモナイザー
+constexpr ID HARMONIZER = 2 | cat::PITCH;
+/// ノイズゲート
+constexpr ID NOISE_GATE = 1 | cat::NOISE;
 /// バイパス
 constexpr ID BYPASS = 1 | cat::OTHER;
 /// テンプレート
 constexpr ID TEMPLATE = 2 | cat::OTHER;
 /// オシレーター
 constexpr ID OSCILLATOR = 3 | cat::OTHER;
+/// ルーパー
+constexpr ID LOOPER = 4 | cat::OTHER;
 } // namespace fx
 } // namespace satoh
\ No newline at end of file
@@ -0,0 +1,421 @@
+/// @file      effector/lib/lib_conv.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "common/alloc.hpp"
+#include "constant.h"
+#include "lib_fft.hpp"
+#include <algorithm>
+#include <cstring> // memset, memcpy, memmove
+
+namespace satoh
+{
+class UniformConvolver;
+} // namespace satoh
+
+/// @brief 均一分割 overlap-save 畳み込み
+/// @note インパルス応答（IR）をBLOCK_SIZE毎に分割し、各分割のスペクトルを周波数領域ディレイライン（FDL）上の
+///   過去の入力スペクトルと掛け合わせて合計し、1回の逆FFTで1ブロック分の出力を得る。
+///   FFTサイズ FFT_SIZE は BLOCK_SIZE * 2 以上の2のべき乗で、入力窓の末尾 BLOCK_SIZE サンプルが有効な出力となる。
+///   1ブロックの処理量は FFT 2回 + 分割数 × (FFT_SIZE/2) 回の複素積和。
+class satoh::UniformConvolver
+{
+public:
+  static constexpr uint32_t FFT_SIZE = 256;         ///< FFTサイズ
+  static constexpr uint32_t PARTITION = BLOCK_SIZE; ///< 分割サイズ（= ブロックサイズ）
+  static_assert(PARTITION * 2 <= FFT_SIZE, "FFT_SIZE is too small");
+  using Fft = RealFft<FFT_SIZE>; ///< FFT
+
+private:
+  /// @brief コピーコンストラクタ削除
+  UniformConvolver(UniformConvolver const &) = delete;
+  /// @brief 代入演算子削除
+  UniformConvolver &operator=(UniformConvolver const &) = delete;
+
+  Fft fft_;              ///< FFT
+  uint32_t maxCount_;    ///< 最大分割数
+  UniquePtr<float> fdl_; ///< 入力スペクトルのディレイライン（maxCount_ × FFT_SIZE）
+  uint32_t head_;        ///< FDLの最新スペクトル位置
+  float in_[FFT_SIZE];   ///< 入力窓
+  float acc_[FFT_SIZE];  ///< スペクトル積和 / 逆FFT結果
+
+public:
+  /// @brief IR長から分割数を計算する
+  /// @param [in] len IR長（サンプル数）
+  /// @return 分割数
+  static constexpr uint32_t partitionCount(uint32_t len) noexcept { return (len + PARTITION - 1) / PARTITION; }
+  /// @brief コンストラクタ
+  /// @param [in] maxCount 最大分割数
+  explicit UniformConvolver(uint32_t maxCount) noexcept //
+      : maxCount_(maxCount),                            //
+        fdl_(allocArray<float>(maxCount * FFT_SIZE)),   //
+        head_(0)                                        //
+  {
+    clear();
+  }
+  /// @brief デストラクタ
+  virtual ~UniformConvolver() {}
+  /// @brief メモリ確保成功・失敗を取得
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return static_cast<bool>(fdl_); }
+  /// @brief 内部状態をクリアする
+  void clear() noexcept
+  {
+    if (fdl_)
+    {
+      memset(fdl_.get(), 0, maxCount_ * FFT_SIZE * sizeof(float));
+    }
+    memset(in_, 0, sizeof(in_));
+    head_ = 0;
+  }
+  /// @brief IRを分割してスペクトルへ変換する
+  /// @param [in] ir インパルス応答
+  /// @param [in] len IR長（サンプル数）
+  /// @param [out] spec スペクトル格納先（partitionCount(len) × FFT_SIZE 要素）
+  void makeSpectrum(float const *ir, uint32_t len, float *spec) const noexcept
+  {
+    const uint32_t count = partitionCount(len);
+    for (uint32_t j = 0; j < count; ++j)
+    {
+      float *h = spec + j * FFT_SIZE;
+      uint32_t n = std::min(PARTITION, len - j * PARTITION);
+      memset(h, 0, FFT_SIZE * sizeof(float));
+      memcpy(h, ir + j * PARTITION, n * sizeof(float));
+      fft_.forward(h, h);
+    }
+  }
+  /// @brief 畳み込み処理
+  /// @param [in] in 入力音声（BLOCK_SIZE要素）
+  /// @param [out] out 出力音声（BLOCK_SIZE要素 inと同じ領域でも可）
+  /// @param [in] spec makeSpectrum()で作成したIRスペクトル
+  /// @param [in] count IRスペクトルの分割数（最大分割数を超えた分は無視する）
+  void process(float const *in, float *out, float const *spec, uint32_t count) noexcept
+  {
+    count = std::min(count, maxCount_);
+    // 入力窓を1ブロック進めてスペクトルをFDLの先頭へ
+    memmove(in_, in_ + PARTITION, (FFT_SIZE - PARTITION) * sizeof(float));
+    memcpy(in_ + FFT_SIZE - PARTITION, in, PARTITION * sizeof(float));
+    head_ = (head_ == 0 ? maxCount_ : head_) - 1;
+    float *x = fdl_.get();
+    fft_.forward(in_, x + head_ * FFT_SIZE);
+    // 分割毎の積和
+    memset(acc_, 0, sizeof(acc_));
+    uint32_t pos = head_;
+    for (uint32_t j = 0; j < count; ++j)
+    {
+      Fft::multiplyAdd(x + pos * FFT_SIZE, spec + j * FFT_SIZE, acc_);
+      pos = (pos + 1 == maxCount_) ? 0 : pos + 1;
+    }
+    fft_.inverse(acc_, acc_);
+    memcpy(out, acc_ + FFT_SIZE - PARTITION, PARTITION * sizeof(float));
+  }
+};
+
+namespace satoh
+{
+template <uint32_t P>
+class ConvLevel;
+class NonUniformConvolver;
+} // namespace satoh
+
+/// @brief 非均一分割畳み込みの1段（分割サイズ P）
+/// @tparam P 分割サイズ（BLOCK_SIZE × 2のべき乗）
+/// @note IRの遅延 2P 以降を P 毎に分割して受け持つ。
+///   P サンプル毎に入力窓のFFT・積和・逆FFTを行い、その処理を P/BLOCK_SIZE 回（スライス）のブロック処理に分散させる。
+///   窓の終端時刻を t0 とすると、計算は t0 〜 t0+P の間に終わり、結果は t0+P 〜 t0+2P に出力されるため、
+///   遅延 2P 以降の分割であれば全体の遅延は増えない。
+template <uint32_t P>
+class satoh::ConvLevel
+{
+  /// @brief 2P以上の最小の2のべき乗 @param [in] n 探索開始値 @return FFTサイズ
+  static constexpr uint32_t fftSize(uint32_t n = 1) noexcept { return n < P * 2 ? fftSize(n * 2) : n; }
+
+public:
+  static constexpr uint32_t FFT_SIZE = fftSize();  ///< FFTサイズ
+  static constexpr uint32_t SLICE = P / BLOCK_SIZE; ///< 処理を分散させるブロック数
+  static constexpr uint32_t DELAY = P * 2;          ///< 受け持つIRの開始位置
+  static_assert(P % BLOCK_SIZE == 0 && (SLICE & (SLICE - 1)) == 0, "P must be BLOCK_SIZE * 2^n");
+
+private:
+  /// @brief log2(n) @param [in] n 2のべき乗 @return log2(n)
+  static constexpr uint32_t log2(uint32_t n) noexcept { return n <= 1 ? 0 : 1 + log2(n / 2); }
+
+public:
+  /// FFTを行うスライス番号（他の段とFFTが重ならないよう段毎にずらす）
+  static constexpr uint32_t FFT_SLICE = SLICE < 4 ? 0 : log2(SLICE) - 1;
+  /// 逆FFTを行うスライス番号（結果のコピーは最後のスライスで、前回の結果を出力し終えてから行う）
+  static constexpr uint32_t IFFT_SLICE = SLICE < 4 ? SLICE - 1 : SLICE - 2;
+  /// 入力履歴に必要なサンプル数
+  static constexpr uint32_t HISTORY_SIZE = FFT_SIZE + BLOCK_SIZE * (FFT_SLICE + 1);
+
+private:
+  /// @brief コピーコンストラクタ削除
+  ConvLevel(ConvLevel const &) = delete;
+  /// @brief 代入演算子削除
+  ConvLevel &operator=(ConvLevel const &) = delete;
+
+  RealFft<FFT_SIZE> fft_; ///< FFT
+  uint32_t count_;        ///< 分割数
+  UniquePtr<float> spec_; ///< IRスペクトル（count_ × FFT_SIZE）
+  UniquePtr<float> fdl_;  ///< 入力スペクトルのディレイライン（count_ × FFT_SIZE）
+  UniquePtr<float> acc_;  ///< スペクトル積和 / 逆FFT結果（FFT_SIZE）
+  UniquePtr<float> out_;  ///< 出力待ちの結果（P）
+  uint32_t head_;         ///< FDLの最新スペクトル位置
+
+  /// @brief 積和 j を担当するスライス番号
+  /// @param [in] j 分割番号
+  /// @return スライス番号（FFTと逆FFTの間のスライスへ均等に割り当てる 間が無ければFFTと同じスライス）
+  uint32_t macSlice(uint32_t j) const noexcept
+  {
+    constexpr uint32_t space = IFFT_SLICE - FFT_SLICE - 1;
+    return space == 0 ? FFT_SLICE : FFT_SLICE + 1 + j * space / count_;
+  }
+
+public:
+  /// @brief 受け持つ分割数を計算する
+  /// @param [in] len IR長（サンプル数）
+  /// @param [in] maxCount 最大分割数（0は無制限）
+  /// @return 分割数
+  static constexpr uint32_t partitionCount(uint32_t len, uint32_t maxCount) noexcept
+  {
+    return len <= DELAY ? 0 : (maxCount != 0 && maxCount < (len - DELAY + P - 1) / P) ? maxCount : (len - DELAY + P - 1) / P;
+  }
+  /// @brief コンストラクタ
+  /// @param [in] count 分割数
+  explicit ConvLevel(uint32_t count) noexcept : count_(count), head_(0)
+  {
+    if (count_ != 0)
+    {
+      spec_ = UniquePtr<float>(allocArray<float>(count_ * FFT_SIZE));
+      fdl_ = UniquePtr<float>(allocArray<float>(count_ * FFT_SIZE));
+      acc_ = UniquePtr<float>(allocArray<float>(FFT_SIZE));
+      out_ = UniquePtr<float>(allocArray<float>(P));
+      if (*this)
+      {
+        memset(spec_.get(), 0, count_ * FFT_SIZE * sizeof(float));
+      }
+    }
+    clear();
+  }
+  /// @brief デストラクタ
+  virtual ~ConvLevel() {}
+  /// @brief メモリ確保成功・失敗を取得
+  /// @retval true 成功（分割数0も成功とする）
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return count_ == 0 || (spec_ && fdl_ && acc_ && out_); }
+  /// @brief 分割数取得 @return 分割数
+  uint32_t count() const noexcept { return count_; }
+  /// @brief 内部状態をクリアする
+  void clear() noexcept
+  {
+    if (count_ != 0 && *this)
+    {
+      memset(fdl_.get(), 0, count_ * FFT_SIZE * sizeof(float));
+      memset(acc_.get(), 0, FFT_SIZE * sizeof(float));
+      memset(out_.get(), 0, P * sizeof(float));
+    }
+    head_ = 0;
+  }
+  /// @brief IRを設定する
+  /// @param [in] ir インパルス応答（先頭からの全体）
+  /// @param [in] len IR長（サンプル数）
+  void setIr(float const *ir, uint32_t len) noexcept
+  {
+    for (uint32_t j = 0; j < count_; ++j)
+    {
+      float *h = spec_.get() + j * FFT_SIZE;
+      uint32_t top = DELAY + j * P;
+      uint32_t n = top < len ? std::min(P, len - top) : 0;
+      memset(h, 0, FFT_SIZE * sizeof(float));
+      memcpy(h, ir + top, n * sizeof(float));
+      fft_.forward(h, h);
+    }
+  }
+  /// @brief 1ブロック分の処理
+  /// @tparam HIST 入力履歴の型（copy(dst, n, back) で最新から back サンプル前を終端とする n サンプルを取得できること）
+  /// @param [in] hist 入力履歴
+  /// @param [in] phase スライス番号（0 〜 SLICE-1 窓の終端がブロック境界に揃った時に0）
+  /// @param [inout] out 出力音声（BLOCK_SIZE要素 結果を加算する）
+  template <typename HIST>
+  void process(HIST const &hist, uint32_t phase, float *out) noexcept
+  {
+    if (count_ == 0)
+    {
+      return;
+    }
+    // 前回の結果を出力
+    float const *o = out_.get() + phase * BLOCK_SIZE;
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      out[i] += o[i];
+    }
+    float *acc = acc_.get();
+    float *x = fdl_.get();
+    if (phase == FFT_SLICE)
+    {
+      // スライス0のブロック先頭を終端とする入力窓をFFT
+      head_ = (head_ == 0 ? count_ : head_) - 1;
+      hist.copy(x + head_ * FFT_SIZE, FFT_SIZE, BLOCK_SIZE * (FFT_SLICE + 1));
+      fft_.forward(x + head_ * FFT_SIZE, x + head_ * FFT_SIZE);
+      memset(acc, 0, FFT_SIZE * sizeof(float));
+    }
+    for (uint32_t j = 0; j < count_; ++j)
+    {
+      if (macSlice(j) == phase)
+      {
+        uint32_t pos = (head_ + j) % count_;
+        RealFft<FFT_SIZE>::multiplyAdd(x + pos * FFT_SIZE, spec_.get() + j * FFT_SIZE, acc);
+      }
+    }
+    if (phase == IFFT_SLICE)
+    {
+      fft_.inverse(acc, acc);
+    }
+    if (phase == SLICE - 1)
+    {
+      memcpy(out_.get(), acc + FFT_SIZE - P, P * sizeof(float));
+    }
+  }
+};
+
+/// @brief 非均一分割畳み込み（遅延なし）
+/// @note IRの先頭 4 × BLOCK_SIZE はブロック毎の均一分割畳み込みで処理し、
+///   それ以降は分割サイズを倍々にした ConvLevel で処理する。最終段（分割サイズ BLOCK_SIZE × 16）が残り全てを受け持つ。
+///   | 段 | 分割サイズ | 受け持つIR範囲（BLOCK_SIZE=96の場合） |
+///   | 0  | 96         | 0 〜 383                            |
+///   | 1  | 192        | 384 〜 767                          |
+///   | 2  | 384        | 768 〜 1535                         |
+///   | 3  | 768        | 1536 〜 3071                        |
+///   | 4  | 1536       | 3072 〜                             |
+class satoh::NonUniformConvolver
+{
+  /// @brief コピーコンストラクタ削除
+  NonUniformConvolver(NonUniformConvolver const &) = delete;
+  /// @brief 代入演算子削除
+  NonUniformConvolver &operator=(NonUniformConvolver const &) = delete;
+
+  static constexpr uint32_t HEAD_COUNT = 4; ///< 先頭の均一分割数
+
+  /// @brief 入力履歴（リングバッファ）
+  class History
+  {
+    UniquePtr<float> buf_; ///< バッファ
+    uint32_t size_;        ///< バッファサイズ
+    uint32_t wpos_;        ///< 書き込み位置
+
+  public:
+    /// @brief コンストラクタ @param [in] size 保持サンプル数
+    explicit History(uint32_t size) noexcept : buf_(allocArray<float>(size)), size_(size), wpos_(0) { clear(); }
+    /// @brief メモリ確保成功・失敗を取得
+    explicit operator bool() const noexcept { return static_cast<bool>(buf_); }
+    /// @brief クリア
+    void clear() noexcept
+    {
+      if (buf_)
+      {
+        memset(buf_.get(), 0, size_ * sizeof(float));
+      }
+      wpos_ = 0;
+    }
+    /// @brief 1ブロック分書き込む @param [in] src 入力音声（BLOCK_SIZE要素）
+    void write(float const *src) noexcept
+    {
+      uint32_t n = std::min(BLOCK_SIZE, size_ - wpos_);
+      memcpy(buf_.get() + wpos_, src, n * sizeof(float));
+      memcpy(buf_.get(), src + n, (BLOCK_SIZE - n) * sizeof(float));
+      wpos_ = (wpos_ + BLOCK_SIZE) % size_;
+    }
+    /// @brief 過去の入力を取得する
+    /// @param [out] dst 取得先
+    /// @param [in] n 取得サンプル数
+    /// @param [in] back 最新から何サンプル前を終端とするか
+    void copy(float *dst, uint32_t n, uint32_t back) const noexcept
+    {
+      uint32_t rpos = (wpos_ + size_ * 2 - back - n) % size_;
+      uint32_t m = std::min(n, size_ - rpos);
+      memcpy(dst, buf_.get() + rpos, m * sizeof(float));
+      memcpy(dst + m, buf_.get(), (n - m) * sizeof(float));
+    }
+  };
+
+  using Level1 = ConvLevel<BLOCK_SIZE * 2>;  ///< 1段目
+  using Level2 = ConvLevel<BLOCK_SIZE * 4>;  ///< 2段目
+  using Level3 = ConvLevel<BLOCK_SIZE * 8>;  ///< 3段目
+  using Level4 = ConvLevel<BLOCK_SIZE * 16>; ///< 最終段
+  static_assert(HEAD_COUNT * BLOCK_SIZE == Level1::DELAY, "level 0 must end at level 1 delay");
+  static_assert(Level3::HISTORY_SIZE <= Level4::HISTORY_SIZE, "history is too short");
+
+  uint32_t len_;          ///< IR最大長
+  UniformConvolver head_; ///< 0段目
+  UniquePtr<float> spec_; ///< 0段目のIRスペクトル
+  History hist_;          ///< 入力履歴
+  Level1 l1_;             ///< 1段目
+  Level2 l2_;             ///< 2段目
+  Level3 l3_;             ///< 3段目
+  Level4 l4_;             ///< 最終段
+  uint32_t blockCnt_;     ///< ブロックカウンタ（各段のスライス番号計算用）
+
+public:
+  /// @brief コンストラクタ
+  /// @param [in] maxLen IR最大長（サンプル数）
+  explicit NonUniformConvolver(uint32_t maxLen) noexcept                       //
+      : len_(maxLen),                                                          //
+        head_(std::min(HEAD_COUNT, UniformConvolver::partitionCount(maxLen))), //
+        spec_(allocArray<float>(HEAD_COUNT * UniformConvolver::FFT_SIZE)),     //
+        hist_(Level4::HISTORY_SIZE),                                           //
+        l1_(Level1::partitionCount(maxLen, 2)),                                //
+        l2_(Level2::partitionCount(maxLen, 2)),                                //
+        l3_(Level3::partitionCount(maxLen, 2)),                                //
+        l4_(Level4::partitionCount(maxLen, 0)),                                //
+        blockCnt_(0)                                                           //
+  {
+  }
+  /// @brief デストラクタ
+  virtual ~NonUniformConvolver() {}
+  /// @brief メモリ確保成功・失敗を取得
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return head_ && spec_ && hist_ && l1_ && l2_ && l3_ && l4_; }
+  /// @brief 内部状態をクリアする
+  void clear() noexcept
+  {
+    head_.clear();
+    hist_.clear();
+    l1_.clear();
+    l2_.clear();
+    l3_.clear();
+    l4_.clear();
+    blockCnt_ = 0;
+  }
+  /// @brief IRを設定する（音声処理と並行して呼ばないこと）
+  /// @param [in] ir インパルス応答
+  /// @param [in] len IR長（サンプル数 最大長を超えた分は無視する）
+  void setIr(float const *ir, uint32_t len) noexcept
+  {
+    len = std::min(len, len_);
+    memset(spec_.get(), 0, HEAD_COUNT * UniformConvolver::FFT_SIZE * sizeof(float));
+    head_.makeSpectrum(ir, std::min(len, HEAD_COUNT * BLOCK_SIZE), spec_.get());
+    l1_.setIr(ir, len);
+    l2_.setIr(ir, len);
+    l3_.setIr(ir, len);
+    l4_.setIr(ir, len);
+  }
+  /// @brief 畳み込み処理
+  /// @param [in] in 入力音声（BLOCK_SIZE要素）
+  /// @param [out] out 出力音声（BLOCK_SIZE要素 inと同じ領域でも可）
+  void process(float const *in, float *out) noexcept
+  {
+    hist_.write(in);
+    head_.process(in, out, spec_.get(), HEAD_COUNT);
+    l1_.process(hist_, blockCnt_ % Level1::SLICE, out);
+    l2_.process(hist_, blockCnt_ % Level2::SLICE, out);
+    l3_.process(hist_, blockCnt_ % Level3::SLICE, out);
+    l4_.process(hist_, blockCnt_ % Level4::SLICE, out);
+    blockCnt_ = (blockCnt_ + 1) % Level4::SLICE;
+  }
+};
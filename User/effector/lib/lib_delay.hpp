@@ -55,11 +55,12 @@ public:
   delayBuf() noexcept : maxSize_(0), interval_(1), wpos_(0) {}
   /// @brief コンストラクタ
   /// @param [in] maxTime 最大保持時間（ミリ秒）
-  explicit delayBuf(float maxTime) noexcept //
-      : maxSize_(getBufferSize(maxTime)),   //
-        interval_(1),                       //
-        buf_(allocArray<T>(maxSize_)),      //
-        wpos_(0)                            //
+  /// @param [in] tag バッファの置き場所（短く、サンプル毎に何度も読むバッファは DTCM を指定する）
+  explicit delayBuf(float maxTime, MemTag tag = MemTag::NORMAL) noexcept //
+      : maxSize_(getBufferSize(maxTime)),                                //
+        interval_(1),                                                    //
+        buf_(allocArray<T>(maxSize_, tag)),                              //
+        wpos_(0)                                                         //
   {
     memset(buf_.get(), 0, maxSize_ * sizeof(T));
   }
@@ -93,6 +94,16 @@ public:
     float t = rpos - rpos0;
     return (1 - t) * getFloat(rpos0) + t * getFloat(rpos1);
   }
+  /// @brief 指定したインターバルで線形補間して読み出し（1つのバッファから複数の位置を読む時に利用）
+  /// @param [in] interval 書込位置と読出位置の間隔（サンプル数 1 ～ バッファ最大要素数 - 1）
+  float readLerpAt(float interval) const noexcept
+  {
+    float rpos = interval <= wpos_ ? wpos_ - interval : wpos_ + maxSize_ - interval;
+    uint32_t rpos0 = static_cast<uint32_t>(rpos);
+    uint32_t rpos1 = rpos0 + 1 < maxSize_ ? rpos0 + 1 : 0;
+    float t = rpos - rpos0;
+    return (1 - t) * getFloat(rpos0) + t * getFloat(rpos1);
+  }
   /// @brief 固定時間（最大ディレイタイム）で読み出し
   float readFixed() const noexcept { return getFloat(wpos_); }
 };
@@ -7,7 +7,7 @@
 #pragma once
 
 #include "common/dma_mem.h"
-#include "common/little_endian.hpp"
+#include "common/big_endian.hpp"
 #include "constant.h"
 #include "lib_float.hpp"
 #include "peripheral/spi_master.h"
@@ -62,7 +62,7 @@ class satoh::delaySpiBuf
       return true;
     }
     uint8_t *t = txbuf_.get();
-    LE<uint32_t>::set(t, pos * sizeof(T));
+    BE<uint32_t>::set(t, pos * sizeof(T)); // アドレスは上位バイトから送る
     t[0] = CMD_WRITE;
     T *p = reinterpret_cast<T *>(t + HEADER_SIZE);
     for (size_t i = 0; i < size; ++i)
@@ -88,7 +88,7 @@ class satoh::delaySpiBuf
     uint8_t *r = rxbuf_.get();
     memset(t, 0, cmdSize);
     memset(r, 0, cmdSize);
-    LE<uint32_t>::set(t, pos * sizeof(T));
+    BE<uint32_t>::set(t, pos * sizeof(T)); // アドレスは上位バイトから送る
     t[0] = CMD_READ;
     if (spi_->sendRecv(t, r, cmdSize) != SpiMaster::OK)
     {
@@ -0,0 +1,118 @@
+/// @file      effector/lib/lib_env.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "constant.h"
+#include "lib_calc.hpp"
+#include <cmath>
+
+namespace satoh
+{
+class EnvelopeFollower;
+} // namespace satoh
+
+/// @brief エンベロープ検出
+/// @note 入力の絶対値（PEAK）または2乗（RMS）を、上昇時はアタック、下降時はリリースの時定数で平滑化する。
+///   係数は時定数の設定時に計算しておくので、サンプル毎の処理は比較と積和のみ。
+///   上昇・下降で係数を選ぶだけなので、係数の切り替わりで出力が不連続になることはない。
+class satoh::EnvelopeFollower
+{
+public:
+  /// @brief 検出方式
+  enum Mode
+  {
+    PEAK, ///< ピーク（絶対値）
+    RMS,  ///< 実効値（2乗平均）
+  };
+
+private:
+  Mode mode_;     ///< 検出方式
+  float attack_;  ///< アタック係数
+  float release_; ///< リリース係数
+  float y_;       ///< 平滑化後の値（PEAKは絶対値、RMSは2乗）
+
+  /// @brief 時定数から1次平滑化の係数を求める
+  /// @param [in] ms 時定数（ミリ秒）
+  /// @return 係数（0は平滑化なし）
+  static float coef(float ms) noexcept { return 0.0f < ms ? std::exp(-1000.0f / (ms * SAMPLING_FREQ)) : 0.0f; }
+  /// @brief 1サンプル平滑化する
+  /// @param [in] x 入力
+  /// @return 平滑化後の値（PEAKは絶対値、RMSは2乗）
+  float smooth(float x) noexcept
+  {
+    x = mode_ == PEAK ? std::abs(x) : x * x;
+    const float a = y_ < x ? attack_ : release_;
+    y_ = x + a * (y_ - x);
+    return y_;
+  }
+
+public:
+  /// @brief コンストラクタ
+  /// @param [in] mode 検出方式
+  /// @param [in] attackMs アタック時定数（ミリ秒）
+  /// @param [in] releaseMs リリース時定数（ミリ秒）
+  explicit EnvelopeFollower(Mode mode = PEAK, float attackMs = 10.0f, float releaseMs = 100.0f) noexcept //
+      : mode_(mode),                                                                                  //
+        attack_(coef(attackMs)),                                                                      //
+        release_(coef(releaseMs)),                                                                    //
+        y_(0)                                                                                         //
+  {
+  }
+  /// @brief 検出方式を設定する @param [in] mode 検出方式
+  void setMode(Mode mode) noexcept
+  {
+    if (mode_ != mode)
+    {
+      mode_ = mode;
+      y_ = 0;
+    }
+  }
+  /// @brief アタック時定数を設定する @param [in] ms 時定数（ミリ秒）
+  void setAttack(float ms) noexcept { attack_ = coef(ms); }
+  /// @brief リリース時定数を設定する @param [in] ms 時定数（ミリ秒）
+  void setRelease(float ms) noexcept { release_ = coef(ms); }
+  /// @brief 内部状態を初期化する
+  void reset() noexcept { y_ = 0; }
+  /// @brief エンベロープを求める
+  /// @param [in] in 入力
+  /// @param [out] out エンベロープ（振幅 inと同じ領域でも可）
+  /// @param [in] size データ数
+  void process(float const *in, float *out, uint32_t size) noexcept
+  {
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      out[i] = smooth(in[i]);
+    }
+    if (mode_ == RMS)
+    {
+      for (uint32_t i = 0; i < size; ++i)
+      {
+        out[i] = std::sqrt(out[i]);
+      }
+    }
+  }
+  /// @brief エンベロープをdBで求める
+  /// @param [in] in 入力
+  /// @param [out] out エンベロープ（dB inと同じ領域でも可）
+  /// @param [in] size データ数
+  /// @note RMSは2乗のまま対数を取り、平方根の計算を省く。
+  void processDb(float const *in, float *out, uint32_t size) noexcept
+  {
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      out[i] = smooth(in[i]);
+    }
+    gainToDb(out, out, size);
+    if (mode_ == RMS)
+    {
+      for (uint32_t i = 0; i < size; ++i)
+      {
+        out[i] *= 0.5f;
+      }
+    }
+  }
+};
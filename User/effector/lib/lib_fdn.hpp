@@ -0,0 +1,214 @@
+/// @file      effector/lib/lib_fdn.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "common/alloc.hpp"
+#include "constant.h"
+#include "lib_calc.hpp"
+#include "lib_filter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring> // memset, memcpy
+
+namespace satoh
+{
+template <uint32_t N>
+class Fdn;
+} // namespace satoh
+
+/// @brief フィードバックディレイネットワーク（FDN）
+/// @tparam N ディレイライン数（2のべき乗）
+/// @note ブロック単位で処理する。
+///   各ディレイラインの遅延は常にブロックサイズ以上なので、1ブロック分の出力は前回までの書き込みだけで決まる。
+///   そのため「全ラインを1ブロック分読む → 減衰・ダンピング → アダマール行列で混合 → 全ラインへ1ブロック分書く」
+///   の順に、ライン毎の連続したバッファに対してループを回せる。
+template <uint32_t N>
+class satoh::Fdn
+{
+  static_assert(2 <= N && (N & (N - 1)) == 0, "N must be power of 2");
+
+  /// @brief コピーコンストラクタ削除
+  Fdn(Fdn const &) = delete;
+  /// @brief 代入演算子削除
+  Fdn &operator=(Fdn const &) = delete;
+
+  UniquePtr<float> buf_;     ///< 全ディレイラインのバッファ（ライン毎に連続して配置）
+  uint32_t ofs_[N];          ///< 各ラインのバッファ先頭位置
+  uint32_t maxLen_[N];       ///< 各ラインのバッファ長（最大遅延サンプル数）
+  uint32_t len_[N];          ///< 各ラインの遅延サンプル数
+  uint32_t wpos_[N];         ///< 各ラインの書き込み位置
+  float gain_[N];            ///< 各ラインの減衰率（アダマール行列の正規化係数込み）
+  float damp_[N];            ///< 各ラインのダンピングフィルタ状態
+  float dampA_;              ///< ダンピングフィルタ係数
+  float dampB_;              ///< ダンピングフィルタ係数
+  float decay_;              ///< 残響時間（秒）
+  float blk_[N][BLOCK_SIZE]; ///< 1ブロック分の作業領域
+
+  /// @brief 減衰率を再計算する
+  void updateGain() noexcept
+  {
+    const float norm = 1.0f / std::sqrt(static_cast<float>(N));
+    for (uint32_t k = 0; k < N; ++k)
+    {
+      // 1周で -60dB * len / (T60 * fs) 減衰させる
+      float db = -60.0f * len_[k] / (decay_ * SAMPLING_FREQ);
+      gain_[k] = norm * dbToGain(db);
+    }
+  }
+  /// @brief ディレイラインから1ブロック分読み出す
+  /// @param [in] k ライン番号
+  /// @param [out] dst 読み出し先
+  /// @param [in] size 読み出しサンプル数
+  void readLine(uint32_t k, float *dst, uint32_t size) const noexcept
+  {
+    const float *line = buf_.get() + ofs_[k];
+    uint32_t rpos = wpos_[k] + maxLen_[k] - len_[k];
+    if (maxLen_[k] <= rpos)
+    {
+      rpos -= maxLen_[k];
+    }
+    uint32_t n = std::min(size, maxLen_[k] - rpos);
+    memcpy(dst, line + rpos, n * sizeof(float));
+    memcpy(dst + n, line, (size - n) * sizeof(float));
+  }
+  /// @brief ディレイラインへ1ブロック分書き込む
+  /// @param [in] k ライン番号
+  /// @param [in] src 書き込むデータ
+  /// @param [in] size 書き込みサンプル数
+  void writeLine(uint32_t k, float const *src, uint32_t size) noexcept
+  {
+    float *line = buf_.get() + ofs_[k];
+    uint32_t n = std::min(size, maxLen_[k] - wpos_[k]);
+    memcpy(line + wpos_[k], src, n * sizeof(float));
+    memcpy(line, src + n, (size - n) * sizeof(float));
+    wpos_[k] = (wpos_[k] + size) % maxLen_[k];
+  }
+
+public:
+  /// @brief コンストラクタ
+  /// @param [in] maxLen 各ラインの最大遅延サンプル数（BLOCK_SIZEより大きいこと）
+  explicit Fdn(uint32_t const (&maxLen)[N]) noexcept //
+      : dampA_(0), dampB_(1), decay_(1)
+  {
+    uint32_t total = 0;
+    for (uint32_t k = 0; k < N; ++k)
+    {
+      ofs_[k] = total;
+      maxLen_[k] = std::max(maxLen[k], BLOCK_SIZE);
+      len_[k] = maxLen_[k];
+      wpos_[k] = 0;
+      damp_[k] = 0;
+      total += maxLen_[k];
+    }
+    buf_ = UniquePtr<float>(allocArray<float>(total));
+    if (buf_)
+    {
+      memset(buf_.get(), 0, total * sizeof(float));
+    }
+    updateGain();
+  }
+  /// @brief デストラクタ
+  virtual ~Fdn() {}
+  /// @brief メモリ確保成功・失敗を取得
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return static_cast<bool>(buf_); }
+  /// @brief 残響時間を設定する
+  /// @param [in] sec 残響時間（-60dBまで減衰する時間 秒）
+  void setDecay(float sec) noexcept
+  {
+    decay_ = std::max(0.1f, sec);
+    updateGain();
+  }
+  /// @brief 部屋の大きさを設定する
+  /// @param [in] ratio 最大遅延サンプル数に対する比率（0.0f 〜 1.0f）
+  void setSize(float ratio) noexcept
+  {
+    for (uint32_t k = 0; k < N; ++k)
+    {
+      uint32_t len = static_cast<uint32_t>(maxLen_[k] * ratio);
+      len_[k] = std::min(maxLen_[k], std::max(len, BLOCK_SIZE));
+    }
+    updateGain();
+  }
+  /// @brief ダンピング（帰還音のハイカット）周波数を設定する
+  /// @param [in] fc カットオフ周波数
+  void setDamp(float fc) noexcept
+  {
+    dampA_ = lpfCoef(fc);
+    dampB_ = 1.0f - dampA_;
+  }
+  /// @brief 残響処理
+  /// @param [in] in 入力音声
+  /// @param [out] outL L残響音
+  /// @param [out] outR R残響音
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
+  void process(float const *in, float *outL, float *outR, uint32_t size) noexcept
+  {
+    // 読み出し・ダンピング・減衰
+    for (uint32_t k = 0; k < N; ++k)
+    {
+      float *b = blk_[k];
+      readLine(k, b, size);
+      const float a = dampA_;
+      const float c = dampB_ * gain_[k];
+      float z = damp_[k];
+      for (uint32_t i = 0; i < size; ++i)
+      {
+        z = c * b[i] + a * z;
+        b[i] = z;
+      }
+      damp_[k] = z;
+    }
+    // 偶数ラインをL、奇数ラインをRへ出力
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      outL[i] = 0;
+      outR[i] = 0;
+    }
+    for (uint32_t k = 0; k < N; k += 2)
+    {
+      float const *l = blk_[k];
+      float const *r = blk_[k + 1];
+      for (uint32_t i = 0; i < size; ++i)
+      {
+        outL[i] += l[i];
+        outR[i] += r[i];
+      }
+    }
+    // アダマール行列で混合（正規化係数はgain_に含めている）
+    for (uint32_t h = 1; h < N; h *= 2)
+    {
+      for (uint32_t j = 0; j < N; j += h * 2)
+      {
+        for (uint32_t k = j; k < j + h; ++k)
+        {
+          float *x = blk_[k];
+          float *y = blk_[k + h];
+          for (uint32_t i = 0; i < size; ++i)
+          {
+            float a = x[i];
+            float b = y[i];
+            x[i] = a + b;
+            y[i] = a - b;
+          }
+        }
+      }
+    }
+    // 入力を加えて書き込み
+    for (uint32_t k = 0; k < N; ++k)
+    {
+      float *b = blk_[k];
+      const float sign = (k & 1) ? -1.0f : 1.0f;
+      for (uint32_t i = 0; i < size; ++i)
+      {
+        b[i] += sign * in[i];
+      }
+      writeLine(k, b, size);
+    }
+  }
+};
@@ -0,0 +1,276 @@
+/// @file      effector/lib/lib_fft.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring> // memcpy
+
+namespace satoh
+{
+namespace fft
+{
+constexpr uint32_t MIN_SIZE = 64;   ///< 最小FFTサイズ
+constexpr uint32_t MAX_SIZE = 4096; ///< 最大FFTサイズ
+template <typename T = void>
+struct Twiddle;
+} // namespace fft
+template <uint32_t N>
+class RealFft;
+} // namespace satoh
+
+/// @brief 回転因子テーブル（コンパイル時に計算し、フラッシュに配置する）
+/// @note sin(2πm / MAX_SIZE) を m = 0 〜 MAX_SIZE × 5/4 の範囲で保持し、cos は 1/4 周期ずらして参照する。
+///   どのサイズのFFTもこの1つのテーブルを間引いて使う。
+///   テンプレートにしているのは、ヘッダーのみで static constexpr メンバーを定義するため。
+template <typename T>
+struct satoh::fft::Twiddle
+{
+  static constexpr uint32_t QUARTER = MAX_SIZE / 4;    ///< 1/4周期の要素数
+  static constexpr uint32_t SIZE = MAX_SIZE + QUARTER; ///< テーブル要素数
+  static constexpr double PI_2 = 1.5707963267948966;   ///< π/2
+
+  /// @brief テーブル本体
+  struct Table
+  {
+    float v[SIZE]; ///< sin値
+    /// @brief コンストラクタ（コンパイル時計算）
+    constexpr Table() : v{}
+    {
+      for (uint32_t m = 0; m < SIZE; ++m)
+      {
+        // 第1象限へ折り返してからテイラー展開
+        uint32_t q = (m / QUARTER) % 4;
+        uint32_t r = m % QUARTER;
+        double x = PI_2 * ((q & 1) ? QUARTER - r : r) / QUARTER;
+        double s = 0;
+        double t = x;
+        for (uint32_t n = 1; n < 30; n += 2)
+        {
+          s += t;
+          t *= -x * x / ((n + 1) * (n + 2));
+        }
+        v[m] = static_cast<float>(q < 2 ? s : -s);
+      }
+    }
+  };
+  static constexpr Table table{}; ///< テーブル
+
+  /// @brief sin(2πm / MAX_SIZE) @param [in] m 0 〜 MAX_SIZE-1 @return sin値
+  static float sin(uint32_t m) noexcept { return table.v[m]; }
+  /// @brief cos(2πm / MAX_SIZE) @param [in] m 0 〜 MAX_SIZE-1 @return cos値
+  static float cos(uint32_t m) noexcept { return table.v[m + QUARTER]; }
+};
+
+template <typename T>
+constexpr typename satoh::fft::Twiddle<T>::Table satoh::fft::Twiddle<T>::table;
+
+/// @brief 実数FFT
+/// @tparam N FFTサイズ（fft::MIN_SIZE 〜 fft::MAX_SIZE の2のべき乗）
+/// @note N/2点の複素FFT（基数4 + 必要なら基数2を1段）で計算し、結果を分離して実数N点のスペクトルを得る。
+///   内部状態を持たないので、複数箇所から同時に使ってよい。
+///   スペクトルは以下の形式でN個のfloatに格納する。
+///   - [0] : X[0] 実部（虚部は常に0）
+///   - [1] : X[N/2] 実部（虚部は常に0）
+///   - [2k], [2k+1] : X[k] 実部, 虚部（k = 1 〜 N/2-1）
+template <uint32_t N>
+class satoh::RealFft
+{
+  static_assert(fft::MIN_SIZE <= N && N <= fft::MAX_SIZE && (N & (N - 1)) == 0, "N must be power of 2 (64 - 4096)");
+
+  using TW = fft::Twiddle<>;                          ///< 回転因子
+  static constexpr uint32_t M = N / 2;                ///< 複素FFTサイズ
+  static constexpr uint32_t STEP = fft::MAX_SIZE / N; ///< N点の回転因子1つ分のテーブル間隔
+
+  /// @brief log2(n) @param [in] n 2のべき乗 @return log2(n)
+  static constexpr uint32_t log2(uint32_t n) noexcept { return n <= 1 ? 0 : 1 + log2(n / 2); }
+
+  /// @brief ビット反転並べ替え
+  /// @param [inout] z 複素数配列（実部・虚部の交互 M要素）
+  static void bitReverse(float *z) noexcept
+  {
+    uint32_t j = 0;
+    for (uint32_t i = 0; i < M; ++i)
+    {
+      if (i < j)
+      {
+        float r = z[i * 2];
+        float m = z[i * 2 + 1];
+        z[i * 2] = z[j * 2];
+        z[i * 2 + 1] = z[j * 2 + 1];
+        z[j * 2] = r;
+        z[j * 2 + 1] = m;
+      }
+      uint32_t bit = M >> 1;
+      while (j & bit)
+      {
+        j ^= bit;
+        bit >>= 1;
+      }
+      j |= bit;
+    }
+  }
+  /// @brief 複素FFT（インプレース 時間間引き）
+  /// @tparam INV true:逆変換 false:順変換（スケーリングはしない）
+  /// @param [inout] z 複素数配列（実部・虚部の交互 M要素）
+  /// @note 基数2の2段分をまとめて基数4の1段として計算する（複素乗算が4回から3回に減る）。
+  ///   段数が奇数の場合は、最初に回転因子の無い基数2の段を1つ入れる。
+  template <bool INV>
+  static void complexFft(float *z) noexcept
+  {
+    constexpr float sign = INV ? 1.0f : -1.0f;
+    bitReverse(z);
+    uint32_t q = 1;
+    if (log2(M) & 1)
+    {
+      for (uint32_t i = 0; i < M * 2; i += 4)
+      {
+        float ar = z[i];
+        float ai = z[i + 1];
+        z[i] = ar + z[i + 2];
+        z[i + 1] = ai + z[i + 3];
+        z[i + 2] = ar - z[i + 2];
+        z[i + 3] = ai - z[i + 3];
+      }
+      q = 2;
+    }
+    for (; q * 4 <= M; q *= 4)
+    {
+      const uint32_t step = fft::MAX_SIZE / (q * 4); // W_{4q}^j のテーブル間隔
+      for (uint32_t j = 0; j < q; ++j)
+      {
+        const float w1r = TW::cos(j * step);
+        const float w1i = sign * TW::sin(j * step);
+        const float w2r = TW::cos(j * step * 2);
+        const float w2i = sign * TW::sin(j * step * 2);
+        const float w3r = TW::cos(j * step * 3);
+        const float w3i = sign * TW::sin(j * step * 3);
+        for (uint32_t i = j; i < M; i += q * 4)
+        {
+          float *x0 = z + i * 2;
+          float *x1 = z + (i + q) * 2;
+          float *x2 = z + (i + q * 2) * 2;
+          float *x3 = z + (i + q * 3) * 2;
+          // t = W^2j * x1, u = W^j * x2, v = W^3j * x3
+          float tr = x1[0] * w2r - x1[1] * w2i;
+          float ti = x1[0] * w2i + x1[1] * w2r;
+          float ur = x2[0] * w1r - x2[1] * w1i;
+          float ui = x2[0] * w1i + x2[1] * w1r;
+          float vr = x3[0] * w3r - x3[1] * w3i;
+          float vi = x3[0] * w3i + x3[1] * w3r;
+          float a0r = x0[0] + tr;
+          float a0i = x0[1] + ti;
+          float a1r = x0[0] - tr;
+          float a1i = x0[1] - ti;
+          float sr = ur + vr;
+          float si = ui + vi;
+          // d = ±i(u - v)（順変換は -i）
+          float dr = -sign * (ui - vi);
+          float di = sign * (ur - vr);
+          x0[0] = a0r + sr;
+          x0[1] = a0i + si;
+          x2[0] = a0r - sr;
+          x2[1] = a0i - si;
+          x1[0] = a1r + dr;
+          x1[1] = a1i + di;
+          x3[0] = a1r - dr;
+          x3[1] = a1i - di;
+        }
+      }
+    }
+  }
+
+public:
+  /// @brief FFTサイズ取得 @return FFTサイズ
+  static constexpr uint32_t size() noexcept { return N; }
+  /// @brief 順変換
+  /// @param [in] in 実数入力（N要素）
+  /// @param [out] out スペクトル出力（N要素 inと同じ領域でも可）
+  void forward(float const *in, float *out) const noexcept
+  {
+    if (in != out)
+    {
+      memcpy(out, in, N * sizeof(float));
+    }
+    complexFft<false>(out);
+    float r0 = out[0];
+    float i0 = out[1];
+    out[0] = r0 + i0;
+    out[1] = r0 - i0;
+    for (uint32_t k = 1; k <= M / 2; ++k)
+    {
+      float *x = out + k * 2;
+      float *y = out + (M - k) * 2;
+      float c = TW::cos(k * STEP);
+      float s = TW::sin(k * STEP);
+      float er = 0.5f * (x[0] + y[0]);
+      float ei = 0.5f * (x[1] - y[1]);
+      float or_ = 0.5f * (x[1] + y[1]);
+      float oi = -0.5f * (x[0] - y[0]);
+      float tr = c * or_ + s * oi;
+      float ti = c * oi - s * or_;
+      x[0] = er + tr;
+      x[1] = ei + ti;
+      y[0] = er - tr;
+      y[1] = ti - ei;
+    }
+  }
+  /// @brief 逆変換（1/Nのスケーリング込み）
+  /// @param [in] in スペクトル入力（N要素）
+  /// @param [out] out 実数出力（N要素 inと同じ領域でも可）
+  void inverse(float const *in, float *out) const noexcept
+  {
+    if (in != out)
+    {
+      memcpy(out, in, N * sizeof(float));
+    }
+    float x0 = out[0];
+    float xn = out[1];
+    out[0] = x0 + xn;
+    out[1] = x0 - xn;
+    for (uint32_t k = 1; k <= M / 2; ++k)
+    {
+      float *x = out + k * 2;
+      float *y = out + (M - k) * 2;
+      float c = TW::cos(k * STEP);
+      float s = TW::sin(k * STEP);
+      float er = x[0] + y[0];
+      float ei = x[1] - y[1];
+      float dr = x[0] - y[0];
+      float di = x[1] + y[1];
+      float or_ = dr * c - di * s;
+      float oi = dr * s + di * c;
+      x[0] = er - oi;
+      x[1] = ei + or_;
+      y[0] = er + oi;
+      y[1] = or_ - ei;
+    }
+    complexFft<true>(out);
+    const float scale = 1.0f / N;
+    for (uint32_t i = 0; i < N; ++i)
+    {
+      out[i] *= scale;
+    }
+  }
+  /// @brief スペクトルの積を加算する（acc += a * b）
+  /// @param [in] a スペクトル
+  /// @param [in] b スペクトル
+  /// @param [inout] acc 加算先スペクトル
+  static void multiplyAdd(float const *a, float const *b, float *acc) noexcept
+  {
+    acc[0] += a[0] * b[0];
+    acc[1] += a[1] * b[1];
+    for (uint32_t i = 2; i < N; i += 2)
+    {
+      float ar = a[i];
+      float ai = a[i + 1];
+      float br = b[i];
+      float bi = b[i + 1];
+      acc[i] += ar * br - ai * bi;
+      acc[i + 1] += ar * bi + ai * br;
+    }
+  }
+};
@@ -16,6 +16,12 @@ inline float lpfCoef(float fc)
   return 0.99983075f - 0.99678388f * w + 0.49528899f * w * w - 0.10168296f * w * w * w;
 }
 
+/* 1次フィルタの減衰時間のサンプル数（db: 減衰量 後段のゲイン分を足して指定する） -----------------------------*/
+inline uint32_t iirTail(float fc, float db = 120.0f)
+{
+  return static_cast<uint32_t>(0.115129255f * db / omega(fc)); // ln(10)/20 × dB × 時定数
+}
+
 /* 1次 Low Pass Filter ----------------------------------------------------------*/
 class lpf
 {
@@ -33,6 +39,8 @@ public:
     b0 = 1.0f - a1;
   }
 
+  void reset(float x = 0) { y1 = x; } // 一定値 x を入力し続けた状態にする
+
   float process(float x)
   {
     float y = b0 * x + a1 * y1;
@@ -58,9 +66,15 @@ public:
     b0 = 0.5f * (1.0f + a1);
   }
 
+  void reset(float x = 0) // 一定値 x を入力し続けた状態にする
+  {
+    x1 = x;
+    y1 = 0;
+  }
+
   float process(float x)
   {
-    float y = b0 * x - b0 * x1 + a1 * y1;
+    float y = b0 * (x - x1) + a1 * y1;
     x1 = x;
     y1 = y;
     return y;
@@ -80,6 +94,12 @@ public:
 
   void set(float fc) { a = lpfCoef(fc); }
 
+  void reset(float x = 0) // 一定値 x を入力し続けた状態にする
+  {
+    x1 = x;
+    y1 = x;
+  }
+
   float process(float x)
   {
     float y = -a * x + x1 + a * y1;
@@ -106,6 +126,12 @@ public:
     b = 1.0f - a;
   }
 
+  void reset(float x = 0) // 一定値 x を入力し続けた状態にする
+  {
+    y1 = x;
+    y2 = x;
+  }
+
   float process(float x)
   {
     float y = b * b * x + 2.0f * a * y1 - a * a * y2;
@@ -132,6 +158,14 @@ public:
     c = 0.5f * (1.0f + a);
   }
 
+  void reset(float x = 0) // 一定値 x を入力し続けた状態にする
+  {
+    x1 = x;
+    x2 = x;
+    y1 = 0;
+    y2 = 0;
+  }
+
   float process(float x)
   {
     float y = c * c * (x - 2.0f * x1 + x2) + 2.0 * a * y1 - a * a * y2;
@@ -202,6 +236,12 @@ inline float bqBeta(float gain, float q)
   return sqrtf(bqA(gain)) / q;
 }
 
+// BiQuadフィルタの減衰時間（-120dB）のサンプル数 Q > 0.5 は共振、Q < 0.5 は遅い方の実極で決まる
+inline uint32_t bqTail(float fc, float q)
+{
+  return static_cast<uint32_t>(13.8155106f * std::max(2.0f * q, 1.0f / q) / omega(fc));
+}
+
 enum BQFtype
 {
   OFF, // No Filter (default)
@@ -237,6 +277,11 @@ public:
     setCoef(type, fc, q_bw, gain);
   }
 
+  void reset() // 無音を入力し続けた状態にする
+  {
+    x1 = y1 = x2 = y2 = 0;
+  }
+
   float process(float x) // BiQuadフィルタ 実行
   {
     float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
@@ -0,0 +1,255 @@
+/// @file      effector/lib/lib_lfo.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "constant.h"
+#include "lib_tempo.hpp"
+#include <cmath>   // sin, cos
+#include <cstdint>
+
+namespace satoh
+{
+class LfoPool;
+} // namespace satoh
+
+/// @brief LFO プール（エフェクター間で共有する LFO をブロック毎に1回だけ計算する）
+/// @note 音声タスクが1つだけ持ち、エフェクター処理の前に update() で全 LFO の1ブロック分の波形を作る。
+///   エフェクターは波形・周波数・位相のずれが同じ LFO を共有し、get() で波形のバッファを受け取る。
+///   周波数が同じ LFO は同じ位相で進むので、位相のずれを指定すればチェーン全体で揃った揺れになる。
+///   購読の変更は音声タスク（エフェクト処理中）でのみ行うので、排他は要らない。
+class satoh::LfoPool
+{
+public:
+  /// @brief 波形
+  enum Shape : uint8_t
+  {
+    SIN = 0,  ///< 正弦波（-1 ～ 1）
+    TRIANGLE, ///< 三角波（0 ～ 1）
+  };
+  /// @brief 購読情報（エフェクターが持つ）
+  struct Handle
+  {
+    uint8_t index; ///< LFO番号
+    uint32_t gen;  ///< 購読時の世代（clear() で無効になる）
+  };
+
+private:
+  static constexpr uint32_t SLOT_COUNT = 6; ///< LFO の最大数（同時に動くエフェクター数 + 切り替え用）
+
+  /// @brief LFO
+  struct Slot
+  {
+    Shape shape;           ///< 波形
+    uint8_t div;           ///< テンポ同期（音符の長さ TempoClock::OFF は同期しない）
+    uint8_t users;         ///< 購読しているエフェクター数
+    float freq;            ///< 周波数（テンポ同期中は未使用）
+    float offset;          ///< 位相のずれ（0 ～ 1）
+    float phase;           ///< ブロック先頭の位相（ずれを含まない 0 ～ 1）
+    float next;            ///< 次のブロック先頭の位相
+    float buf[BLOCK_SIZE]; ///< 1ブロック分の波形
+  };
+
+  Slot slot_[SLOT_COUNT];   ///< LFO
+  TempoClock const *tempo_; ///< テンポクロック
+  uint32_t gen_;            ///< 世代
+  uint32_t size_;           ///< 現在のブロックの音声データ数
+
+  /// @brief 位相を 0 ～ 1 に丸める
+  /// @param [in] ph 位相（0以上）
+  /// @return 位相
+  static float wrap(float ph) noexcept { return ph - static_cast<float>(static_cast<uint32_t>(ph)); }
+  /// @brief 周波数を取得
+  /// @param [in] s LFO
+  /// @return 周波数
+  float getFreq(Slot const &s) const noexcept { return s.div != TempoClock::OFF && tempo_ ? tempo_->getFreq(s.div) : s.freq; }
+  /// @brief 現在のブロックの波形を作る
+  /// @param [inout] s LFO
+  void fill(Slot &s) noexcept
+  {
+    if (s.div != TempoClock::OFF && tempo_)
+    {
+      s.phase = tempo_->getPhase(s.div); // テンポ同期中は共有のテンポクロックの位相に合わせる
+    }
+    const float inc = getFreq(s) / SAMPLING_FREQ;
+    s.next = wrap(s.phase + inc * size_);
+    const float ph = wrap(s.phase + s.offset);
+    if (s.shape == SIN)
+    {
+      // 先頭の値から回転させて求める（sin・cos はブロック毎に2回ずつ）
+      const float c = std::cos(2.0f * PI * inc);
+      const float d = std::sin(2.0f * PI * inc);
+      float y = std::sin(2.0f * PI * ph);
+      float x = std::cos(2.0f * PI * ph);
+      for (uint32_t i = 0; i < size_; ++i)
+      {
+        s.buf[i] = y;
+        const float t = x * c - y * d;
+        y = y * c + x * d;
+        x = t;
+      }
+    }
+    else
+    {
+      float p = ph;
+      for (uint32_t i = 0; i < size_; ++i)
+      {
+        const float v = 2.0f * p;
+        s.buf[i] = v < 1.0f ? v : 2.0f - v;
+        p += inc;
+        p = p < 1.0f ? p : p - 1.0f;
+      }
+    }
+  }
+  /// @brief 同じ設定の LFO を探す
+  /// @param [in] shape 波形
+  /// @param [in] freq 周波数
+  /// @param [in] div テンポ同期
+  /// @param [in] offset 位相のずれ
+  /// @return LFO番号（見つからなければ SLOT_COUNT）
+  uint32_t find(Shape shape, float freq, uint8_t div, float offset) const noexcept
+  {
+    for (uint32_t n = 0; n < SLOT_COUNT; ++n)
+    {
+      Slot const &s = slot_[n];
+      if (0 < s.users && s.shape == shape && s.div == div && (div != TempoClock::OFF || s.freq == freq) && s.offset == offset)
+      {
+        return n;
+      }
+    }
+    return SLOT_COUNT;
+  }
+  /// @brief 新しい LFO を割り当てる
+  /// @param [in] shape 波形
+  /// @param [in] freq 周波数
+  /// @param [in] div テンポ同期
+  /// @param [in] offset 位相のずれ
+  /// @param [in] phase 位相（周波数が同じ LFO があればその位相に揃える）
+  /// @return LFO番号（空きがなければ SLOT_COUNT）
+  uint32_t assign(Shape shape, float freq, uint8_t div, float offset, float phase) noexcept
+  {
+    uint32_t n = 0;
+    for (; n < SLOT_COUNT && 0 < slot_[n].users; ++n)
+    {
+    }
+    if (n == SLOT_COUNT)
+    {
+      return n;
+    }
+    for (uint32_t m = 0; m < SLOT_COUNT; ++m)
+    {
+      Slot const &s = slot_[m];
+      if (0 < s.users && s.div == TempoClock::OFF && div == TempoClock::OFF && s.freq == freq)
+      {
+        phase = s.phase; // 周波数が同じなら位相を揃える（位相のずれだけ異なる揺れになる）
+        break;
+      }
+    }
+    Slot &s = slot_[n];
+    s.shape = shape;
+    s.div = div;
+    s.users = 0;
+    s.freq = freq;
+    s.offset = offset;
+    s.phase = phase;
+    fill(s);
+    return n;
+  }
+
+public:
+  /// @brief コンストラクタ
+  LfoPool() noexcept : slot_{}, tempo_(0), gen_(1), size_(BLOCK_SIZE) {}
+  /// @brief テンポクロックを設定する
+  /// @param [in] clock テンポクロック
+  void setTempoClock(TempoClock const *clock) noexcept { tempo_ = clock; }
+  /// @brief 全ての購読を解除する（エフェクターを切り替えた時に呼ぶ）
+  void clear() noexcept
+  {
+    for (auto &s : slot_)
+    {
+      s.users = 0;
+    }
+    ++gen_;
+  }
+  /// @brief 1ブロック分の波形を作る（音声タスクから、エフェクター処理の前に呼ぶ）
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
+  void update(uint32_t size) noexcept
+  {
+    size_ = size;
+    for (auto &s : slot_)
+    {
+      if (0 < s.users)
+      {
+        s.phase = s.next;
+        fill(s);
+      }
+    }
+  }
+  /// @brief LFO の現在のブロックの波形を取得する（必要なら購読を変更する）
+  /// @param [inout] h 購読情報
+  /// @param [in] shape 波形
+  /// @param [in] freq 周波数（テンポ同期中は未使用）
+  /// @param [in] div テンポ同期（音符の長さ TempoClock::OFF は同期しない）
+  /// @param [in] offset 位相のずれ（0 ～ 1）
+  /// @return 波形（update() で指定した音声データ数 LFO が足りなければ 0 の並び）
+  float const *get(Handle &h, Shape shape, float freq, uint8_t div, float offset) noexcept
+  {
+    const bool valid = h.gen == gen_ && h.index < SLOT_COUNT;
+    if (valid)
+    {
+      Slot &s = slot_[h.index];
+      if (s.shape == shape && s.div == div && (div != TempoClock::OFF || s.freq == freq) && s.offset == offset)
+      {
+        return s.buf;
+      }
+    }
+    uint32_t n = find(shape, freq, div, offset);
+    if (n == SLOT_COUNT && valid && slot_[h.index].users == 1 && slot_[h.index].shape == shape)
+    {
+      // 1人で使っている LFO は、位相を保ったまま設定を変える（ブロック先頭から作り直す）
+      Slot &s = slot_[h.index];
+      s.freq = freq;
+      s.div = div;
+      s.offset = offset;
+      fill(s);
+      return s.buf;
+    }
+    if (n == SLOT_COUNT)
+    {
+      n = assign(shape, freq, div, offset, valid ? slot_[h.index].phase : 0.0f); // 今の位相から引き継ぐ
+    }
+    if (valid)
+    {
+      --slot_[h.index].users;
+    }
+    h.gen = gen_;
+    h.index = static_cast<uint8_t>(n);
+    if (n == SLOT_COUNT)
+    {
+      static const float ZERO[BLOCK_SIZE] = {};
+      return ZERO;
+    }
+    ++slot_[n].users;
+    return slot_[n].buf;
+  }
+  /// @brief LFO の現在のブロックの波形を取得する（プールが未設定ならば 0 の並び）
+  /// @param [in] pool LFO プール
+  /// @param [inout] h 購読情報
+  /// @param [in] shape 波形
+  /// @param [in] freq 周波数（テンポ同期中は未使用）
+  /// @param [in] div テンポ同期（音符の長さ TempoClock::OFF は同期しない）
+  /// @param [in] offset 位相のずれ（0 ～ 1）
+  /// @return 波形
+  static float const *get(LfoPool *pool, Handle &h, Shape shape, float freq, uint8_t div, float offset) noexcept
+  {
+    if (!pool)
+    {
+      static const float ZERO[BLOCK_SIZE] = {};
+      return ZERO;
+    }
+    return pool->get(h, shape, freq, div, offset);
+  }
+};
@@ -0,0 +1,241 @@
+/// @file      effector/lib/lib_loop_sram.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "common/big_endian.hpp"
+#include "common/dma_mem.h"
+#include "common/spsc_ring.hpp"
+#include "constant.h"
+#include "lib_float.hpp"
+#include "peripheral/spi_master.h"
+#include <algorithm>
+#include <cstring> // memcpy, memset
+
+namespace satoh
+{
+class LoopSram;
+} // namespace satoh
+
+/// @brief ルーパー用 SPI SRAM 転送（音声タスクと転送タスクの受け渡し）
+/// @note SPI 通信は DMA 完了を待つため、音声タスクからは呼ばない。
+///   音声タスクは1ブロック分の書き込み・先読み要求を post() でリングに積み、
+///   転送タスクが serve() で SRAM と通信し、読み出した結果をもう一方のリングに積む。
+///   音声タスクは fetch() で結果を受け取るだけなので、SPI が遅れても待たされない（間に合わなければ無音）。
+///   要求は1本のリングで順に処理されるので、同じ位置の書き込みと読み出しの順序は保たれる。
+class satoh::LoopSram
+{
+public:
+  static constexpr uint32_t SRAM_SIZE = 128 * 1024; ///< SPI SRAM 容量（1Mbit 24ビットアドレス）
+
+  /// @brief 保存形式
+  enum Format : uint8_t
+  {
+    INT8 = 0, ///< 8ビット整数
+    INT16,    ///< 16ビット整数
+    FLOAT,    ///< 32ビット浮動小数
+  };
+  /// @brief 音声タスクからの要求（1ブロック分）
+  struct Request
+  {
+    uint32_t gen;           ///< 世代（停止・消去で変わる 古い世代の読み出し結果は捨てる）
+    uint32_t wpos;          ///< 書き込み位置（サンプル）
+    uint32_t rpos;          ///< 読み出し位置（サンプル）
+    Format format;          ///< 保存形式
+    bool write;             ///< 書き込み有無
+    bool read;              ///< 読み出し有無
+    float data[BLOCK_SIZE]; ///< 書き込みデータ
+  };
+  /// @brief 読み出し結果（1ブロック分）
+  struct Reply
+  {
+    uint32_t gen;           ///< 世代
+    uint32_t pos;           ///< 読み出し位置（サンプル）
+    float data[BLOCK_SIZE]; ///< 読み出しデータ
+  };
+
+  /// @brief 保存形式の1サンプルあたりのバイト数を取得
+  /// @param [in] format 保存形式
+  /// @return バイト数
+  static constexpr uint32_t getSampleBytes(Format format) noexcept { return format == INT8 ? 1 : (format == INT16 ? 2 : 4); }
+  /// @brief 保存形式毎の最大ループ長を取得
+  /// @param [in] format 保存形式
+  /// @return 最大ループ長（サンプル数 BLOCK_SIZE の倍数）
+  static constexpr uint32_t getMaxLength(Format format) noexcept { return SRAM_SIZE / getSampleBytes(format) / BLOCK_SIZE * BLOCK_SIZE; }
+
+private:
+  /// @brief コピーコンストラクタ削除
+  LoopSram(LoopSram const &) = delete;
+  /// @brief 代入演算子削除
+  LoopSram &operator=(LoopSram const &) = delete;
+
+  enum
+  {
+    CMD_WRITE = 2,   ///< SPI SRAM WRITEコマンド
+    CMD_READ = 3,    ///< SPI SRAM READコマンド
+    HEADER_SIZE = 4, ///< SPI SRAM 通信ヘッダーサイズ（コマンド + 24ビットアドレス）
+  };
+  static constexpr uint32_t RING_SIZE = 8;                                           ///< 要求・結果のリング要素数
+  static constexpr uint32_t COMMAND_SIZE = HEADER_SIZE + BLOCK_SIZE * sizeof(float); ///< 最大通信サイズ
+
+  SpiMaster *spi_;              ///< SPI通信オブジェクト
+  SpscRing<Request> requests_;  ///< 要求（音声タスク → 転送タスク）
+  SpscRing<Reply> replies_;     ///< 読み出し結果（転送タスク → 音声タスク）
+  UniqueDmaPtr<uint8_t> txbuf_; ///< 送信バッファ（転送タスク専用）
+  UniqueDmaPtr<uint8_t> rxbuf_; ///< 受信バッファ（転送タスク専用）
+  Request work_;                ///< 処理中の要求（転送タスク専用）
+  Reply result_;                ///< 読み出し結果の作業領域（転送タスク専用）
+  Reply pending_;               ///< 先に届いた読み出し結果（音声タスク専用）
+  bool hasPending_;             ///< pending_ 有無（音声タスク専用）
+
+  /// @brief 通信ヘッダーを作る
+  /// @param [in] cmd コマンド
+  /// @param [in] pos 位置（サンプル）
+  /// @param [in] format 保存形式
+  void setHeader(uint8_t cmd, uint32_t pos, Format format) const noexcept
+  {
+    uint8_t *t = txbuf_.get();
+    BE<uint32_t>::set(t, pos * getSampleBytes(format)); // アドレスは上位バイトから送る
+    t[0] = cmd;
+  }
+  /// @brief SRAMへ書き込む
+  /// @tparam T 保存する型
+  /// @param [in] src 書き込むデータ（BLOCK_SIZE分）
+  /// @param [in] pos 書き込み位置
+  /// @param [in] format 保存形式
+  template <typename T>
+  void writeSram(float const *src, uint32_t pos, Format format) const noexcept
+  {
+    setHeader(CMD_WRITE, pos, format);
+    T *p = reinterpret_cast<T *>(txbuf_.get() + HEADER_SIZE);
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      p[i] = fromFloat<T>(std::max(-1.0f, std::min(src[i], 1.0f)));
+    }
+    spi_->send(txbuf_.get(), HEADER_SIZE + BLOCK_SIZE * sizeof(T));
+  }
+  /// @brief SRAMから読み出す
+  /// @tparam T 保存する型
+  /// @param [out] dst 読み出し先（BLOCK_SIZE分）
+  /// @param [in] pos 読み出し位置
+  /// @param [in] format 保存形式
+  template <typename T>
+  void readSram(float *dst, uint32_t pos, Format format) const noexcept
+  {
+    constexpr uint32_t size = HEADER_SIZE + BLOCK_SIZE * sizeof(T);
+    memset(txbuf_.get(), 0, size);
+    setHeader(CMD_READ, pos, format);
+    if (spi_->sendRecv(txbuf_.get(), rxbuf_.get(), size) != SpiMaster::OK)
+    {
+      memset(dst, 0, BLOCK_SIZE * sizeof(float));
+      return;
+    }
+    T const *p = reinterpret_cast<T const *>(rxbuf_.get() + HEADER_SIZE);
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      dst[i] = toFloat<T>(p[i]);
+    }
+  }
+
+public:
+  /// @brief コンストラクタ
+  /// @param [in] spi SPI通信オブジェクト
+  explicit LoopSram(SpiMaster *spi) noexcept       //
+      : spi_(spi),                                 //
+        requests_(RING_SIZE),                      //
+        replies_(RING_SIZE),                       //
+        txbuf_(makeDmaMem<uint8_t>(COMMAND_SIZE)), //
+        rxbuf_(makeDmaMem<uint8_t>(COMMAND_SIZE)), //
+        hasPending_(false)                         //
+  {
+  }
+  /// @brief デストラクタ
+  virtual ~LoopSram() {}
+  /// @brief セットアップ成功・失敗を取得
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return spi_ && requests_ && replies_ && txbuf_ && rxbuf_; }
+  /// @brief 要求を積む（音声タスクから呼ぶ）
+  /// @param [in] req 要求
+  /// @retval true 成功
+  /// @retval false リングが一杯（転送タスクが遅れている）
+  bool post(Request const &req) noexcept { return requests_.push(&req, 1) == 1; }
+  /// @brief 読み出し結果を受け取る（音声タスクから呼ぶ）
+  /// @param [in] gen 世代
+  /// @param [in] pos 読み出し位置
+  /// @param [in] length ループ長（先読みの範囲の2倍より長いこと この先 length / 2 以内の位置の結果は後で使うため残す）
+  /// @param [out] dst 格納先（BLOCK_SIZE分）
+  /// @retval true 受け取った
+  /// @retval false まだ届いていない
+  bool fetch(uint32_t gen, uint32_t pos, uint32_t length, float *dst) noexcept
+  {
+    for (;;)
+    {
+      if (!hasPending_)
+      {
+        if (replies_.pop(&pending_, 1) == 0)
+        {
+          return false;
+        }
+        hasPending_ = true;
+      }
+      if (pending_.gen == gen)
+      {
+        if (pending_.pos == pos)
+        {
+          memcpy(dst, pending_.data, BLOCK_SIZE * sizeof(float));
+          hasPending_ = false;
+          return true;
+        }
+        if ((pending_.pos + length - pos) % length <= length / 2)
+        {
+          return false; // 要求を積めなかったブロックの分だけ先の結果 後で使う
+        }
+      }
+      hasPending_ = false; // 古い世代・間に合わなかった結果は捨てる
+    }
+  }
+  /// @brief 積まれた要求をすべて処理する（転送タスクから呼ぶ）
+  void serve() noexcept
+  {
+    while (requests_.pop(&work_, 1) == 1)
+    {
+      if (work_.write)
+      {
+        switch (work_.format)
+        {
+        case INT8:
+          writeSram<int8_t>(work_.data, work_.wpos, work_.format);
+          break;
+        case INT16:
+          writeSram<int16_t>(work_.data, work_.wpos, work_.format);
+          break;
+        default:
+          writeSram<float>(work_.data, work_.wpos, work_.format);
+          break;
+        }
+      }
+      if (work_.read)
+      {
+        result_.gen = work_.gen;
+        result_.pos = work_.rpos;
+        switch (work_.format)
+        {
+        case INT8:
+          readSram<int8_t>(result_.data, work_.rpos, work_.format);
+          break;
+        case INT16:
+          readSram<int16_t>(result_.data, work_.rpos, work_.format);
+          break;
+        default:
+          readSram<float>(result_.data, work_.rpos, work_.format);
+          break;
+        }
+        replies_.push(&result_, 1);
+      }
+    }
+  }
+};
@@ -0,0 +1,271 @@
+/// @file      effector/lib/lib_pitch.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "common/alloc.hpp"
+#include "constant.h"
+#include "lib_filter.hpp"
+#include <algorithm>
+#include <cstring> // memset, memmove
+
+namespace satoh
+{
+class PitchDetector;
+} // namespace satoh
+
+/// @brief ピッチ検出（間引き + YIN + 元のサンプリング周波数での精密化）
+/// @note 1. 入力を4次LPFに通して 1/DECIMATION に間引き、低いサンプリング周波数で YIN により周期を大まかに求める。
+///      間引くことで差分関数の計算量は 1/DECIMATION^2 になり、ベースの低音（周期の長い音）まで扱える。
+///   2. 大まかな周期の前後 ±DECIMATION サンプルだけ、元のサンプリング周波数で差分関数を計算し、
+///      放物線補間で周期を確定する。
+///   音声処理と並行して使う場合は detectStep() で差分関数を少しずつ計算する（開始時の間引き後の入力窓を退避して使う）。
+class satoh::PitchDetector
+{
+public:
+  static constexpr uint32_t DECIMATION = 4;                      ///< 間引き率
+  static constexpr float MIN_FREQ = 38.0f;                       ///< 最低周波数（ベース4弦E 41Hz、7弦B 61.7Hzを含む）
+  static constexpr float MAX_FREQ = 1000.0f;                     ///< 最高周波数
+  static constexpr float DEC_FREQ = SAMPLING_FREQ / DECIMATION;  ///< 間引き後のサンプリング周波数
+
+private:
+  /// @brief コピーコンストラクタ削除
+  PitchDetector(PitchDetector const &) = delete;
+  /// @brief 代入演算子削除
+  PitchDetector &operator=(PitchDetector const &) = delete;
+
+  static constexpr uint32_t TAU_MIN = DEC_FREQ / MAX_FREQ;                ///< 最小周期（間引き後）
+  static constexpr uint32_t TAU_MAX = DEC_FREQ / MIN_FREQ + 2;            ///< 最大周期（間引き後）
+  static constexpr uint32_t DEC_WINDOW = TAU_MAX;                         ///< 差分関数の積算幅（間引き後）
+  static constexpr uint32_t DEC_SIZE = DEC_WINDOW + TAU_MAX + 1;          ///< 間引き後の入力窓サイズ
+  static constexpr uint32_t FULL_RANGE = DECIMATION;                      ///< 精密化で探索する範囲（±）
+  static constexpr uint32_t FULL_WINDOW = 1024;                           ///< 精密化での差分関数の積算幅
+  static constexpr uint32_t FULL_SIZE = FULL_WINDOW + (TAU_MAX + 1) * DECIMATION + FULL_RANGE; ///< 入力窓サイズ
+  static constexpr float THRESHOLD = 0.15f;                               ///< YIN 閾値
+  static constexpr float MAX_APERIODICITY = 0.4f;                         ///< これを超える場合は周期性なしとする
+  static constexpr float AA_FREQ = 1500.0f;                               ///< 間引き前LPFのカットオフ周波数
+
+  lpf2nd aa1_;            ///< 間引き前LPF（1段目）
+  lpf2nd aa2_;            ///< 間引き前LPF（2段目）
+  UniquePtr<float> full_; ///< 入力窓（古い順）
+  UniquePtr<float> dec_;  ///< 間引き後の入力窓（古い順）
+  UniquePtr<float> diff_; ///< 累積平均正規化差分関数
+  UniquePtr<float> snap_; ///< 分割検出中の間引き後の入力窓
+  uint32_t phase_;        ///< 間引き位相
+  float aperiodicity_;    ///< 直近の検出結果の非周期性（0に近いほど周期的）
+  uint32_t next_;         ///< 分割検出で次に計算する周期（0は検出開始前）
+  float sum_;             ///< 分割検出中の差分関数の累積
+  float freq_;            ///< 分割検出の直近の結果（0は検出なし）
+
+  /// @brief 放物線補間で極小位置を求める
+  /// @param [in] ym 1つ前の値
+  /// @param [in] y0 極小値
+  /// @param [in] yp 1つ後の値
+  /// @return 極小位置の補正量（-0.5 ～ 0.5）
+  static float parabola(float ym, float y0, float yp) noexcept
+  {
+    float den = ym - 2.0f * y0 + yp;
+    return den <= 0.0f ? 0.0f : std::max(-0.5f, std::min(0.5f, 0.5f * (ym - yp) / den));
+  }
+  /// @brief 差分関数 Σ(x[j] - x[j+tau])^2
+  /// @param [in] x 先頭
+  /// @param [in] tau ずらし量
+  /// @param [in] w 積算幅
+  /// @return 差分関数の値
+  static float difference(float const *x, uint32_t tau, uint32_t w) noexcept
+  {
+    float s = 0;
+    for (uint32_t j = 0; j < w; ++j)
+    {
+      float d = x[j] - x[j + tau];
+      s += d * d;
+    }
+    return s;
+  }
+  /// @brief 累積平均正規化差分関数を計算する
+  /// @param [in] x 間引き後の入力窓
+  /// @param [in] top 計算を始める周期（1 ～ TAU_MAX）
+  /// @param [in] end 計算を終える周期（この周期は含まない）
+  void accumulate(float const *x, uint32_t top, uint32_t end) noexcept
+  {
+    float *d = diff_.get();
+    d[0] = 1.0f;
+    for (uint32_t tau = top; tau < end; ++tau)
+    {
+      float s = difference(x, tau, DEC_WINDOW);
+      sum_ += s;
+      d[tau] = sum_ <= 0.0f ? 1.0f : s * tau / sum_;
+    }
+  }
+  /// @brief 累積平均正規化差分関数から大まかな周期を求める
+  /// @return 周期（間引き後のサンプル数 小数部あり 0は検出なし）
+  float choose() noexcept
+  {
+    float const *d = diff_.get();
+    // 閾値を下回る最初の谷を採用する（見つからなければ全体の最小値）
+    uint32_t best = 0;
+    for (uint32_t tau = TAU_MIN; tau < TAU_MAX; ++tau)
+    {
+      if (d[tau] < THRESHOLD)
+      {
+        while (tau + 1 < TAU_MAX && d[tau + 1] < d[tau])
+        {
+          ++tau;
+        }
+        best = tau;
+        break;
+      }
+    }
+    if (best == 0)
+    {
+      best = TAU_MIN;
+      for (uint32_t tau = TAU_MIN; tau < TAU_MAX; ++tau)
+      {
+        best = d[tau] < d[best] ? tau : best;
+      }
+    }
+    aperiodicity_ = d[best];
+    if (MAX_APERIODICITY < aperiodicity_)
+    {
+      return 0.0f;
+    }
+    return best + parabola(d[best - 1], d[best], d[best + 1]);
+  }
+  /// @brief 大まかな周期から周波数を求める
+  /// @param [in] tau 大まかな周期（間引き後のサンプル数 0は検出なし）
+  /// @return 周波数（0は検出なし）
+  float toFreq(float tau) const noexcept { return tau <= 0.0f ? 0.0f : SAMPLING_FREQ / fine(tau * DECIMATION); }
+  /// @brief 元のサンプリング周波数で周期を精密化する
+  /// @param [in] tau 大まかな周期（元のサンプリング周波数でのサンプル数）
+  /// @return 周期（元のサンプリング周波数でのサンプル数）
+  float fine(float tau) const noexcept
+  {
+    const uint32_t center = static_cast<uint32_t>(tau + 0.5f);
+    const uint32_t top = center - FULL_RANGE;
+    float const *x = full_.get() + FULL_SIZE - FULL_WINDOW - (center + FULL_RANGE + 1);
+    constexpr uint32_t COUNT = FULL_RANGE * 2 + 1;
+    float d[COUNT];
+    uint32_t best = 1;
+    for (uint32_t i = 0; i < COUNT; ++i)
+    {
+      d[i] = difference(x, top + i, FULL_WINDOW);
+      if (0 < i && i + 1 < COUNT && d[i] < d[best])
+      {
+        best = i;
+      }
+    }
+    return top + best + parabola(d[best - 1], d[best], d[best + 1]);
+  }
+
+public:
+  /// @brief コンストラクタ
+  PitchDetector() noexcept                      //
+      : aa1_(AA_FREQ),                          //
+        aa2_(AA_FREQ),                          //
+        full_(allocArray<float>(FULL_SIZE)),    //
+        dec_(allocArray<float>(DEC_SIZE)),      //
+        diff_(allocArray<float>(TAU_MAX + 1)),  //
+        snap_(allocArray<float>(DEC_SIZE)),     //
+        phase_(0),                              //
+        aperiodicity_(1.0f),                    //
+        next_(0),                               //
+        sum_(0),                                //
+        freq_(0)                                //
+  {
+    if (*this)
+    {
+      reset();
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~PitchDetector() {}
+  /// @brief メモリ確保成功・失敗を取得
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return full_ && dec_ && diff_ && snap_; }
+  /// @brief 内部状態を初期化する
+  void reset() noexcept
+  {
+    memset(full_.get(), 0, FULL_SIZE * sizeof(float));
+    memset(dec_.get(), 0, DEC_SIZE * sizeof(float));
+    aa1_ = lpf2nd(AA_FREQ);
+    aa2_ = lpf2nd(AA_FREQ);
+    phase_ = 0;
+    aperiodicity_ = 1.0f;
+    next_ = 0;
+    sum_ = 0;
+    freq_ = 0;
+  }
+  /// @brief 入力音を追加する
+  /// @param [in] src 入力音声
+  /// @param [in] n サンプル数
+  void push(float const *src, uint32_t n) noexcept
+  {
+    n = std::min(n, FULL_SIZE);
+    float *full = full_.get();
+    memmove(full, full + n, (FULL_SIZE - n) * sizeof(float));
+    memcpy(full + FULL_SIZE - n, src, n * sizeof(float));
+    // 間引き（DECIMATION サンプルに1つ残す）
+    constexpr uint32_t BUF_SIZE = 64;
+    float buf[BUF_SIZE];
+    uint32_t cnt = 0;
+    float *dec = dec_.get();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+      float y = aa2_.process(aa1_.process(src[i]));
+      if (++phase_ == DECIMATION)
+      {
+        phase_ = 0;
+        buf[cnt++] = y;
+      }
+      if (cnt == BUF_SIZE || (i + 1 == n && cnt != 0))
+      {
+        memmove(dec, dec + cnt, (DEC_SIZE - cnt) * sizeof(float));
+        memcpy(dec + DEC_SIZE - cnt, buf, cnt * sizeof(float));
+        cnt = 0;
+      }
+    }
+  }
+  /// @brief 周波数を検出する
+  /// @return 周波数（0は検出なし）
+  float detect() noexcept
+  {
+    sum_ = 0;
+    accumulate(dec_.get(), 1, TAU_MAX + 1);
+    next_ = 0;
+    return toFreq(choose());
+  }
+  /// @brief 周波数を分割して検出する（音声処理の中から毎ブロック呼ぶ）
+  /// @param [in] count 1回で差分関数を計算する周期の数
+  /// @retval true 検出が完了した（結果は getFreq() で取得）
+  /// @retval false 検出中
+  /// @note 約 TAU_MAX / count 回で1回検出する。計算量は1回あたり count * DEC_WINDOW 回の積和、
+  ///   完了時のみ精密化の (FULL_RANGE * 2 + 1) * FULL_WINDOW 回の積和が加わる。
+  ///   精密化は完了時点の入力窓で行う（大まかな周期は検出開始時点のもの）。
+  bool detectStep(uint32_t count) noexcept
+  {
+    if (next_ == 0)
+    {
+      memcpy(snap_.get(), dec_.get(), DEC_SIZE * sizeof(float));
+      sum_ = 0;
+      next_ = 1;
+    }
+    const uint32_t end = std::min(next_ + count, TAU_MAX + 1);
+    accumulate(snap_.get(), next_, end);
+    next_ = end;
+    if (next_ <= TAU_MAX)
+    {
+      return false;
+    }
+    next_ = 0;
+    freq_ = toFreq(choose());
+    return true;
+  }
+  /// @brief 分割検出の直近の結果を取得する @return 周波数（0は検出なし）
+  float getFreq() const noexcept { return freq_; }
+  /// @brief 直近の検出結果の非周期性を取得する @return 非周期性（0に近いほど周期的）
+  float getAperiodicity() const noexcept { return aperiodicity_; }
+};
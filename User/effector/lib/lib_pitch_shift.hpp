@@ -0,0 +1,188 @@
+/// @file      effector/lib/lib_pitch_shift.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "common/alloc.hpp"
+#include "constant.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring> // memset
+
+namespace satoh
+{
+class PitchShift;
+} // namespace satoh
+
+/// @brief ピッチシフト（2グレインのクロスフェード遅延 + 波形の位相合わせ）
+/// @note 遅延時間を一定の速さで変化させると、読み出す音の周波数が変わる（ドップラー効果）。
+///   遅延時間は伸び縮みし続けられないため、GRAIN サンプル毎に読み出し位置を戻す（グレイン）。
+///   半分ずらした2つのグレインを、和が常に1になる窓でクロスフェードする。
+///   グレインを始める時、もう一方のグレイン（窓が最大）と波形の位相が揃う遅延時間を SEARCH の範囲から探す。
+///   位相がずれたままクロスフェードすると、うなりや音程のずれになる。
+///   探索は差分 Σ(a-b)^2 が最小になる位置を 1/STEP に間引いて大まかに求め、前後 ±STEP を全サンプルで求める。
+class satoh::PitchShift
+{
+public:
+  static constexpr uint32_t GRAIN = 1024;                   ///< グレイン長（約23ms）
+  static constexpr uint32_t SEARCH = 576;                   ///< 位相合わせの探索範囲（約79Hz の1周期 ギター6弦E 82Hzを含む）
+  static constexpr uint32_t MAX_DELAY = GRAIN + SEARCH + 2; ///< 最大遅延サンプル数
+  static constexpr float MIN_RATIO = 0.5f;                  ///< 最小周波数比（-12半音）
+  static constexpr float MAX_RATIO = 2.0f;                  ///< 最大周波数比（+12半音）
+
+private:
+  /// @brief コピーコンストラクタ削除
+  PitchShift(PitchShift const &) = delete;
+  /// @brief 代入演算子削除
+  PitchShift &operator=(PitchShift const &) = delete;
+
+  static constexpr uint32_t CORR = 128;  ///< 位相合わせで比較するサンプル数
+  static constexpr uint32_t STEP = 4;    ///< 大まかな探索の間引き率
+  static constexpr uint32_t SIZE = 2048; ///< 遅延バッファサイズ（MAX_DELAY + CORR 以上の2のべき乗）
+  static constexpr uint32_t MASK = SIZE - 1;
+  static_assert(MAX_DELAY + CORR < SIZE, "");
+
+  /// @brief グレイン
+  struct Grain
+  {
+    float delay;  ///< 遅延サンプル数
+    uint32_t pos; ///< 開始からの経過サンプル数（0 ～ GRAIN-1）
+  };
+
+  UniquePtr<float> buf_; ///< 遅延バッファ
+  uint32_t wpos_;        ///< 書き込み位置
+  Grain grain_[2];       ///< グレイン
+  float ratio_;          ///< 周波数比
+
+  /// @brief 線形補間して読み出す
+  /// @param [in] delay 遅延サンプル数（1 ～ MAX_DELAY）
+  /// @return 読み出した値
+  float read(float delay) const noexcept
+  {
+    const uint32_t d = static_cast<uint32_t>(delay);
+    const float t = delay - d;
+    float const *buf = buf_.get();
+    const float a = buf[(wpos_ - d) & MASK];
+    const float b = buf[(wpos_ - d - 1) & MASK];
+    return a + t * (b - a);
+  }
+  /// @brief 窓（経過位置 0, GRAIN で 0、GRAIN/2 で 1 の smoothstep 半分ずらした窓との和は1）
+  /// @param [in] pos 経過サンプル数
+  /// @return 窓の値
+  static float window(uint32_t pos) noexcept
+  {
+    const float t = 1.0f - std::abs(2.0f * pos / GRAIN - 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+  }
+  /// @brief 遅延 a, b の直近の波形の差分 Σ(x[a] - x[b])^2
+  /// @param [in] a 遅延サンプル数
+  /// @param [in] b 遅延サンプル数
+  /// @param [in] step 間引き率
+  /// @return 差分
+  float difference(uint32_t a, uint32_t b, uint32_t step) const noexcept
+  {
+    float const *buf = buf_.get();
+    float s = 0;
+    for (uint32_t j = 0; j < CORR; j += step)
+    {
+      float d = buf[(wpos_ - a - j) & MASK] - buf[(wpos_ - b - j) & MASK];
+      s += d * d;
+    }
+    return s;
+  }
+  /// @brief グレインを始める
+  /// @param [in] g 始めるグレイン
+  /// @param [in] other もう一方のグレイン（窓が最大）
+  void start(Grain &g, Grain const &other) const noexcept
+  {
+    // グレインの間に遅延時間が減る分（周波数を上げる場合）だけ、遅延を長くして始める
+    const uint32_t base = 1 + static_cast<uint32_t>(std::max(0.0f, (ratio_ - 1.0f) * GRAIN) + 0.5f);
+    const uint32_t ref = static_cast<uint32_t>(other.delay + 0.5f);
+    uint32_t best = 0;
+    float min = difference(base, ref, STEP);
+    for (uint32_t o = STEP; o < SEARCH; o += STEP)
+    {
+      float d = difference(base + o, ref, STEP);
+      if (d < min)
+      {
+        min = d;
+        best = o;
+      }
+    }
+    const uint32_t top = best < STEP ? 0 : best - STEP;
+    const uint32_t end = std::min(best + STEP, SEARCH);
+    min = difference(base + best, ref, 1);
+    for (uint32_t o = top; o <= end; ++o)
+    {
+      float d = difference(base + o, ref, 1);
+      if (d < min)
+      {
+        min = d;
+        best = o;
+      }
+    }
+    // 小数部を揃えて、補間による音色の違いを抑える
+    g.delay = base + best + (other.delay - ref);
+    g.pos = 0;
+  }
+
+public:
+  /// @brief コンストラクタ
+  PitchShift() noexcept : buf_(allocArray<float>(SIZE)), wpos_(0), grain_{}, ratio_(1.0f)
+  {
+    if (buf_)
+    {
+      reset();
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~PitchShift() {}
+  /// @brief メモリ確保成功・失敗を取得
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept { return static_cast<bool>(buf_); }
+  /// @brief 内部状態を初期化する
+  void reset() noexcept
+  {
+    memset(buf_.get(), 0, SIZE * sizeof(float));
+    wpos_ = 0;
+    grain_[0] = Grain{1.0f, 0};
+    grain_[1] = Grain{1.0f, GRAIN / 2};
+  }
+  /// @brief 周波数比を設定する
+  /// @param [in] ratio 周波数比（MIN_RATIO ～ MAX_RATIO）
+  void setRatio(float ratio) noexcept { ratio_ = std::max(MIN_RATIO, std::min(ratio, MAX_RATIO)); }
+  /// @brief 半音単位でずらす量を設定する
+  /// @param [in] semitone 半音数（-12 ～ 12 小数可）
+  void setSemitone(float semitone) noexcept { setRatio(std::exp2(semitone / 12.0f)); }
+  /// @brief ピッチシフト処理
+  /// @param [in] in 入力
+  /// @param [out] out 出力（inと同じ領域でも可）
+  /// @param [in] size データ数
+  void process(float const *in, float *out, uint32_t size) noexcept
+  {
+    float *buf = buf_.get();
+    const float slope = 1.0f - ratio_; // 1サンプルあたりの遅延時間の変化
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      buf[wpos_ & MASK] = in[i];
+      float y = 0;
+      for (uint32_t k = 0; k < 2; ++k)
+      {
+        Grain &g = grain_[k];
+        if (g.pos == GRAIN)
+        {
+          start(g, grain_[k ^ 1]);
+        }
+        y += window(g.pos) * read(g.delay);
+        g.delay = std::max(1.0f, std::min(g.delay + slope, static_cast<float>(MAX_DELAY)));
+        ++g.pos;
+      }
+      out[i] = y;
+      ++wpos_;
+    }
+  }
+};
@@ -0,0 +1,126 @@
+/// @file      effector/lib/lib_tempo.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "constant.h"
+#include <cstdint>
+
+namespace satoh
+{
+class TempoClock;
+} // namespace satoh
+
+/// @brief テンポクロック（TAPで決めたテンポの拍位置を、全エフェクターで共有する）
+/// @note 音声タスクが1つだけ持ち、ブロック毎に advance() で進める。TAPされると拍の頭に戻す。
+///   同期するエフェクターは自分で位相を積算せず、ブロックの先頭で getPhase() の位相に LFO を合わせ、
+///   ディレイタイムは getTime() から求める。
+///   拍の位置は、全音符・付点・3連符の周期がすべて割り切れる12拍で一周させる。
+class satoh::TempoClock
+{
+public:
+  /// @brief 音符の長さ
+  enum Division : uint8_t
+  {
+    OFF = 0,   ///< 同期しない
+    WHOLE,     ///< 全音符
+    HALF,      ///< 2分音符
+    DOT4,      ///< 付点4分音符
+    QUARTER,   ///< 4分音符
+    TRIPLET4,  ///< 4分3連符
+    DOT8,      ///< 付点8分音符
+    EIGHTH,    ///< 8分音符
+    TRIPLET8,  ///< 8分3連符
+    SIXTEENTH, ///< 16分音符
+    DIVISION_COUNT,
+  };
+
+private:
+  static constexpr float WRAP_BEATS = 12.0f;        ///< 拍の位置が一周する拍数
+  static constexpr uint32_t DEFAULT_INTERVAL = 500; ///< TAPされるまでの1拍の長さ（ミリ秒 120BPM）
+  static constexpr uint32_t MIN_INTERVAL = 200;     ///< TAP間隔として受け付ける最小値（ミリ秒 300BPM）
+  static constexpr uint32_t MAX_INTERVAL = 2000;    ///< TAP間隔として受け付ける最大値（ミリ秒 30BPM）
+
+  uint32_t interval_; ///< 1拍の長さ（ミリ秒）
+  float beatStep_;    ///< 1サンプルあたりに進む拍数
+  float beat_;        ///< 現在のブロック先頭の拍の位置（0 ～ WRAP_BEATS）
+
+  /// @brief 音符の拍数を取得
+  /// @param [in] div 音符の長さ（OFF以外）
+  /// @return 拍数
+  static float getBeats(uint8_t div) noexcept
+  {
+    static const float BEATS[] = {1.0f, 4.0f, 2.0f, 1.5f, 1.0f, 2.0f / 3.0f, 0.75f, 0.5f, 1.0f / 3.0f, 0.25f};
+    return BEATS[div < DIVISION_COUNT ? div : OFF];
+  }
+  /// @brief 1拍の長さを設定する
+  /// @param [in] ms 1拍の長さ（ミリ秒）
+  void setInterval(uint32_t ms) noexcept
+  {
+    interval_ = ms;
+    beatStep_ = 1000.0f / (static_cast<float>(ms) * SAMPLING_FREQ);
+  }
+
+public:
+  /// @brief コンストラクタ
+  TempoClock() noexcept : interval_(0), beatStep_(0), beat_(0) { setInterval(DEFAULT_INTERVAL); }
+  /// @brief 音符の長さの表示文字列を取得
+  /// @param [in] div 音符の長さ
+  /// @return 文字列のポインタ
+  static const char *getDivisionName(uint8_t div) noexcept
+  {
+    static const char *const NAME[] = {"OFF", "1/1", "1/2", "1/4.", "1/4", "1/4T", "1/8.", "1/8", "1/8T", "1/16"};
+    return NAME[div < DIVISION_COUNT ? div : OFF];
+  }
+  /// @brief TAPされたことを通知する（拍の頭に戻す）
+  /// @param [in] ms TAP間隔（ミリ秒 範囲外ならテンポは変えない）
+  void tap(uint32_t ms) noexcept
+  {
+    if (MIN_INTERVAL <= ms && ms <= MAX_INTERVAL)
+    {
+      setInterval(ms);
+    }
+    beat_ = 0.0f;
+  }
+  /// @brief 1ブロック分進める（音声タスクから、全エフェクターの処理後に呼ぶ）
+  /// @param [in] size 音声データ数
+  void advance(uint32_t size) noexcept
+  {
+    beat_ += beatStep_ * size;
+    if (WRAP_BEATS <= beat_)
+    {
+      beat_ -= WRAP_BEATS;
+    }
+  }
+  /// @brief 1拍の長さを取得
+  /// @return 1拍の長さ（ミリ秒）
+  uint32_t getInterval() const noexcept { return interval_; }
+  /// @brief 現在のブロック先頭での、音符の長さを1周期とした位相を取得
+  /// @param [in] div 音符の長さ
+  /// @return 位相（0 ～ 1）
+  float getPhase(uint8_t div) const noexcept
+  {
+    const float cycle = beat_ / getBeats(div);
+    return cycle - static_cast<float>(static_cast<uint32_t>(cycle));
+  }
+  /// @brief 音符の長さを1周期とした周波数を取得
+  /// @param [in] div 音符の長さ
+  /// @return 周波数（Hz）
+  float getFreq(uint8_t div) const noexcept { return 1000.0f / (static_cast<float>(interval_) * getBeats(div)); }
+  /// @brief 音符の長さを取得
+  /// @param [in] div 音符の長さ
+  /// @param [in] maxMs 最大値（超える場合は半分にしていく）
+  /// @return 長さ（ミリ秒）
+  float getTime(uint8_t div, float maxMs) const noexcept
+  {
+    float ms = static_cast<float>(interval_) * getBeats(div);
+    while (maxMs < ms)
+    {
+      ms *= 0.5f;
+    }
+    return ms;
+  }
+};
@@ -0,0 +1,114 @@
+/// @file      effector/limiter.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "constant.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace satoh
+{
+namespace fx
+{
+class Limiter;
+}
+} // namespace satoh
+
+/// @brief 先読みブリックウォールリミッター（出力段用 L/R連動）
+/// @note 入力を LOOKAHEAD サンプル遅らせ、その間に来るピークに対して前もって音量を下げる。
+///   1. 直近 LOOKAHEAD+1 サンプルの最大ピークを単調減少キューで求め（1サンプルあたり償却O(1)）、必要な倍率にする。
+///   2. 倍率を下げる時は即座に、上げる時はリリース時定数でゆっくり戻す。
+///   3. LOOKAHEAD サンプルの移動平均で滑らかにする。
+///   移動平均の範囲の倍率はどれも、遅延後に出力するサンプルの必要倍率以下なので、CEILINGを超えることはない。
+class satoh::fx::Limiter
+{
+public:
+  static constexpr uint32_t LOOKAHEAD = 32;  ///< 先読みサンプル数（= レイテンシ 約0.72ms）
+  static constexpr float CEILING = 0.98f;    ///< 出力の最大振幅（約 -0.18dBFS）
+  static constexpr float RELEASE_MS = 50.0f; ///< リリース時定数（ミリ秒）
+
+private:
+  static constexpr uint32_t SIZE = 64; ///< リングバッファサイズ（LOOKAHEAD+1 以上の2のべき乗）
+  static constexpr uint32_t MASK = SIZE - 1;
+  static_assert(LOOKAHEAD < SIZE, "");
+
+  float delayL_[SIZE];  ///< L遅延バッファ
+  float delayR_[SIZE];  ///< R遅延バッファ
+  float peak_[SIZE];    ///< 単調減少キュー ピーク値
+  uint32_t time_[SIZE]; ///< 単調減少キュー 時刻
+  uint32_t head_;       ///< 単調減少キュー 先頭（最大値）
+  uint32_t tail_;       ///< 単調減少キュー 末尾
+  float hold_[SIZE];    ///< 移動平均用 倍率履歴
+  float sum_;           ///< 移動平均用 倍率合計
+  float gain_;          ///< リリース処理後の倍率
+  float release_;       ///< リリース係数
+  uint32_t now_;        ///< 時刻（処理したサンプル数）
+
+public:
+  /// @brief コンストラクタ
+  Limiter() noexcept : release_(std::exp(-1000.0f / (RELEASE_MS * SAMPLING_FREQ))) { init(); }
+  /// @brief デストラクタ
+  virtual ~Limiter() noexcept {}
+  /// @brief 初期化
+  void init() noexcept
+  {
+    std::fill(delayL_, delayL_ + SIZE, 0.0f);
+    std::fill(delayR_, delayR_ + SIZE, 0.0f);
+    std::fill(hold_, hold_ + SIZE, 1.0f);
+    head_ = 0;
+    tail_ = 0;
+    sum_ = LOOKAHEAD;
+    gain_ = 1.0f;
+    now_ = 0;
+  }
+  /// @brief リミッター処理（出力は LOOKAHEAD サンプル遅れる）
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数
+  void process(float *left, float *right, uint32_t size) noexcept
+  {
+    for (uint32_t i = 0; i < size; ++i, ++now_)
+    {
+      const uint32_t w = now_ & MASK;
+      const float l = left[i];
+      const float r = right[i];
+      delayL_[w] = l;
+      delayR_[w] = r;
+      // 窓から外れた先頭を捨て、自分以下の末尾を捨ててから追加する
+      const float p = std::max(std::abs(l), std::abs(r));
+      if (head_ != tail_ && now_ - time_[head_ & MASK] > LOOKAHEAD)
+      {
+        ++head_;
+      }
+      while (head_ != tail_ && peak_[(tail_ - 1) & MASK] <= p)
+      {
+        --tail_;
+      }
+      peak_[tail_ & MASK] = p;
+      time_[tail_ & MASK] = now_;
+      ++tail_;
+      // 必要倍率 → リリース → 移動平均
+      const float maxPeak = peak_[head_ & MASK];
+      const float target = CEILING < maxPeak ? CEILING / maxPeak : 1.0f;
+      gain_ = target < gain_ ? target : target + release_ * (gain_ - target);
+      sum_ += gain_ - hold_[(now_ - LOOKAHEAD) & MASK];
+      hold_[w] = gain_;
+      const float g = sum_ * (1.0f / LOOKAHEAD);
+      const uint32_t rd = (now_ - LOOKAHEAD) & MASK;
+      left[i] = delayL_[rd] * g;
+      right[i] = delayR_[rd] * g;
+    }
+    // 加減算の誤差が溜まらないよう、合計を計算し直す
+    float sum = 0;
+    for (uint32_t k = 0; k < LOOKAHEAD; ++k)
+    {
+      sum += hold_[(now_ - 1 - k) & MASK];
+    }
+    sum_ = sum;
+  }
+};
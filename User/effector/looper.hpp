@@ -0,0 +1,347 @@
+/// @file      effector/looper.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "common/alloc.hpp"
+#include "effector_base.h"
+#include "lib/lib_calc.hpp"
+#include "lib/lib_loop_sram.hpp"
+#include "message/type.h"
+#include "task/handles.h"
+#include <atomic>
+#include <cstdio>  // sprintf
+#include <cstring> // memcpy
+
+namespace satoh
+{
+namespace fx
+{
+class Looper;
+}
+} // namespace satoh
+
+/// @brief ルーパー（SPI SRAM に録音・再生・重ね録り）
+/// @note TAP : 空 → 録音 → 再生 → 重ね録り → 再生 ...、停止中 → 再生（先頭から）
+///   選択中のパッチのエフェクトボタン : 録音・再生・重ね録り → 停止、停止中 → 消去
+///   SRAM との通信は転送タスクに任せ（LoopSram）、ループ位置の LEAD ブロック先を先読みしておく。
+///   先頭 LEAD ブロックは RAM に持つので、再生開始直後も SRAM の読み出しを待たない。
+///   最大ループ長は保存形式（FMT）で決まる（8bit 約2.9秒 16bit 約1.4秒 float 約0.7秒）。
+///   FMT を変えるとループは消去される（新しい保存形式は消去と同時に音声タスクで反映する）。
+class satoh::fx::Looper : public satoh::fx::EffectorBase
+{
+  enum
+  {
+    LEVEL = 0, ///< ループ再生レベル
+    FORMAT,    ///< 保存形式
+    COUNT,     ///< パラメータ総数
+  };
+  /// @brief 状態
+  enum State : uint8_t
+  {
+    EMPTY = 0, ///< 空
+    RECORD,    ///< 録音中
+    PLAY,      ///< 再生中
+    OVERDUB,   ///< 重ね録り中
+    STOP,      ///< 停止中
+  };
+  /// @brief ボタン操作（音声タスクへの受け渡し 複数の操作が同じブロックで届いても失わないようビット毎に持つ）
+  enum Operation : uint8_t
+  {
+    OP_NONE = 0,       ///< なし
+    OP_TAP = 1 << 0,   ///< TAPボタン
+    OP_KEY = 1 << 1,   ///< エフェクトボタン
+    OP_CLEAR = 1 << 2, ///< 消去（保存形式の変更）
+  };
+
+  static constexpr uint32_t LEAD = 4;                           ///< 先読みするブロック数（転送タスクの遅れの許容量 約8.6ms）
+  static constexpr uint32_t HEAD = LEAD * BLOCK_SIZE;           ///< RAM に持つ先頭のサンプル数
+  static constexpr uint32_t MIN_LENGTH = 2 * HEAD + BLOCK_SIZE; ///< 最小ループ長（先読み結果の前後判定に必要）
+
+  EffectParameterF ui_[COUNT];      ///< UIから設定するパラメータ
+  mutable char valueTxt_[8];        ///< パラメータ文字列格納バッファ
+  LoopSram sram_;                   ///< SPI SRAM 転送
+  UniquePtr<float> head_;           ///< ループ先頭 HEAD サンプル
+  LoopSram::Request req_;           ///< 今回のブロックの要求
+  float loop_[BLOCK_SIZE];          ///< ループ再生音
+  std::atomic<uint8_t> operation_;  ///< 未処理のボタン操作（Operation のビット和）
+  std::atomic<uint8_t> nextFormat_; ///< 次の消去で反映する保存形式（UIから設定）
+  float level_;                     ///< ループ再生レベル
+  LoopSram::Format format_;         ///< 保存形式（音声タスクのみ参照）
+  uint32_t maxLength_;              ///< 最大ループ長（サンプル数 音声タスクのみ参照）
+  State state_;                     ///< 状態
+  uint32_t pos_;                    ///< 現在のブロックのループ内位置（サンプル数）
+  uint32_t length_;                 ///< ループ長（サンプル数 録音中は録音済みの長さ）
+  uint32_t gen_;                    ///< 世代（停止・消去で更新し、古い先読み結果を捨てる）
+
+  /// @brief 最大ループ長をミリ秒で取得
+  /// @param [in] format 保存形式
+  /// @return 最大ループ長（ミリ秒）
+  static uint32_t getMaxLengthMs(LoopSram::Format format) noexcept
+  {
+    return static_cast<uint32_t>(1000.0f * LoopSram::getMaxLength(format) / SAMPLING_FREQ);
+  }
+  /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
+  /// @param [in] n 変換対象のパラメータ番号
+  void convUiToFx(uint8_t n) noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+      level_ = dbToGain(ui_[LEVEL].getValue()); // LEVEL -20...+20 dB
+      break;
+    case FORMAT:
+    {
+      // 保存形式は音声タスクが録音・再生中に使うので、ここでは変えずに消去と一緒に反映してもらう
+      const auto format = static_cast<uint8_t>(ui_[FORMAT].getValue());
+      if (format != nextFormat_.load())
+      {
+        nextFormat_ = format;
+        operation_.fetch_or(OP_CLEAR);
+      }
+      break;
+    }
+    }
+  }
+  /// @brief パラメータ値文字列取得
+  /// @param [in] n パラメータ番号
+  /// @return 文字列のポインタ
+  const char *getValueTxtImpl(uint8_t n) const noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+    {
+      int v = static_cast<int>(ui_[n].getValue());
+      if (v <= 0)
+      {
+        sprintf(valueTxt_, "%d", v);
+      }
+      else
+      {
+        sprintf(valueTxt_, "+%d", v);
+      }
+      return valueTxt_;
+    }
+    case FORMAT:
+    {
+      static const char *const NAME[] = {"8bit", "16bit", "float"};
+      return NAME[static_cast<uint32_t>(ui_[n].getValue())];
+    }
+    default:
+      return 0;
+    }
+  }
+  /// @brief ボタン操作で状態を変える
+  /// @param [in] op ボタン操作（1つ）
+  void operate(Operation op) noexcept
+  {
+    switch (op)
+    {
+    case OP_TAP:
+      switch (state_)
+      {
+      case EMPTY:
+        state_ = RECORD;
+        pos_ = length_ = 0;
+        break;
+      case RECORD:
+        if (MIN_LENGTH <= pos_)
+        {
+          state_ = PLAY;
+          length_ = pos_;
+          pos_ = 0;
+        }
+        break;
+      case PLAY:
+        state_ = OVERDUB;
+        break;
+      case OVERDUB:
+        state_ = PLAY;
+        break;
+      case STOP:
+        state_ = PLAY;
+        pos_ = 0;
+        ++gen_;
+        break;
+      }
+      break;
+    case OP_KEY:
+      switch (state_)
+      {
+      case RECORD:
+        state_ = MIN_LENGTH <= pos_ ? STOP : EMPTY;
+        length_ = pos_;
+        ++gen_;
+        break;
+      case PLAY:
+      case OVERDUB:
+        state_ = STOP;
+        ++gen_;
+        break;
+      case STOP:
+        state_ = EMPTY;
+        break;
+      default:
+        break;
+      }
+      break;
+    case OP_CLEAR:
+      format_ = static_cast<LoopSram::Format>(nextFormat_.load());
+      maxLength_ = LoopSram::getMaxLength(format_);
+      state_ = EMPTY;
+      ++gen_;
+      break;
+    default:
+      break;
+    }
+  }
+  /// @brief 現在のブロックをループに書き込む先を取得（先頭 HEAD サンプルは RAM、それ以降は SRAM への要求）
+  /// @return 書き込み先（BLOCK_SIZE分）
+  float *store() noexcept
+  {
+    if (pos_ < HEAD)
+    {
+      return head_.get() + pos_;
+    }
+    req_.write = true;
+    req_.wpos = pos_;
+    return req_.data;
+  }
+  /// @brief ループを読み出す（SRAM の分は LEAD ブロック前に先読みを要求した結果）
+  /// @retval true 成功
+  /// @retval false 先読みが間に合わなかった
+  bool load() noexcept
+  {
+    if (pos_ < HEAD)
+    {
+      memcpy(loop_, head_.get() + pos_, BLOCK_SIZE * sizeof(float));
+      return true;
+    }
+    return sram_.fetch(gen_, pos_, length_, loop_);
+  }
+
+public:
+  /// @brief コンストラクタ
+  /// @param [in] spi SPI通信オブジェクト
+  explicit Looper(SpiMaster *spi)                                  //
+      : EffectorBase(LOOPER, "Looper", "LP", RGB{0x20, 0x00, 0x08}), //
+        ui_{
+            EffectParameterF(-20, 20, 0, 1, "LV"), //
+            EffectParameterF(0, 2, 1, 1, "FMT"),   //
+        },                                           //
+        sram_(spi),                                  //
+        head_(allocArray<float>(HEAD)),              //
+        req_{},                                      //
+        operation_(OP_NONE),                         //
+        nextFormat_(LoopSram::INT16),                //
+        level_(1),                                   //
+        format_(LoopSram::INT16),                    //
+        maxLength_(LoopSram::getMaxLength(format_)), //
+        state_(EMPTY),                               //
+        pos_(0),                                     //
+        length_(0),                                  //
+        gen_(0)                                      //
+  {
+    if (*this)
+    {
+      init(ui_, COUNT);
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~Looper() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return sram_ && head_; }
+  /// @brief エフェクト処理実行
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数（BLOCK_SIZE）
+  void effect(float *left, float *right, uint32_t size) noexcept override
+  {
+    // 消去（保存形式の変更）を先に行い、同じブロックに届いたボタン操作は新しい保存形式で扱う
+    const uint8_t op = operation_.exchange(OP_NONE);
+    static const Operation ORDER[] = {OP_CLEAR, OP_KEY, OP_TAP};
+    for (Operation o : ORDER)
+    {
+      if (op & o)
+      {
+        operate(o);
+      }
+    }
+    if (state_ == EMPTY || state_ == STOP)
+    {
+      return;
+    }
+    req_.gen = gen_;
+    req_.format = format_;
+    req_.write = false;
+    req_.read = false;
+    if (state_ == RECORD)
+    {
+      memcpy(store(), right, size * sizeof(float));
+      pos_ += BLOCK_SIZE;
+      if (maxLength_ <= pos_)
+      {
+        state_ = PLAY; // 最大ループ長に達したら再生へ
+        length_ = pos_;
+        pos_ = 0;
+      }
+    }
+    else
+    {
+      if (load())
+      {
+        if (state_ == OVERDUB)
+        {
+          float *dst = store();
+          for (uint32_t i = 0; i < size; ++i)
+          {
+            dst[i] = loop_[i] + right[i];
+          }
+        }
+        for (uint32_t i = 0; i < size; ++i)
+        {
+          right[i] += level_ * loop_[i];
+        }
+      }
+      // LEAD ブロック先を先読みする（先頭 HEAD サンプルは RAM にある）
+      const uint32_t ahead = (pos_ + HEAD) % length_;
+      if (HEAD <= ahead)
+      {
+        req_.read = true;
+        req_.rpos = ahead;
+      }
+      pos_ = (pos_ + BLOCK_SIZE) % length_;
+    }
+    if ((req_.write || req_.read) && sram_.post(req_))
+    {
+      msg::SRAM_LOOP cmd{&sram_};
+      msg::send(sramTaskHandle, msg::SRAM_LOOP_NOTIFY, cmd);
+    }
+  }
+  /// @brief TAPボタンが押されたことを通知する
+  void notifyTap() noexcept override { operation_.fetch_or(OP_TAP); }
+  /// @brief 選択中のパッチのエフェクトボタンが押されたことを通知する
+  /// @retval true 停止・消去に使う
+  bool notifyEffectKey() noexcept override
+  {
+    operation_.fetch_or(OP_KEY);
+    return true;
+  }
+  /// @brief 保存形式毎の最大ループ長を文字列にする
+  /// @param [out] buf 格納先
+  /// @param [in] size 格納先サイズ
+  /// @return 文字数
+  static int getMaxLengthTxt(char *buf, size_t size) noexcept
+  {
+    return snprintf(buf, size, "[LOOPER] max 8bit %lums 16bit %lums float %lums\r\n", //
+                    static_cast<unsigned long>(getMaxLengthMs(LoopSram::INT8)),         //
+                    static_cast<unsigned long>(getMaxLengthMs(LoopSram::INT16)),        //
+                    static_cast<unsigned long>(getMaxLengthMs(LoopSram::FLOAT)));
+  }
+};
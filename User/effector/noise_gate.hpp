@@ -0,0 +1,213 @@
+/// @file      effector/noise_gate.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "effector_base.h"
+#include "lib/lib_calc.hpp"
+#include <algorithm>
+#include <cmath>  // exp, abs
+#include <cstdio> // sprintf
+
+namespace satoh
+{
+namespace fx
+{
+class NoiseGate;
+}
+} // namespace satoh
+
+/// @brief ノイズゲート（RANGE を上げるとエキスパンダー）
+/// @note 検出はブロック単位で行う。ブロック内の最大振幅をピークホールドし、
+///   THRE 以上で開き、THRE - HYST を下回ってから HOLD 経過後に閉じる（dB変換せず振幅のまま比較する）。
+///   倍率はサンプル毎に1次平滑化で ATK / REL の時定数で追従させる。
+///   閉じ終わった後は一定の倍率を掛けるだけにし、RANGE が -Inf ならば isOutputSilent() で後段に処理の省略を許す。
+class satoh::fx::NoiseGate : public satoh::fx::EffectorBase
+{
+  enum
+  {
+    THRESHOLD,  ///< 開く閾値
+    HYSTERESIS, ///< 閉じる閾値との差
+    ATTACK,     ///< アタック
+    HOLD,       ///< ホールド
+    RELEASE,    ///< リリース
+    RANGE,      ///< 閉じた時の減衰量
+    COUNT,      ///< パラメータ総数
+  };
+
+  static constexpr float DETECT_MS = 10.0f; ///< 検出用ピークホールドの減衰時定数（ミリ秒）
+  static constexpr float SETTLE = 1.0e-3f;  ///< 閉じ終わったとみなす倍率の差（-60dB）
+
+  EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
+  mutable char valueTxt_[8];   ///< パラメータ文字列格納バッファ
+  float openLevel_;            ///< THRESHOLD 振幅 -90～-20dB
+  float closeLevel_;           ///< THRESHOLD - HYSTERESIS 振幅
+  float attack_;               ///< ATTACK 係数 1～50ms
+  uint32_t holdBlocks_;        ///< HOLD ブロック数 0～500ms
+  float release_;              ///< RELEASE 係数 10～1000ms
+  float floor_;                ///< RANGE 閉じた時の倍率 -Inf, -89～0dB
+  const float detect_;         ///< 検出用ピークホールドのブロック毎の減衰率
+  float level_;                ///< 検出レベル（振幅）
+  uint32_t hold_;              ///< ホールド残りブロック数
+  bool open_;                  ///< 開いているか
+  float gain_;                 ///< 現在の倍率
+  bool silent_;                ///< 直近のブロックを無音で出力したか
+
+  /// @brief 時定数から1次平滑化の係数を求める
+  /// @param [in] ms 時定数（ミリ秒）
+  /// @return 係数
+  static float coef(float ms) noexcept { return std::exp(-1000.0f / (ms * SAMPLING_FREQ)); }
+  /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
+  /// @param [in] n 変換対象のパラメータ番号
+  void convUiToFx(uint8_t n) noexcept override
+  {
+    float v = ui_[n].getValue();
+    switch (n)
+    {
+    case THRESHOLD:
+    case HYSTERESIS:
+      openLevel_ = dbToGain(ui_[THRESHOLD].getValue());
+      closeLevel_ = dbToGain(ui_[THRESHOLD].getValue() - ui_[HYSTERESIS].getValue());
+      break;
+    case ATTACK:
+      attack_ = coef(v);
+      break;
+    case HOLD:
+      holdBlocks_ = static_cast<uint32_t>(v * SAMPLING_FREQ / (1000.0f * BLOCK_SIZE) + 0.5f);
+      break;
+    case RELEASE:
+      release_ = coef(v);
+      break;
+    case RANGE:
+      floor_ = ui_[RANGE].getMin() < v ? dbToGain(v) : 0.0f;
+      break;
+    }
+  }
+  /// @brief パラメータ値文字列取得
+  /// @param [in] n パラメータ番号
+  /// @return 文字列のポインタ
+  const char *getValueTxtImpl(uint8_t n) const noexcept override
+  {
+    switch (n)
+    {
+    case THRESHOLD:
+    case HYSTERESIS:
+    case ATTACK:
+    case HOLD:
+    case RELEASE:
+      sprintf(valueTxt_, "%d", static_cast<int>(ui_[n].getValue()));
+      return valueTxt_;
+    case RANGE:
+      if (ui_[RANGE].getValue() <= ui_[RANGE].getMin())
+      {
+        return "-Inf";
+      }
+      sprintf(valueTxt_, "%d", static_cast<int>(ui_[n].getValue()));
+      return valueTxt_;
+    default:
+      return 0;
+    }
+  }
+  /// @brief ブロックの最大振幅から開閉状態を更新する
+  /// @param [in] peak ブロックの最大振幅
+  void detect(float peak) noexcept
+  {
+    level_ = std::max(peak, level_ * detect_);
+    if (openLevel_ <= level_ || (open_ && closeLevel_ <= level_))
+    {
+      open_ = true;
+      hold_ = holdBlocks_;
+    }
+    else if (0 < hold_)
+    {
+      --hold_;
+    }
+    else
+    {
+      open_ = false;
+    }
+  }
+
+public:
+  /// @brief コンストラクタ
+  NoiseGate()
+      : EffectorBase(NOISE_GATE, "Noise Gate", "NG", RGB{0x08, 0x08, 0x08}), // エフェクター名、短縮エフェクター名、LED色
+        ui_{
+            EffectParameterF(-90, -20, -60, 1, "THRE"),                         //
+            EffectParameterF(0, 20, 6, 1, "HYST"),                              //
+            EffectParameterF(1, 50, 1, 1, "ATK"),                               //
+            EffectParameterF(0, 500, 50, 10, "HOLD"),                           //
+            EffectParameterF(10, 1000, 100, 10, "REL"),                         //
+            EffectParameterF(-90, 0, -90, 1, "RANGE"),                          //
+        },                                                                      //
+        detect_(std::exp(-1000.0f * BLOCK_SIZE / (DETECT_MS * SAMPLING_FREQ))), //
+        level_(0),                                                              //
+        hold_(0),                                                               //
+        open_(false),                                                           //
+        gain_(0),                                                               //
+        silent_(false)                                                          //
+  {
+    init(ui_, COUNT);
+  }
+  /// @brief デストラクタ
+  virtual ~NoiseGate() {}
+  /// @brief エフェクト処理実行
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数
+  void effect(float *left, float *right, uint32_t size) noexcept override
+  {
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      peak = std::max(peak, std::abs(right[i]));
+    }
+    detect(peak);
+    const float target = open_ ? 1.0f : floor_;
+    if (!open_ && std::abs(gain_ - floor_) < SETTLE)
+    {
+      // 閉じ終わっている 倍率は一定
+      gain_ = floor_;
+      silent_ = floor_ == 0.0f;
+      for (uint32_t i = 0; i < size; ++i)
+      {
+        left[i] *= gain_;
+        right[i] *= gain_;
+      }
+      return;
+    }
+    silent_ = false;
+    const float a = target < gain_ ? release_ : attack_;
+    float g = gain_;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      g = target + a * (g - target);
+      left[i] *= g;
+      right[i] *= g;
+    }
+    gain_ = g;
+  }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数（検出レベルの減衰 + HOLD + 倍率が RANGE に落ち着くまで）
+  uint32_t getTailLength() const noexcept override
+  {
+    const float ms = 13.8155106f * DETECT_MS + ui_[HOLD].getValue() + 6.90775528f * ui_[RELEASE].getValue(); // ln(10^6), ln(1/SETTLE)
+    return static_cast<uint32_t>(0.001f * ms * SAMPLING_FREQ) + BLOCK_SIZE;
+  }
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  void clearState() noexcept override
+  {
+    level_ = 0;
+    hold_ = 0;
+    open_ = false;
+    gain_ = floor_;
+    silent_ = floor_ == 0.0f;
+  }
+  /// @brief 直近のブロックを無音で出力したか
+  /// @retval true 完全に閉じている（RANGE が -Inf の時のみ）
+  /// @retval false 音を出力している
+  bool isOutputSilent() const noexcept override { return silent_; }
+};
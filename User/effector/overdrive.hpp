@@ -122,4 +122,15 @@ public:
       right[i] = fx;
     }
   }
+  /// @brief 入力が無音になってから、出力と内部状態が落ち着くまでのサンプル数を取得
+  /// @return サンプル数
+  uint32_t getTailLength() const noexcept override { return iirTail(30.0f); } // 出力ローカット 30Hz が最も遅い
+  /// @brief 内部状態を、無音を入力し続けた状態にする
+  void clearState() noexcept override
+  {
+    hpfBass.reset();
+    lpfFixed.reset();
+    hpfFixed.reset(atanf(0.0f * gain_ + 0.5f)); // 無音でも非対称化による直流が入る（effect() と同じ計算で求める）
+    lpfTreble.reset();
+  }
 };
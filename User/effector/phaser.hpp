@@ -8,7 +8,7 @@
 
 #include "effector_base.h"
 #include "lib/lib_filter.hpp"
-#include "lib/lib_osc.hpp"
+#include "lib/lib_lfo.hpp"
 #include <cstdio> // sprintf
 
 namespace satoh
@@ -27,15 +27,18 @@ class satoh::fx::Phaser : public satoh::fx::EffectorBase
     LEVEL = 0, ///< レベル
     RATE,      ///< 周期
     STAGE,     ///< ステージ
+    SYNC,      ///< テンポ同期（音符の長さ）
     COUNT,     ///< パラメータ総数
   };
 
   EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
   mutable char valueTxt_[8];   ///< パラメータ文字列格納バッファ
-  TriangleWave tri;
+  LfoPool::Handle lfoHandle_;  ///< LFO 購読情報
   apf apfx[12];
-  float level_; ///< レベル
-  float stage_; ///< ステージ
+  float level_;            ///< レベル
+  float stage_;            ///< ステージ
+  float freq_;             ///< LFO 周波数
+  float work_[BLOCK_SIZE]; ///< APF周波数の作業領域
 
   /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
   /// @param [in] n 変換対象のパラメータ番号
@@ -47,9 +50,10 @@ class satoh::fx::Phaser : public satoh::fx::EffectorBase
       level_ = logPot(ui_[LEVEL].getValue(), -20.0f, 20.0f); // LEVEL -20～20 dB
       break;
     case RATE:
+    case SYNC:
     {
       float rate = 0.02f * (105.0f - ui_[RATE].getValue()); // RATE 周期 2.1～0.1 秒
-      tri.set(1.0f / rate);                                 // 三角波 周波数設定
+      freq_ = 1.0f / rate;                                  // 三角波 周波数設定（テンポ同期中は未使用）
       break;
     }
     case STAGE:
@@ -69,6 +73,8 @@ class satoh::fx::Phaser : public satoh::fx::EffectorBase
     case STAGE:
       sprintf(valueTxt_, "%d", static_cast<int>(ui_[n].getValue()));
       return valueTxt_;
+    case SYNC:
+      return TempoClock::getDivisionName(static_cast<uint8_t>(ui_[n].getValue()));
     default:
       return 0;
     }
@@ -79,10 +85,13 @@ public:
   Phaser()                                                          //
       : EffectorBase(PHASER, "Phaser", "PH", RGB{0x8, 0x20, 0x00}), //
         ui_{
-            EffectParameterF(0, 100, 1, "LEVEL"), //
-            EffectParameterF(0, 100, 1, "RATE"),  //
-            EffectParameterF(1, 6, 1, "STAGE"),   //
-        }                                         //
+            EffectParameterF(0, 100, 1, "LEVEL"),                              //
+            EffectParameterF(0, 100, 1, "RATE"),                               //
+            EffectParameterF(1, 6, 1, "STAGE"),                                //
+            EffectParameterF(0, TempoClock::DIVISION_COUNT - 1, 0, 1, "SYNC"), //
+        },                                                                     //
+        lfoHandle_{},                                                          //
+        freq_(1)                                                               //
   {
     init(ui_, COUNT);
   }
@@ -91,14 +100,21 @@ public:
   /// @brief エフェクト処理実行
   /// @param[inout] left L音声データ
   /// @param[inout] right R音声データ
-  /// @param [in] size 音声データ数
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
   void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    const auto div = static_cast<uint8_t>(ui_[SYNC].getValue());
+    float const *lfo = LfoPool::get(lfo_, lfoHandle_, LfoPool::TRIANGLE, freq_, div, 0.0f); // テンポ同期中は共有のテンポクロックの位相
+    float *work = work_;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      work[i] = 20.0f * lfo[i]; // LFO 0～20 三角波
+    }
+    dbToGain(work, work, size); // 指数的変化
     for (uint32_t i = 0; i < size; ++i)
     {
       float fx = right[i];
-      float lfo = 20.0f * tri.output();    // LFO 0～20 三角波
-      float freq = 200.0f * dbToGain(lfo); // APF周波数 200～2000Hz 指数的変化
+      float freq = 200.0f * work[i];       // APF周波数 200～2000Hz
       for (uint8_t j = 0; j < stage_; j++) // 段数分APF繰り返し
       {
         apfx[j].set(freq);        // APF周波数設定
@@ -0,0 +1,126 @@
+/// @file      effector/pitch_shifter.hpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "effector_base.h"
+#include "lib/lib_calc.hpp"
+#include "lib/lib_pitch_shift.hpp"
+#include <cstdio> // snprintf
+
+namespace satoh
+{
+namespace fx
+{
+class PitchShifter;
+}
+} // namespace satoh
+
+/// @brief ピッチシフター（±12半音 オクターバーとしても使う）
+class satoh::fx::PitchShifter : public satoh::fx::EffectorBase
+{
+  enum
+  {
+    LEVEL = 0, ///< レベル
+    MIX,       ///< ミックス
+    SEMI,      ///< 半音
+    FINE,      ///< 微調整
+    COUNT,     ///< パラメータ総数
+  };
+
+  EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
+  mutable char valueTxt_[12];  ///< パラメータ文字列格納バッファ（intの最大桁数まで）
+  PitchShift shift_;           ///< ピッチシフト
+  float wet_[BLOCK_SIZE];      ///< ピッチシフト音
+  float level_;                ///< レベル
+  float mix_;                  ///< ミックス
+
+  /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
+  /// @param [in] n 変換対象のパラメータ番号
+  void convUiToFx(uint8_t n) noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+      level_ = dbToGain(ui_[LEVEL].getValue()); // LEVEL -20...+20 dB
+      break;
+    case MIX:
+      mix_ = mixPot(ui_[MIX].getValue(), -20.0f); // MIX
+      break;
+    case SEMI:
+    case FINE:
+      shift_.setSemitone(ui_[SEMI].getValue() + ui_[FINE].getValue() / 100.0f); // -12...+12 半音、-50...+50 セント
+      break;
+    }
+  }
+  /// @brief パラメータ値文字列取得
+  /// @param [in] n パラメータ番号
+  /// @return 文字列のポインタ
+  const char *getValueTxtImpl(uint8_t n) const noexcept override
+  {
+    switch (n)
+    {
+    case LEVEL:
+    case SEMI:
+    case FINE:
+    {
+      int v = static_cast<int>(ui_[n].getValue());
+      if (v <= 0)
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "%d", v);
+      }
+      else
+      {
+        snprintf(valueTxt_, sizeof(valueTxt_), "+%d", v);
+      }
+      return valueTxt_;
+    }
+    case MIX:
+      snprintf(valueTxt_, sizeof(valueTxt_), "%d", static_cast<int>(ui_[n].getValue()));
+      return valueTxt_;
+    default:
+      return 0;
+    }
+  }
+
+public:
+  /// @brief コンストラクタ
+  PitchShifter()                                                                   //
+      : EffectorBase(PITCH_SHIFTER, "Pitch Shifter", "PS", RGB{0x20, 0x10, 0x00}), //
+        ui_{
+            EffectParameterF(-20, 20, 0, 1, "LV"),     //
+            EffectParameterF(0, 100, 50, 1, "MIX"),    //
+            EffectParameterF(-12, 12, -12, 1, "SEMI"), //
+            EffectParameterF(-50, 50, 0, 1, "FINE"),   //
+        },                                             //
+        level_(1),                                     //
+        mix_(1)                                        //
+  {
+    if (*this)
+    {
+      init(ui_, COUNT);
+    }
+  }
+  /// @brief デストラクタ
+  virtual ~PitchShifter() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return static_cast<bool>(shift_); }
+  /// @brief エフェクト処理実行
+  /// @param[inout] left L音声データ
+  /// @param[inout] right R音声データ
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
+  void effect(float *left, float *right, uint32_t size) noexcept override
+  {
+    shift_.process(right, wet_, size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      float fx = (1.0f - mix_) * right[i] + mix_ * wet_[i];
+      right[i] = level_ * fx;
+    }
+  }
+};
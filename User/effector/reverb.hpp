@@ -6,10 +6,9 @@
 
 #pragma once
 
-#include "common/utils.h"
 #include "effector_base.h"
 #include "lib/lib_calc.hpp"
-#include "lib/lib_delay.hpp"
+#include "lib/lib_fdn.hpp"
 #include "lib/lib_filter.hpp"
 #include <cstdio> // sprintf
 
@@ -21,15 +20,15 @@ class Reverb;
 }
 } // namespace satoh
 
-/// @brief エフェクタークラスの実装参考用テンプレート
+/// @brief FDN（8ライン）リバーブ
 class satoh::fx::Reverb : public satoh::fx::EffectorBase
 {
   enum
   {
     LEVEL = 0, ///< レベル
     MIX,       ///< ミックス
-    FBACK,     ///< フィードバック
-    HICUT,     ///< ハイカット
+    DECAY,     ///< 残響時間
+    SIZE,      ///< 部屋の大きさ
     LOCUT,     ///< ローカット
     HIDUMP,    ///< ハイダンプ
     COUNT,     ///< パラメータ総数
@@ -37,15 +36,13 @@ class satoh::fx::Reverb : public satoh::fx::EffectorBase
 
   EffectParameterF ui_[COUNT]; ///< UIから設定するパラメータ
   mutable char valueTxt_[8];   ///< パラメータ文字列格納バッファ
-  using Buffer = delayBuf<float>;
-  Buffer del[10];
-  lpf lpfIn;
-  lpf lpfFB[4];
-  hpf hpfOutL;
-  hpf hpfOutR;
-  float level_;
-  float mix_;
-  float fback_;
+  Fdn<8> fdn_;                 ///< 残響生成部
+  hpf hpfOutL;                 ///< L残響音ローカット
+  hpf hpfOutR;                 ///< R残響音ローカット
+  float wetL_[BLOCK_SIZE];     ///< L残響音
+  float wetR_[BLOCK_SIZE];     ///< R残響音
+  float level_;                ///< レベル
+  float mix_;                  ///< ミックス
 
   /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
   /// @param [in] n 変換対象のパラメータ番号
@@ -59,15 +56,12 @@ class satoh::fx::Reverb : public satoh::fx::EffectorBase
     case MIX:
       mix_ = mixPot(ui_[MIX].getValue(), -20.0f); // MIX
       break;
-    case FBACK:
-      fback_ = ui_[FBACK].getValue() / 200.0f; // Feedback 0～0.495
+    case DECAY:
+      fdn_.setDecay(0.3f * logPot(ui_[DECAY].getValue(), 0.0f, 30.0f)); // 残響時間 0.3 ～ 9.5 秒
       break;
-    case HICUT:
-    {
-      float hicut = 600.0f * logPot(ui_[HICUT].getValue(), 20.0f, 0.0f); // HI CUT FREQ 600 ~ 6000 Hz
-      lpfIn.set(hicut);
+    case SIZE:
+      fdn_.setSize(0.3f + 0.007f * ui_[SIZE].getValue()); // ディレイ長 30 ～ 100 %
       break;
-    }
     case LOCUT:
     {
       float locut = 100.0f * logPot(ui_[LOCUT].getValue(), 0.0f, 20.0f); // LOW CUT FREQ 100 ~ 1000 Hz
@@ -78,10 +72,7 @@ class satoh::fx::Reverb : public satoh::fx::EffectorBase
     case HIDUMP:
     {
       float hidump = 600.0f * logPot(ui_[HIDUMP].getValue(), 20.0f, 0.0f); // Feedback HI CUT FREQ 600 ~ 6000 Hz
-      lpfFB[0].set(hidump);
-      lpfFB[1].set(hidump);
-      lpfFB[2].set(hidump);
-      lpfFB[3].set(hidump);
+      fdn_.setDamp(hidump);
       break;
     }
     }
@@ -95,8 +86,8 @@ class satoh::fx::Reverb : public satoh::fx::EffectorBase
     {
     case LEVEL:
     case MIX:
-    case FBACK:
-    case HICUT:
+    case DECAY:
+    case SIZE:
     case LOCUT:
     case HIDUMP:
     {
@@ -115,85 +106,37 @@ public:
         ui_{
             EffectParameterF(0, 100, 1, "LEVEL"),  //
             EffectParameterF(0, 100, 1, "MIX"),    //
-            EffectParameterF(0, 99, 1, "F.BACK"),  //
-            EffectParameterF(0, 100, 1, "HiCUT"),  //
+            EffectParameterF(0, 100, 1, "DECAY"),  //
+            EffectParameterF(0, 100, 1, "SIZE"),   //
             EffectParameterF(0, 100, 1, "LoCUT"),  //
             EffectParameterF(0, 100, 1, "HiDUMP"), //
         },                                         //
+        fdn_({1031, 1153, 1297, 1439, 1601, 1783, 1979, 2203}), // 各ラインの最大遅延（互いに素）
         level_(0),                                 //
-        mix_(0),                                   //
-        fback_(0)                                  //
+        mix_(0)                                    //
   {
-    constexpr float dt[] = {43.5337f, 25.796f,  19.392f,  16.364f,  7.645f, //
-                            4.2546f,  58.6435f, 69.4325f, 74.5234f, 86.1244f};
-    for (uint32_t i = 0; i < countof(dt); i++)
+    if (*this)
     {
-      del[i] = Buffer(dt[i]); // ディレイタイム設定
-      del[i].setInterval(dt[i]);
+      init(ui_, COUNT);
     }
-    init(ui_, COUNT);
   }
   /// @brief デストラクタ
   virtual ~Reverb() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return static_cast<bool>(fdn_); }
   /// @brief エフェクト処理実行
   /// @param[inout] left L音声データ
   /// @param[inout] right R音声データ
   /// @param [in] size 音声データ数
   void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    fdn_.process(right, wetL_, wetR_, size);
     for (uint32_t i = 0; i < size; ++i)
     {
-      float fxR = right[i];
-      fxR = 0.25f * lpfIn.process(fxR);
-
-      // Early Reflection
-
-      del[0].write(fxR);
-      float ap = fxR + del[0].readLerp();
-      float am = fxR - del[0].readLerp();
-      del[1].write(am);
-      float bp = ap + del[1].readLerp();
-      float bm = ap - del[1].readLerp();
-      del[2].write(bm);
-      float cp = bp + del[2].readLerp();
-      float cm = bp - del[2].readLerp();
-      del[3].write(cm);
-      float dp = cp + del[3].readLerp();
-      float dm = cp - del[3].readLerp();
-      del[4].write(dm);
-      float ep = dp + del[4].readLerp();
-      float em = dp - del[4].readLerp();
-      del[5].write(em);
-
-      // Late Reflection & High Freq Dumping
-
-      float hd = del[6].readLerp();
-      hd = lpfFB[0].process(hd);
-
-      float id = del[7].readLerp();
-      id = lpfFB[1].process(id);
-
-      float jd = del[8].readLerp();
-      jd = lpfFB[2].process(jd);
-
-      float kd = del[9].readLerp();
-      kd = lpfFB[3].process(kd);
-
-      float outR = ep + hd * fback_;
-      float outL = del[5].readLerp() + id * fback_;
-
-      float fp = outL + outR;
-      float fm = outL - outR;
-      float gp = jd * fback_ + kd * fback_;
-      float gm = jd * fback_ - kd * fback_;
-      del[6].write(fp + gp);
-      del[7].write(fm + gm);
-      del[8].write(fp - gp);
-      del[9].write(fm - gm);
-
-      fxR = (1.0f - mix_) * right[i] + mix_ * hpfOutR.process(outR);
-      float fxL = (1.0f - mix_) * left[i] + mix_ * hpfOutL.process(outL);
-
+      float fxL = (1.0f - mix_) * left[i] + mix_ * hpfOutL.process(wetL_[i]);
+      float fxR = (1.0f - mix_) * right[i] + mix_ * hpfOutR.process(wetR_[i]);
       left[i] = level_ * fxL;
       right[i] = level_ * fxR;
     }
@@ -8,7 +8,7 @@
 
 #include "effector_base.h"
 #include "lib/lib_calc.hpp"
-#include "lib/lib_osc.hpp"
+#include "lib/lib_lfo.hpp"
 #include <cstdio> // sprintf
 
 namespace satoh
@@ -28,6 +28,7 @@ class satoh::fx::Tremolo : public satoh::fx::EffectorBase
     RATE,      ///< 周期
     DEPTH,     ///< 深さ
     WAVE,      ///< 波形
+    SYNC,      ///< テンポ同期（音符の長さ）
     COUNT,     ///< パラメータ総数
   };
 
@@ -36,7 +37,9 @@ class satoh::fx::Tremolo : public satoh::fx::EffectorBase
   float level_;                ///< レベル
   float wave_;                 ///< 波形
   float depth_;                ///< 深さ
-  TriangleWave tri;            ///< 周期
+  LfoPool::Handle lfoHandle_;  ///< LFO 購読情報
+  float freq_;                 ///< LFO 周波数
+  float work_[BLOCK_SIZE];     ///< 音量の作業領域
 
   /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
   /// @param [in] n 変換対象のパラメータ番号
@@ -48,9 +51,10 @@ class satoh::fx::Tremolo : public satoh::fx::EffectorBase
       level_ = logPot(ui_[LEVEL].getValue(), -20.0f, 20.0f); // LEVEL -20～20 dB
       break;
     case RATE:
+    case SYNC:
     {
       float rate = 0.01f * (105.0f - ui_[RATE].getValue()); // RATE 周期 1.05～0.05 秒
-      tri.set(1.0f / rate);                                 // 三角波 周波数設定
+      freq_ = 1.0f / rate;                                  // 三角波 周波数設定（テンポ同期中は未使用）
       break;
     }
     case DEPTH:
@@ -74,6 +78,8 @@ class satoh::fx::Tremolo : public satoh::fx::EffectorBase
     case DEPTH:
       sprintf(valueTxt_, "%d", static_cast<int>(ui_[n].getValue()));
       return valueTxt_;
+    case SYNC:
+      return TempoClock::getDivisionName(static_cast<uint8_t>(ui_[n].getValue()));
     default:
       return 0;
     }
@@ -84,14 +90,17 @@ public:
   Tremolo()                                                            //
       : EffectorBase(TREMOLO, "Tremolo", "TR", RGB{0x00, 0x20, 0x00}), //
         ui_{
-            EffectParameterF(1, 100, 1, "LEVEL"), //
-            EffectParameterF(1, 100, 1, "RATE"),  //
-            EffectParameterF(1, 100, 1, "DEPTH"), //
-            EffectParameterF(1, 100, 1, "WAVE"),  //
-        },                                        //
-        level_(0),                                //
-        wave_(0),                                 //
-        depth_(0)                                 //
+            EffectParameterF(1, 100, 1, "LEVEL"),                              //
+            EffectParameterF(1, 100, 1, "RATE"),                               //
+            EffectParameterF(1, 100, 1, "DEPTH"),                              //
+            EffectParameterF(1, 100, 1, "WAVE"),                               //
+            EffectParameterF(0, TempoClock::DIVISION_COUNT - 1, 0, 1, "SYNC"), //
+        },                                                                     //
+        level_(0),                                                             //
+        wave_(0),                                                              //
+        depth_(0),                                                             //
+        lfoHandle_{},                                                          //
+        freq_(1)                                                               //
   {
     init(ui_, COUNT);
   }
@@ -100,19 +109,23 @@ public:
   /// @brief エフェクト処理実行
   /// @param[inout] left L音声データ
   /// @param[inout] right R音声データ
-  /// @param [in] size 音声データ数
+  /// @param [in] size 音声データ数（BLOCK_SIZE以下）
   void effect(float *left, float *right, uint32_t size) noexcept override
   {
+    const auto div = static_cast<uint8_t>(ui_[SYNC].getValue());
+    float const *lfo = LfoPool::get(lfo_, lfoHandle_, LfoPool::TRIANGLE, freq_, div, 0.0f); // テンポ同期中は共有のテンポクロックの位相
+    float *work = work_;
     for (uint32_t i = 0; i < size; ++i)
     {
-      float fx = right[i];
-      float gain = 2.0f * tri.output() - 1.0f; // LFO -1～1 三角波
-      gain *= wave_;                           // 三角波を増幅
-      satoh::fx::compress(-1.0f, gain, 1.0f);  // クリッピング（矩形波に近い形へ）
-      gain = depth_ * gain;                    // DEPTH -10～10 dB
-      fx *= dbToGain(gain);                    // 音量を揺らす
-      fx *= level_;                            // LEVEL
-      right[i] = fx;
+      float gain = 2.0f * lfo[i] - 1.0f;      // LFO -1～1 三角波
+      gain *= wave_;                          // 三角波を増幅
+      satoh::fx::compress(-1.0f, gain, 1.0f); // クリッピング（矩形波に近い形へ）
+      work[i] = depth_ * gain;                // DEPTH -10～10 dB
+    }
+    dbToGain(work, work, size); // 倍率換算
+    for (uint32_t i = 0; i < size; ++i)
+    {
+      right[i] *= level_ * work[i]; // 音量を揺らす、LEVEL
     }
   }
 };
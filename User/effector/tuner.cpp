@@ -6,98 +6,50 @@
 
 #include "tuner.h"
 #include <algorithm>
+#include <cmath>
 #include <cmsis_os.h>
 
 namespace
 {
-// ギター チューナー(ベースでの動作未確認)
-// ブロックサイズ 16, 32, 64 サンプリング周波数 44.1kHz 48kHz を想定
-//
-// 下記ページのコードを改変して使用
-// https://www.cycfi.com/2018/03/fast-and-efficient-pitch-detection-bitstream-autocorrelation/
-
-constexpr float FREQ_A = 440.0f;                                     ///< 基準A音周波数 Hz
-constexpr float MIN_FREQ = 70.0f;                                    ///< 最低周波数 ギター 6弦ドロップD音 73Hz
-constexpr float MAX_FREQ = 400.0f;                                   ///< 最高周波数 ギター 1弦5フレットA音 440Hz
-constexpr float TUNER_SAMPLING_FREQ = satoh::SAMPLING_FREQ;          ///< チューナーでのサンプリング周波数
-constexpr uint16_t MIN_PERIOD = TUNER_SAMPLING_FREQ / MAX_FREQ;      ///< 最小周期サンプル区間
-constexpr uint16_t MAX_PERIOD = TUNER_SAMPLING_FREQ / MIN_FREQ;      ///< 最大周期サンプル区間
-constexpr uint16_t IN_DATA_SIZE = 64 * ((MAX_PERIOD * 2) / 64) + 64; ///< 入力音配列 データ数 64の倍数にする
-constexpr uint16_t BIT_STREAM_SIZE = IN_DATA_SIZE / 32;              ///< ビットストリーム配列 データ数
-constexpr float NOISE_THRETHOLD = 0.02f;                             ///< ノイズ除去用閾値
-constexpr uint32_t CORR_ARRAY_SIZE = IN_DATA_SIZE / 2;               ///< 相関係数配列サイズ
-
-// 周波数算出 --------------------------------------------------------
-bool estimateFreq(float const *inData, uint32_t const *corrArray, float &estimatedFreq, float maxCorr, float estimatedIndex)
+constexpr float NOISE_THRETHOLD = 0.02f;     ///< ノイズ除去用閾値（解析窓のピークがこれ未満なら解析しない）
+constexpr uint32_t HOP_SIZE = 512;           ///< 解析間隔 サンプル数
+constexpr uint32_t RING_SIZE = HOP_SIZE * 4; ///< 受け渡し用バッファ データ数
+constexpr uint32_t POLY_INTERVAL = 8;        ///< ポリフォニックモードの解析間隔（HOP_SIZE単位 約90ms）
+constexpr float POLY_LPF_FREQ = 600.0f;      ///< ポリフォニックモード 間引き前LPFのカットオフ周波数
+constexpr float POLY_SEARCH = 1.0595f;       ///< ポリフォニックモード 基準周波数から探索する範囲（±半音）
+constexpr float POLY_THRESHOLD = 0.01f;      ///< ポリフォニックモード 最大ピークに対するピーク検出閾値（パワー比 -20dB）
+constexpr float POLY_LOG_FLOOR = 1e-20f;     ///< ポリフォニックモード 対数を取るパワーの下限（0のビンで -inf にしない）
+
+/// @brief 弦定義型
+struct String
 {
-  // <実際より低い音として判定される問題を解決＞
-  // 短い周期(高い音)の音が入力されると、周期が数倍の点にも谷が現れる
-  // →例)周期4ms(250Hz)の音が12ms(83.3Hz)と判定
-  // 実際より長く判定された周期を整数で割って整数倍したもの(1/4, 2/4, 3/4, 1/3, 2/3等)
-  // それぞれについて相関値を調べ、整数倍全てに深い谷がある(allStrong)場合の除数を採用する
-  uint32_t subThreshold = 0.3f * maxCorr;        // 谷の強さ判定閾値
-  uint16_t maxDiv = estimatedIndex / MIN_PERIOD; // 除数最大値
-  uint16_t estimatedDiv = 1;                     // 採用する除数
-  for (int16_t div = maxDiv; div != 0; div--)
-  {
-    bool allStrong = true;
-
-    for (uint16_t k = 1; k != div; k++)
-    {
-      uint16_t subPeriod = estimatedIndex * k / (float)div;
-      if (corrArray[subPeriod] > subThreshold)
-      {
-        allStrong = false;
-        break;
-      }
-    }
-
-    if (allStrong)
-    {
-      estimatedDiv = div; // 除数決定、最終的な周波数計算時に使用
-      break;
-    }
-  }
-
-  // ゼロクロス（-→+） スタート点 検出
-  uint16_t startIndex = 1;
-  while (startIndex < IN_DATA_SIZE)
-  {
-    if (inData[startIndex - 1] <= 0.0f && inData[startIndex] > 0.0f)
-    {
-      break;
-    }
-    startIndex++;
-  }
-  float dy = inData[startIndex] - inData[startIndex - 1]; // 線形補間 y
-  float dx1 = -inData[startIndex - 1] / dy;               // 線形補間 x1
-
-  // ゼロクロス（-→+） 目的の点 検出
-  uint16_t nextIndex = estimatedIndex - 1;
-  while (nextIndex < IN_DATA_SIZE)
-  {
-    if (inData[nextIndex - 1] <= 0.0f && inData[nextIndex] > 0.0f)
-    {
-      break;
-    }
-    nextIndex++;
-  }
-  dy = inData[nextIndex] - inData[nextIndex - 1]; // 線形補間 y
-  float dx2 = -inData[nextIndex - 1] / dy;        // 線形補間 x2
-
-  float estimatedPeriod = (nextIndex - startIndex) + (dx2 - dx1); // 推定周期
-  estimatedPeriod = estimatedPeriod / (float)estimatedDiv;        // 予め計算した除数で割る
-
-  // 推定周波数が3回連続で近い値となった時に周波数確定
-  static float tmpFreq[3] = {}; // 推定周波数 一時保管用
-  static uint8_t n = 0;         // 上記tmpFreqの添字 0→1→2→0で循環させる
-  if (estimatedPeriod > (float)MIN_PERIOD)
-  {
-    tmpFreq[n] = TUNER_SAMPLING_FREQ / estimatedPeriod;
-  }
-
+  float freq;       ///< 基準周波数
+  char const *name; ///< 音名
+};
+/// @brief 弦定義（レギュラーチューニング 6弦 → 1弦）
+constexpr String STRINGS[] = {
+    {82.407f, "E"},  //
+    {110.0f, "A"},   //
+    {146.832f, "D"}, //
+    {195.998f, "G"}, //
+    {246.942f, "B"}, //
+    {329.628f, "E"}, //
+};
+static_assert(sizeof(STRINGS) / sizeof(STRINGS[0]) == satoh::fx::Tuner::STRING_COUNT, "");
+
+/// @brief 推定周波数が3回連続で近い値となった時に周波数確定
+/// @param [in] freq 今回の推定周波数（0は検出なし）
+/// @param [out] estimatedFreq 確定した周波数
+/// @param [inout] tmpFreq 推定周波数 一時保管用
+/// @param [inout] n tmpFreqの添字
+/// @retval true 確定した
+/// @retval false 確定しなかった
+bool estimateFreq(float freq, float &estimatedFreq, float (&tmpFreq)[3], uint8_t &n)
+{
+  tmpFreq[n] = freq;
   bool res = false;
-  if (tmpFreq[n] * 0.97f < tmpFreq[(n + 1) % 3] && //
+  if (0.0f < freq &&                               //
+      tmpFreq[n] * 0.97f < tmpFreq[(n + 1) % 3] && //
       tmpFreq[(n + 1) % 3] < 1.03f * tmpFreq[n] && //
       tmpFreq[n] * 0.97f < tmpFreq[(n + 2) % 3] && //
       tmpFreq[(n + 2) % 3] < 1.03f * tmpFreq[n])
@@ -108,124 +60,165 @@ bool estimateFreq(float const *inData, uint32_t const *corrArray, float &estimat
   n = (n + 1) % 3;
   return res;
 }
+} // namespace
 
-// 自己相関計算 ------------------------------------------------------------------
-void bitstreamAutocorrelation(uint16_t startCnt, uint32_t const *bitData, uint32_t *corrArray, uint32_t &maxCorr, uint32_t &minCorr, uint16_t &estimatedIndex)
+satoh::fx::Tuner::Tuner()                                           //
+    : EffectorBase(TEMPLATE, "Tuner", "TN", RGB{0x00, 0x00, 0x00}), //
+      ring_(RING_SIZE),                                             //
+      hop_(allocArray<float>(HOP_SIZE)),                            //
+      tmpFreq_{},                                                   //
+      tmpCnt_(0),                                                   //
+      estimatedFreq_(999.0f),                                       //
+      lastUpdateTime_(0),                                           //
+      poly_(false),                                                 //
+      polyLpf1_(POLY_LPF_FREQ),                                     //
+      polyLpf2_(POLY_LPF_FREQ),                                     //
+      polyBuf_(allocArray<float>(POLY_FFT_SIZE)),                   //
+      polyFft_(allocArray<float>(POLY_FFT_SIZE)),                   //
+      polyPos_(0),                                                  //
+      polyPhase_(0),                                                //
+      polyCnt_(0),                                                  //
+      stringFreq_{}                                                 //
 {
-  // pos：position ビットストリーム配列をズラした位置
-  // pos → MIN_PERIOD ～ IN_DATA_SIZE/2 まで相間を計算するが、計算負荷軽減のため分割する
-  for (uint16_t pos = startCnt; (pos >= MIN_PERIOD) && (pos < startCnt + satoh::BLOCK_SIZE / 2); pos++)
+  if (*this)
   {
-    uint16_t midBitStreamSize = (BIT_STREAM_SIZE / 2) - 1; // ビットストリーム配列データ数の半分
-    uint16_t index = startCnt / 32;                        // ビットストリーム配列の何番目の整数か
-    uint16_t shift = startCnt % 32;                        // ビットストリーム配列内の整数 シフト数
-    uint32_t corr = 0;                                     // correlation(相間)
-
-    if (shift == 0)
-    {
-      for (uint16_t i = 0; i < midBitStreamSize; i++)
-      { // ^(XOR)、ビットが1になっている所を数え相間を算出
-        corr += __builtin_popcount(bitData[i] ^ bitData[i + index]);
-      }
-    }
-    else
-    {
-      for (uint16_t i = 0; i < midBitStreamSize; i++)
-      {
-        uint32_t tmp = bitData[i + index] >> shift;    // ビットストリーム配列をズラしたもの
-        tmp |= bitData[i + 1 + index] << (32 - shift); // 右シフトしたものと左シフトしたものを合わせる
-        corr += __builtin_popcount(bitData[i] ^ tmp);
-      }
-    }
-    shift++;
-    if (shift == 32) // shiftが32まで来たらindexを増やす
-    {
-      shift = 0;
-      index++;
-    }
-    corrArray[pos] = corr;             // correlation(相間) 配列
-    maxCorr = std::max(maxCorr, corr); // 最大値を記録
-    if (corr < minCorr)
-    {
-      minCorr = corr;       // 最小値を記録
-      estimatedIndex = pos; // 相間が最小となる時の位置→周期計算に利用
-    }
+    reset();
   }
+  init(0, 0);
 }
 
-// 入力音配列をビットストリームへ変換 --------------------------------------------
-void bitStreamSet(uint16_t cnt, float x, float *inData, uint32_t *bitData)
+void satoh::fx::Tuner::effect(float *left, float *right, uint32_t size) noexcept
 {
-  uint32_t val = 0;  // 入力音がゼロ以上か判定 0または1
-  uint32_t mask = 0; // マスクビット
-
-  // 入力音配列にデータを保存
-  inData[cnt] = x;
+  ring_.push(right, size); // 解析が追いつかない場合は捨てる
+  memset(left, 0, size * sizeof(float));
+  memset(right, 0, size * sizeof(float));
+}
 
-  // 入力音配列をビットストリーム配列へ変換
-  if (inData[cnt] < -NOISE_THRETHOLD)
+void satoh::fx::Tuner::reset(bool poly) noexcept
+{
+  ring_.clear();
+  detector_.reset();
+  for (auto &f : tmpFreq_)
   {
-    val = 0;
+    f = 0;
   }
-  else if (inData[cnt] > 0.0f)
+  tmpCnt_ = 0;
+  lastUpdateTime_ = 0;
+  poly_ = poly;
+  polyLpf1_ = lpf2nd(POLY_LPF_FREQ);
+  polyLpf2_ = lpf2nd(POLY_LPF_FREQ);
+  memset(polyBuf_.get(), 0, POLY_FFT_SIZE * sizeof(float));
+  polyPos_ = 0;
+  polyPhase_ = 0;
+  polyCnt_ = 0;
+  for (auto &f : stringFreq_)
   {
-    val = 1;
+    f = 0;
   }
-  mask = 1 << (cnt % 32);
-  bitData[cnt / 32] ^= (-val ^ bitData[cnt / 32]) & mask; // -val は 111...111 または 000...000（解説省略）
 }
-} // namespace
 
-satoh::fx::Tuner::Tuner()                                           //
-    : EffectorBase(TEMPLATE, "Tuner", "TN", RGB{0x00, 0x00, 0x00}), //
-      lpf_(MAX_FREQ),                                               //
-      inData_{},                                                    //
-      inDataCnt_(0),                                                //
-      bitStream_{},                                                 //
-      arraySel_(0),                                                 //
-      corrArray_(allocArray<uint32_t>(CORR_ARRAY_SIZE)),            //
-      maxCorr_(0),                                                  //
-      minCorr_(UINT32_MAX),                                         //
-      estimatedIndex_(MIN_PERIOD),                                  //
-      estimatedFreq_(999.0f),                                       //
-      lastUpdateTime_(0)                                            //
+void satoh::fx::Tuner::pushPoly(float const *src, uint32_t size) noexcept
 {
-  for (int i = 0; i < 2; ++i)
+  float *buf = polyBuf_.get();
+  for (uint32_t i = 0; i < size; ++i)
   {
-    inData_[i] = UniquePtr<float>(allocArray<float>(IN_DATA_SIZE));
-    bitStream_[i] = UniquePtr<uint32_t>(allocArray<uint32_t>(BIT_STREAM_SIZE));
+    float y = polyLpf2_.process(polyLpf1_.process(src[i]));
+    if (++polyPhase_ == POLY_DECIMATION)
+    {
+      polyPhase_ = 0;
+      buf[polyPos_] = y;
+      polyPos_ = (polyPos_ + 1) % POLY_FFT_SIZE;
+    }
   }
-  init(0, 0);
 }
 
-void satoh::fx::Tuner::effect(float *left, float *right, uint32_t size) noexcept
+void satoh::fx::Tuner::analyzePoly() noexcept
 {
-  // 配列準備と自己相間の計算が終了したデータを使い周波数を算出、変数初期化 //////////
-  if (inDataCnt_ == 0)
+  using TW = fft::Twiddle<>;
+  constexpr uint32_t STEP = fft::MAX_SIZE / POLY_FFT_SIZE;
+  constexpr float BIN_FREQ = SAMPLING_FREQ / POLY_DECIMATION / POLY_FFT_SIZE; // 1ビンの周波数幅
+  // 古い順に並べてハン窓をかけ、パワースペクトルを求める
+  float const *buf = polyBuf_.get();
+  float *x = polyFft_.get();
+  for (uint32_t i = 0; i < POLY_FFT_SIZE; ++i)
+  {
+    x[i] = buf[(polyPos_ + i) % POLY_FFT_SIZE] * (0.5f - 0.5f * TW::cos(i * STEP));
+  }
+  fft_.forward(x, x);
+  for (uint32_t k = 1; k < POLY_FFT_SIZE / 2; ++k)
   {
-    if (estimateFreq(inData_[arraySel_].get(), corrArray_.get(), estimatedFreq_, maxCorr_, estimatedIndex_))
+    x[k] = x[k * 2] * x[k * 2] + x[k * 2 + 1] * x[k * 2 + 1];
+  }
+  // 弦毎に基準周波数 ±半音 の範囲の最大ピークを探す
+  uint32_t peak[STRING_COUNT];
+  float maxPower = 0;
+  for (uint8_t n = 0; n < STRING_COUNT; ++n)
+  {
+    const uint32_t lo = static_cast<uint32_t>(STRINGS[n].freq / POLY_SEARCH / BIN_FREQ);
+    const uint32_t hi = static_cast<uint32_t>(STRINGS[n].freq * POLY_SEARCH / BIN_FREQ) + 1;
+    peak[n] = lo;
+    for (uint32_t k = lo; k <= hi; ++k)
     {
-      lastUpdateTime_ = osKernelSysTick();
+      peak[n] = x[peak[n]] < x[k] ? k : peak[n];
     }
-    maxCorr_ = 0;
-    minCorr_ = UINT32_MAX;
-    memset(corrArray_.get(), 0, sizeof(*corrArray_) * CORR_ARRAY_SIZE);
+    maxPower = std::max(maxPower, x[peak[n]]);
   }
+  // 放物線補間（対数パワー）で周波数を求める
+  for (uint8_t n = 0; n < STRING_COUNT; ++n)
+  {
+    const uint32_t k = peak[n];
+    const float p = x[k];
+    stringFreq_[n] = 0;
+    if (p < maxPower * POLY_THRESHOLD || p <= x[k - 1] || p <= x[k + 1])
+    {
+      continue; // 弱い、または探索範囲の端（隣の音の裾）
+    }
+    float ym = std::log(std::max(x[k - 1], POLY_LOG_FLOOR));
+    float y0 = std::log(std::max(p, POLY_LOG_FLOOR));
+    float yp = std::log(std::max(x[k + 1], POLY_LOG_FLOOR));
+    float den = ym - 2.0f * y0 + yp;
+    float d = den < 0.0f ? 0.5f * (ym - yp) / den : 0.0f;
+    stringFreq_[n] = (k + d) * BIN_FREQ;
+  }
+}
 
-  // 自己相関計算 ////////////////////////////////////////////////////////////////
-  bitstreamAutocorrelation(inDataCnt_ / 2, bitStream_[(arraySel_ + 1) % 2].get(), corrArray_.get(), maxCorr_, minCorr_, estimatedIndex_);
-
-  // 入力音配列とビットストリーム配列を準備 //////////////////////////////////////
-  for (uint32_t i = 0; i < size; i++)
+bool satoh::fx::Tuner::analyze() noexcept
+{
+  if (ring_.size() < HOP_SIZE)
   {
-    float fx = lpf_.process(right[i]);
-    bitStreamSet(inDataCnt_, fx, inData_[arraySel_].get(), bitStream_[arraySel_].get());
-    inDataCnt_++;
-    if (inDataCnt_ == IN_DATA_SIZE) // 配列 準備完了
+    return false;
+  }
+  // 解析窓を HOP_SIZE だけ進める
+  float *hop = hop_.get();
+  ring_.pop(hop, HOP_SIZE);
+  float peak = 0;
+  for (uint32_t i = 0; i < HOP_SIZE; ++i)
+  {
+    peak = std::max(peak, std::abs(hop[i]));
+  }
+  if (poly_)
+  {
+    pushPoly(hop, HOP_SIZE);
+    if (++polyCnt_ == POLY_INTERVAL)
     {
-      inDataCnt_ = 0;
-      arraySel_ = (arraySel_ + 1) % 2;
+      polyCnt_ = 0;
+      analyzePoly();
+      if (NOISE_THRETHOLD <= peak)
+      {
+        lastUpdateTime_ = osKernelSysTick();
+      }
     }
-    left[i] = right[i] = 0;
+    return true;
   }
+  detector_.push(hop, HOP_SIZE);
+  float freq = NOISE_THRETHOLD <= peak ? detector_.detect() : 0.0f;
+  if (estimateFreq(freq, estimatedFreq_, tmpFreq_, tmpCnt_))
+  {
+    lastUpdateTime_ = osKernelSysTick();
+  }
+  return true;
 }
+
+float satoh::fx::Tuner::getStringNominalFreq(uint8_t n) noexcept { return STRINGS[n].freq; }
+
+char const *satoh::fx::Tuner::getStringName(uint8_t n) noexcept { return STRINGS[n].name; }
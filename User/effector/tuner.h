@@ -7,9 +7,11 @@
 #pragma once
 
 #include "common/alloc.hpp"
-#include "common/dma_mem.h"
+#include "common/spsc_ring.hpp"
 #include "effector_base.h"
+#include "lib/lib_fft.hpp"
 #include "lib/lib_filter.hpp"
+#include "lib/lib_pitch.hpp"
 
 namespace satoh
 {
@@ -20,19 +22,45 @@ class Tuner;
 } // namespace satoh
 
 /// @brief チューナー
+/// @note 音声タスクでは入力音をリングバッファへ書き込むだけにし、
+///   周波数推定は低優先度のチューナータスクから analyze() を呼んで行う。
+///   推定には PitchDetector を使い、ベースの低音（4弦E 41Hz）から扱える。
+///   ポリフォニックモードでは、1/16 に間引いた入力音の長い窓（約0.74秒）をFFTし、
+///   6弦それぞれの基準周波数付近のピークから弦毎の周波数を推定する。
 class satoh::fx::Tuner : public satoh::fx::EffectorBase
 {
-  lpf2nd lpf_;                       ///< 入力2次LPF
-  UniquePtr<float> inData_[2];       ///< 入力音の配列 2つ準備し交互に利用
-  uint16_t inDataCnt_;               ///< 入力音配列の添字カウント
-  UniquePtr<uint32_t> bitStream_[2]; ///< ビットストリーム配列 2つ準備し交互に利用
-  uint8_t arraySel_;                 ///< 2つの配列 入れ替え用
-  UniquePtr<uint32_t> corrArray_;    ///< correlation(相間) 配列
-  uint32_t maxCorr_;                 ///< correlation(相間) 最大値
-  uint32_t minCorr_;                 ///< correlation(相間) 最小値
-  uint16_t estimatedIndex_;          ///< 推定周期 サンプル数
-  float estimatedFreq_;              ///< 推定周波数
-  uint32_t lastUpdateTime_;          ///< 最後に推定周波数を更新した時刻
+public:
+  static constexpr uint8_t STRING_COUNT = 6; ///< ポリフォニックモードの弦数
+
+private:
+  static constexpr uint32_t POLY_DECIMATION = 16; ///< ポリフォニックモードの間引き率
+  static constexpr uint32_t POLY_FFT_SIZE = 2048; ///< ポリフォニックモードのFFTサイズ（解析窓サイズ）
+
+  SpscRing<float> ring_;    ///< 音声タスク → チューナータスク 受け渡し用バッファ
+  UniquePtr<float> hop_;    ///< リングバッファから取り出した入力音
+  PitchDetector detector_;  ///< ピッチ検出
+  float tmpFreq_[3];        ///< 推定周波数 一時保管用
+  uint8_t tmpCnt_;          ///< tmpFreq_の添字 0→1→2→0で循環させる
+  float estimatedFreq_;     ///< 推定周波数
+  uint32_t lastUpdateTime_; ///< 最後に推定周波数を更新した時刻
+
+  bool poly_;                      ///< ポリフォニックモード
+  lpf2nd polyLpf1_;                ///< ポリフォニックモード 間引き前LPF（1段目）
+  lpf2nd polyLpf2_;                ///< ポリフォニックモード 間引き前LPF（2段目）
+  UniquePtr<float> polyBuf_;       ///< ポリフォニックモード 間引き後の入力音（循環バッファ）
+  UniquePtr<float> polyFft_;       ///< ポリフォニックモード FFT作業領域
+  RealFft<POLY_FFT_SIZE> fft_;     ///< FFT
+  uint32_t polyPos_;               ///< polyBuf_ 書き込み位置
+  uint32_t polyPhase_;             ///< 間引き位相
+  uint32_t polyCnt_;               ///< 解析間隔カウンタ
+  float stringFreq_[STRING_COUNT]; ///< 弦毎の推定周波数（0は検出なし）
+
+  /// @brief 入力音を間引いてポリフォニックモードの解析窓へ追加する
+  /// @param [in] src 入力音
+  /// @param [in] size データ数
+  void pushPoly(float const *src, uint32_t size) noexcept;
+  /// @brief ポリフォニックモードの周波数推定
+  void analyzePoly() noexcept;
 
   /// @brief UI表示のパラメータを、エフェクト処理で使用する値へ変換する
   /// @param [in] n 変換対象のパラメータ番号
@@ -47,13 +75,32 @@ public:
   Tuner();
   /// @brief デストラクタ
   virtual ~Tuner() {}
+  /// @brief エフェクターセットアップ成功・失敗
+  /// @retval true 成功
+  /// @retval false 失敗
+  explicit operator bool() const noexcept override { return ring_ && hop_ && detector_ && polyBuf_ && polyFft_; }
   /// @brief エフェクト処理実行
   /// @param[inout] left L音声データ
   /// @param[inout] right R音声データ
   /// @param [in] size 音声データ数
   void effect(float *left, float *right, uint32_t size) noexcept override;
+  /// @brief 解析状態を初期化する（チューナータスクから呼ぶこと）
+  /// @param [in] poly true:ポリフォニックモード false:通常モード
+  void reset(bool poly = false) noexcept;
+  /// @brief 溜まった入力音を取り込み、周波数を推定する（チューナータスクから呼ぶこと）
+  /// @retval true 解析した
+  /// @retval false 入力音が足りないので解析しなかった
+  bool analyze() noexcept;
   /// @brief 推定周波数を取得する @return 推定周波数
   float getEstimatedFreq() const noexcept { return estimatedFreq_; }
   /// @brief 最後に推定周波数を更新した時刻を取得する @return 最後に推定周波数を更新した時刻
   uint32_t getLastUpdateTime() const noexcept { return lastUpdateTime_; }
+  /// @brief ポリフォニックモードかどうか @retval true ポリフォニックモード @retval false 通常モード
+  bool isPolyphonic() const noexcept { return poly_; }
+  /// @brief 弦毎の推定周波数を取得する @param [in] n 弦番号（0:6弦 〜 5:1弦） @return 推定周波数（0は検出なし）
+  float getStringFreq(uint8_t n) const noexcept { return stringFreq_[n]; }
+  /// @brief 弦の基準周波数を取得する @param [in] n 弦番号（0:6弦 〜 5:1弦） @return 基準周波数
+  static float getStringNominalFreq(uint8_t n) noexcept;
+  /// @brief 弦の音名を取得する @param [in] n 弦番号（0:6弦 〜 5:1弦） @return 音名
+  static char const *getStringName(uint8_t n) noexcept;
 };
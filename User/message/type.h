@@ -11,9 +11,15 @@
 #include "effector/effector_base.h"
 #include "error.h"
 #include "msglib.h"
+#include <atomic>
 
 namespace satoh
 {
+class LoopSram;
+namespace fx
+{
+class Tuner;
+}
 namespace msg
 {
 /// @brief メッセージカテゴリ定義
@@ -29,6 +35,8 @@ constexpr ID USB = 6 << SHIFT;
 constexpr ID NEOPIXEL = 7 << SHIFT;
 constexpr ID SOUND = 8 << SHIFT;
 constexpr ID APP = 9 << SHIFT;
+constexpr ID TUNER = 10 << SHIFT;
+constexpr ID SRAM = 11 << SHIFT;
 constexpr ID ERROR = 15 << SHIFT;
 } // namespace cat
 
@@ -55,7 +63,12 @@ constexpr ID NEO_PIXEL_SET_SPEED = 2 | cat::NEOPIXEL;      ///< NeoPixel - 点
 constexpr ID SOUND_DMA_HALF_NOTIFY = 1 | cat::SOUND;       ///< Sound - DMA半分受信完了通知
 constexpr ID SOUND_DMA_CPLT_NOTIFY = 2 | cat::SOUND;       ///< Sound - DMA全部受信完了通知
 constexpr ID SOUND_CHANGE_EFFECTOR_REQ = 3 | cat::SOUND;   ///< Sound - エフェクター変更要求
+constexpr ID SOUND_REPORT_REQ = 4 | cat::SOUND;            ///< Sound - 出力段リミッターのレイテンシ・処理時間をUSBへ送る要求
+constexpr ID SOUND_TAP_NOTIFY = 5 | cat::SOUND;            ///< Sound - TAP通知（テンポクロックを拍の頭に戻す）
 constexpr ID APP_TIM_NOTIFY = 1 | cat::APP;                ///< App - タイマー通知
+constexpr ID TUNER_START_REQ = 1 | cat::TUNER;             ///< Tuner - 周波数解析開始要求
+constexpr ID TUNER_STOP_REQ = 2 | cat::TUNER;              ///< Tuner - 周波数解析停止要求
+constexpr ID SRAM_LOOP_NOTIFY = 1 | cat::SRAM;             ///< SPI SRAM - ルーパーの転送要求通知
 constexpr ID ERROR_NOTIFY = 1 | cat::ERROR;                ///< Error - エラー通知
 
 struct ACC_GYRO;
@@ -74,10 +87,14 @@ struct OLED_DISP_TUNER;
 struct NEO_PIXEL_PATTERN;
 struct NEO_PIXEL_SPEED;
 struct SOUND_EFFECTOR;
+struct SOUND_TAP;
+struct TUNER_START;
+struct SRAM_LOOP;
 struct ERROR;
 
-constexpr uint8_t BUTTON_UP = 0;   ///< ボタン離し中
-constexpr uint8_t BUTTON_DOWN = 1; ///< ボタン押下中
+constexpr uint8_t BUTTON_UP = 0;       ///< ボタン離し中
+constexpr uint8_t BUTTON_DOWN = 1;     ///< ボタン押下中
+constexpr uint8_t MAX_VALUE_TEXT = 16; ///< OLED_DISP_EFFECTOR で表示するパラメータ値の文字列長（終端を含む）
 } // namespace msg
 } // namespace satoh
 
@@ -158,8 +175,14 @@ struct satoh::msg::MODE_KEY
 /// @brief OLED_DISP_EFFECTOR_REQ 付随データ
 struct satoh::msg::OLED_DISP_EFFECTOR
 {
-  /// 表示するエフェクター
-  fx::EffectorBase *fx;
+  /// エフェクター名（0ならばバイパス表示 文字列リテラル）
+  const char *name;
+  /// パラメータ数
+  uint8_t paramCount;
+  /// パラメータ名（文字列リテラル）
+  const char *paramName[MAX_PARAM_COUNT];
+  /// パラメータ値の文字列（App が持つ写し）
+  char const (*value)[MAX_VALUE_TEXT];
   /// パッチ番号
   uint8_t patch;
   /// 選択中のパラメータ番号
@@ -172,8 +195,8 @@ struct satoh::msg::OLED_DISP_BANK
   uint8_t bank;
   /// パッチ番号
   uint8_t patch;
-  /// 表示するエフェクター
-  fx::EffectorBase *fx[MAX_EFFECTOR_COUNT];
+  /// 表示するエフェクター名（文字列リテラル）
+  const char *name[MAX_EFFECTOR_COUNT];
   /// エディットモードフラグ
   bool editMode;
   /// 選択中のエフェクト番号（editMode = true のときのみ有効）
@@ -200,6 +223,11 @@ struct satoh::msg::OLED_DISP_TUNER
   char name[3];   ///< 音名(C, C#, D, D#, E, F, F#, G, G#, A, A#, B)
   int diff;       ///< 期待値とのずれ（0ならば一致している）
   float freq;     ///< 周波数
+  bool poly;      ///< ポリフォニックモード（以下は弦毎の表示 6弦 → 1弦）
+
+  bool strEstimated[6]; ///< 弦毎の周波数推定有無
+  char strName[6][3];   ///< 弦毎の音名
+  int8_t strDiff[6];    ///< 弦毎の期待値とのずれ（0ならば一致している）
 };
 /// @brief NEO_PIXEL_SET_PATTERN 付随データ
 struct satoh::msg::NEO_PIXEL_PATTERN
@@ -218,6 +246,30 @@ struct satoh::msg::SOUND_EFFECTOR
 {
   /// エフェクタークラスのポインタ
   fx::EffectorBase *fx[MAX_EFFECTOR_COUNT];
+  /// 世代（state::Property が送る毎に増やす）
+  uint32_t gen;
+  /// 反映した世代の書込先（0以外ならば、エフェクターを入れ替えた後に gen を書き込む）
+  std::atomic<uint32_t> *applied;
+};
+/// @brief SOUND_TAP_NOTIFY 付随データ
+struct satoh::msg::SOUND_TAP
+{
+  /// TAP間隔（ミリ秒 最初のTAPは0）
+  uint32_t interval;
+};
+/// @brief TUNER_START_REQ 付随データ
+struct satoh::msg::TUNER_START
+{
+  /// 解析対象のチューナー
+  fx::Tuner *tuner;
+  /// true:ポリフォニックモード false:通常モード
+  bool poly;
+};
+/// @brief SRAM_LOOP_NOTIFY 付随データ
+struct satoh::msg::SRAM_LOOP
+{
+  /// 転送要求を積んだルーパーの SPI SRAM 転送
+  LoopSram *stream;
 };
 /// @brief ERROR_NOTIFY 付随データ
 struct satoh::msg::ERROR
@@ -93,21 +93,19 @@ void state::tapProc(Property &prop) noexcept
 {
   auto *tap = prop.getTap();
   tap->notifyTapEvent();
-  uint32_t interval = tap->getTapInterval();
-  if (interval == 0)
-  {
-    return;
-  }
   for (size_t i = 0; i < MAX_EFFECTOR_COUNT; ++i)
   {
-    prop.getFx(i)->setTapInterval(interval);
+    prop.getFx(i)->notifyTap();
   }
+  msg::SOUND_TAP cmd{tap->getTapInterval()};
+  msg::send(soundTaskHandle, msg::SOUND_TAP_NOTIFY, cmd);
 }
 
 void state::re1Proc(Property &prop) noexcept
 {
   UNUSED(prop);
   changeNeoPixelPattern();
+  msg::send(soundTaskHandle, msg::SOUND_REPORT_REQ);
 }
 
 void state::timerProc(Property &prop) noexcept
@@ -7,6 +7,8 @@
 #include "effect_edit.h"
 #include "common.h"
 #include "common/utils.h"
+#include <algorithm>
+#include <cstdio> // snprintf
 
 namespace msg = satoh::msg;
 namespace state = satoh::state;
@@ -108,11 +110,22 @@ void state::EffectEdit::modSelectedParam(bool up)
   selectedParamNum_ = (selectedParamNum_ + fx->getParamCount() + d) % fx->getParamCount();
   showFx();
 }
-void state::EffectEdit::showFx() const noexcept
+void state::EffectEdit::showFx() noexcept
 {
   auto *fx = m_.getEditSelectedFx();
+  auto &value = value_[valueSide_];
+  valueSide_ = (valueSide_ + 1) % (I2C_TASK_MAIL_COUNT + 1);
   msg::OLED_DISP_EFFECTOR cmd{};
-  cmd.fx = fx;
+  cmd.name = fx->getName();
+  cmd.paramCount = std::min(fx->getParamCount(), MAX_PARAM_COUNT);
+  for (uint8_t n = 0; n < cmd.paramCount; ++n)
+  {
+    // 値の文字列はエフェクターの中にあるので写しを渡す（表示する前にエフェクターが入れ替わってもよいように）
+    const char *txt = fx->getValueTxt(n);
+    cmd.paramName[n] = fx->getParamName(n);
+    snprintf(value[n], sizeof(value[n]), "%s", txt ? txt : "");
+  }
+  cmd.value = value;
   cmd.patch = m_.getEditSelectedFxNum() + 1;
   cmd.selectedParam = selectedParamNum_;
   msg::send(i2cTaskHandle, msg::OLED_DISP_EFFECTOR_REQ, cmd);
@@ -23,6 +23,12 @@ class satoh::state::EffectEdit : public satoh::state::Base
   Property &m_;
   /// @brief 選択中のパラメータ番号
   uint8_t selectedParamNum_;
+  /// @brief 表示するパラメータ値の文字列（表示タスクはエフェクターを直接参照しない）
+  /// @note 送信毎に面を順に使う（6 × 16 バイトはメールに収まらない）。
+  ///   i2cTaskのメール数＋1面あるので、キューに残っている・描画中のメッセージの面を書き換えない。
+  char value_[I2C_TASK_MAIL_COUNT + 1][MAX_PARAM_COUNT][msg::MAX_VALUE_TEXT];
+  /// @brief 次に書き込む value_ の面
+  uint8_t valueSide_;
   /// @brief MODE_KEYを処理する @param[in] src MODE_KEY @return 次の状態ID
   ID run(msg::MODE_KEY const *src) noexcept override;
   /// @brief EFFECT_KEYを処理する @param[in] src EFFECT_KEY @return 次の状態ID
@@ -41,12 +47,12 @@ class satoh::state::EffectEdit : public satoh::state::Base
   ///   @arg false ダウン
   void modSelectedParam(bool up) noexcept;
   /// @brief エフェクト画面表示
-  void showFx() const noexcept;
+  void showFx() noexcept;
 
 public:
   /// @brief コンストラクタ
   /// @param [in] prop プロパティ
-  explicit EffectEdit(Property &prop) : m_(prop) {}
+  explicit EffectEdit(Property &prop) : m_(prop), selectedParamNum_(0), value_{}, valueSide_(0) {}
   /// @brief デストラクタ
   ~EffectEdit() {}
   /// @brief 状態IDを取得する @return 状態ID
@@ -99,9 +99,9 @@ void state::PatchEdit::updateDisplay() noexcept
   cmd.patch = m_.getPatchNum() + 1;
   cmd.editMode = true;
   cmd.selectedFx = m_.getEditSelectedFxNum() + 1;
-  for (size_t i = 0; i < countof(cmd.fx); ++i)
+  for (size_t i = 0; i < countof(cmd.name); ++i)
   {
-    cmd.fx[i] = m_.getFx(i);
+    cmd.name[i] = m_.getFx(i)->getName();
   }
   msg::send(i2cTaskHandle, msg::OLED_DISP_BANK_REQ, cmd);
 }
@@ -114,12 +114,7 @@ void state::PatchEdit::modFxList(bool next) noexcept
 {
   m_.updateNextFx(next);
   updateDisplay();
-  msg::SOUND_EFFECTOR sound{};
-  for (size_t i = 0; i < countof(sound.fx); ++i)
-  {
-    sound.fx[i] = m_.getFx(i);
-  }
-  msg::send(soundTaskHandle, msg::SOUND_CHANGE_EFFECTOR_REQ, sound);
+  m_.sendFx();
 }
 void state::PatchEdit::init() noexcept
 {
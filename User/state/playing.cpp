@@ -8,7 +8,8 @@
 #include "common.h"
 #include "common/dma_mem.h"
 #include "common/utils.h"
-#include <cstdio> // to use `sprintf`
+#include "effector/looper.hpp"
+#include <cstdio> // to use `snprintf`
 
 namespace msg = satoh::msg;
 namespace state = satoh::state;
@@ -41,8 +42,29 @@ state::ID state::Playing::run(msg::MODE_KEY const *src) noexcept
     {
       // 隠し機能
       char msg[64] = {0};
-      int n = sprintf(msg, "[FREE SIZE] rtos: %d dtcm: %d\r\n", xPortGetFreeHeapSize(), satoh::getFreeDmaMemSize());
-      msg::send(usbTxTaskHandle, msg::USB_TX_REQ, msg, n);
+      auto dtcm = satoh::getDmaMemStat();
+      int n = snprintf(msg, sizeof(msg), "[FREE SIZE] rtos: %lu dtcm: %lu max: %lu\r\n", //
+                       static_cast<unsigned long>(xPortGetFreeHeapSize()),           //
+                       static_cast<unsigned long>(satoh::getFreeDmaMemSize()),       //
+                       static_cast<unsigned long>(dtcm.largest));
+      msg::send(usbTxTaskHandle, msg::USB_TX_REQ, msg, std::min<int>(n, sizeof(msg) - 1));
+      auto dsp = satoh::getDspMemStat();
+      n = snprintf(msg, sizeof(msg), "[DTCM DSP] peak: %lu / %lu fail: %lu\r\n", //
+                   static_cast<unsigned long>(dsp.peak),                           //
+                   static_cast<unsigned long>(dsp.total),                          //
+                   static_cast<unsigned long>(dsp.failCount));
+      msg::send(usbTxTaskHandle, msg::USB_TX_REQ, msg, std::min<int>(n, sizeof(msg) - 1));
+      for (uint8_t i = 0; i < satoh::MAX_EFFECTOR_COUNT; ++i)
+      {
+        auto const &arena = m_.getArena(i);
+        n = snprintf(msg, sizeof(msg), "[ARENA FX%d] peak: %lu / %lu fail: %lu\r\n", i + 1, //
+                     static_cast<unsigned long>(arena.getPeakSize()),                        //
+                     static_cast<unsigned long>(arena.getSize()),                            //
+                     static_cast<unsigned long>(arena.getFailCount()));
+        msg::send(usbTxTaskHandle, msg::USB_TX_REQ, msg, std::min<int>(n, sizeof(msg) - 1));
+      }
+      n = satoh::fx::Looper::getMaxLengthTxt(msg, sizeof(msg));
+      msg::send(usbTxTaskHandle, msg::USB_TX_REQ, msg, std::min<int>(n, sizeof(msg) - 1));
     }
     re1Proc(m_);
   }
@@ -62,8 +84,20 @@ state::ID state::Playing::run(msg::EFFECT_KEY const *src) noexcept
   {
     if (src->button[i] == msg::BUTTON_DOWN)
     {
-      m_.changePatch(i);
-      modBank();
+      // 選択中のパッチのボタンは、使うエフェクター（ルーパー・フリーズ）があればその操作に使う
+      bool used = false;
+      if (i == m_.getPatchNum())
+      {
+        for (uint8_t n = 0; n < MAX_EFFECTOR_COUNT; ++n)
+        {
+          used = m_.getFx(n)->notifyEffectKey() || used;
+        }
+      }
+      if (!used)
+      {
+        m_.changePatch(i);
+        modBank();
+      }
       break;
     }
   }
@@ -93,17 +127,12 @@ void state::Playing::modBank() noexcept
   msg::OLED_DISP_BANK disp{};
   disp.bank = m_.getBankNum() + 1;
   disp.patch = m_.getPatchNum() + 1;
-  for (size_t i = 0; i < countof(disp.fx); ++i)
+  for (size_t i = 0; i < countof(disp.name); ++i)
   {
-    disp.fx[i] = m_.getFx(i);
+    disp.name[i] = m_.getFx(i)->getName();
   }
   msg::send(i2cTaskHandle, msg::OLED_DISP_BANK_REQ, disp);
-  msg::SOUND_EFFECTOR sound{};
-  for (size_t i = 0; i < countof(sound.fx); ++i)
-  {
-    sound.fx[i] = disp.fx[i];
-  }
-  msg::send(soundTaskHandle, msg::SOUND_CHANGE_EFFECTOR_REQ, sound);
+  m_.sendFx();
   msg::LED_ALL_EFFECT led{};
   led.rgb[m_.getPatchNum()] = m_.getCurrentColor();
   msg::send(i2cTaskHandle, msg::LED_ALL_EFFECT_REQ, led);
@@ -10,101 +10,128 @@
 #include "effector/booster.hpp"
 #include "effector/bq_filter.hpp"
 #include "effector/bypass.hpp"
+#include "effector/cabinet.hpp"
 #include "effector/chorus.hpp"
 #include "effector/compressor.hpp"
 #include "effector/delay_ram.hpp"
 #include "effector/delay_spi.hpp"
 #include "effector/distortion.hpp"
+#include "effector/ensemble.hpp"
+#include "effector/freeze.hpp"
+#include "effector/harmonizer.hpp"
+#include "effector/looper.hpp"
+#include "effector/noise_gate.hpp"
 #include "effector/oscillator.hpp"
 #include "effector/overdrive.hpp"
 #include "effector/phaser.hpp"
+#include "effector/pitch_shifter.hpp"
 #include "effector/reverb.hpp"
 #include "effector/tremolo.hpp"
 #include "factory_reset.h"
 #include "main.h"
+#include "message/type.h"
+#include "task/handles.h"
+#include <algorithm>
 
 namespace fx = satoh::fx;
+namespace msg = satoh::msg;
 namespace state = satoh::state;
 
 // state::Effectors
 
-state::Effectors::Effectors(uint8_t n, SpiMaster *spi) : count_(0)
+state::Effectors::Effectors(uint8_t n, SpiMaster *spi) noexcept
+    : count_(0), spi_(spi), active_(0), occupant_(0), want_(fx::BYPASS)
 {
-  addList<fx::Bypass>(true);
+  addList<fx::Bypass>(true, true); // メモリ不足の時の代用にするので常駐させる
   addList<fx::Booster>(true);
   addList<fx::OverDrive>(true);
   addList<fx::Distortion>(true);
   addList<fx::Chorus>(true);
+  addList<fx::Ensemble>(true);
   addList<fx::Phaser>(true);
   addList<fx::Tremolo>(true);
   addList<fx::Compressor>(true);
   addList<fx::DelayRam>(1 <= n);
-  // addList<fx::DelaySpi>(n == 2, spi);
+  // addList<fx::DelaySpi>(n == 2);
   addList<fx::Oscillator>(n == 0);
   addList<fx::AutoWah>(n == 0);
   addList<fx::BqFilter>(true);
   addList<fx::Reverb>(n == 2);
-}
-
-fx::EffectorBase *state::Effectors::getFx(size_t i) noexcept
-{
-  return list_[i % count()].get();
-}
-
-fx::EffectorBase const *state::Effectors::getFx(size_t i) const noexcept
-{
-  return const_cast<Effectors *>(this)->getFx(i);
-}
-
-fx::EffectorBase *state::Effectors::getFxById(fx::ID id) noexcept
-{
-  for (size_t i = 0; i < count(); ++i)
+  addList<fx::Cabinet>(n == 1);
+  addList<fx::NoiseGate>(true);
+  addList<fx::PitchShifter>(n == 0);
+  addList<fx::Harmonizer>(n == 0);
+  addList<fx::Looper>(n == 2, true); // SPI SRAM転送タスクが参照し、DMAメモリも使うので常駐させる（パッチを変えても録音が残る）
+  addList<fx::Freeze>(n == 1);
+  size_t size = 0;
+  for (size_t i = 0; i < count_; ++i)
   {
-    auto *a = getFx(i);
-    if (id == a->getID())
+    if (!list_[i].resident)
     {
-      return a;
+      size = std::max(size, list_[i].need);
     }
   }
-  return getFx(0);
+  arena_.init(size); // 確保できなければ、常駐していないエフェクターはバイパスで代用する
 }
 
-fx::EffectorBase const *state::Effectors::getFxById(fx::ID id) const noexcept
+size_t state::Effectors::indexOf(fx::ID id) const noexcept
 {
-  return const_cast<Effectors *>(this)->getFxById(id);
+  for (size_t i = 0; i < count_; ++i)
+  {
+    if (list_[i].id == id)
+    {
+      return i;
+    }
+  }
+  return 0;
 }
 
-size_t state::Effectors::count() const noexcept
+bool state::Effectors::needsDetach(fx::ID id) const noexcept
 {
-  return count_;
+  return !list_[indexOf(id)].fx && occupant_;
 }
 
-int state::Effectors::find(fx::EffectorBase const *fx)
+fx::EffectorBase *state::Effectors::select(fx::ID id, bool detached) noexcept
 {
-  if (fx == 0)
+  Entry *dst = &list_[indexOf(id)];
+  want_ = dst->id;
+  if (!dst->fx && (!occupant_ || detached))
   {
-    return -2;
-  }
-  for (size_t i = 0; i < count(); ++i)
-  {
-    if (getFx(i) == fx)
+    if (occupant_)
+    {
+      occupant_->fx.reset(); // アリーナのメモリは個別に開放せず、まとめて捨てる
+      occupant_ = 0;
+    }
+    arena_.reset();
+    if (dst->need <= arena_.getFreeSize())
     {
-      return static_cast<int>(i);
+      Arena::Scope scope(&arena_);
+      dst->fx.reset(dst->create(spi_));
     }
+    if (dst->fx && !*dst->fx)
+    {
+      dst->fx.reset(); // 途中で確保に失敗したものは残さない
+    }
+    occupant_ = dst->fx ? dst : 0;
   }
-  return -1;
+  if (!dst->fx)
+  {
+    dst = &list_[0]; // 作り直せなければ常駐しているバイパスで代用する
+  }
+  active_ = dst;
+  return dst->fx.get();
 }
 
-fx::EffectorBase *state::Effectors::getNext(fx::EffectorBase const *cur, bool next) noexcept
+fx::ID state::Effectors::getNextId(bool next) const noexcept
 {
-  int ix = find(cur);
-  if (ix < 0)
-  {
-    return getFx(0);
-  }
-  int d = next ? 1 : -1;
-  ix = (ix + d + count()) % count();
-  return getFx(ix);
+  size_t ix = indexOf(want_);
+  ix = next ? (ix + 1) % count_ : (ix + count_ - 1) % count_;
+  return list_[ix].id;
+}
+
+bool state::Effectors::isSubstituted() const noexcept
+{
+  return active_ && active_->id != want_;
 }
 
 // state::EffectParam
@@ -176,14 +203,65 @@ void state::Tap::reset() noexcept
 void state::Property::loadPatch() noexcept
 {
   auto const &pch = getCurrectPatch();
+  bool detach[MAX_EFFECTOR_COUNT] = {};
+  for (size_t i = 0; i < countof(effectors_); ++i)
+  {
+    detach[i] = effectors_[i].needsDetach(pch.param[i].id);
+  }
+  const bool detached = detachFx(detach);
   for (size_t i = 0; i < countof(effectors_); ++i)
   {
     auto &param = pch.param[i];
-    fx_[i] = effectors_[i].getFxById(param.id);
+    fx_[i] = effectors_[i].select(param.id, detached);
     param.write(fx_[i]);
   }
 }
 
+bool state::Property::detachFx(bool const *detach) noexcept
+{
+  constexpr uint32_t timeout = 100; // 音声タスクの応答を待つ時間（ミリ秒）
+  constexpr uint32_t retry = 10;    // 送り直す間隔（ミリ秒）
+  if (!shared_ || std::none_of(detach, detach + MAX_EFFECTOR_COUNT, [](bool b) { return b; }))
+  {
+    return true;
+  }
+  msg::SOUND_EFFECTOR cmd{};
+  for (size_t i = 0; i < countof(cmd.fx); ++i)
+  {
+    cmd.fx[i] = detach[i] ? 0 : fx_[i];
+  }
+  cmd.gen = ++fxGen_;
+  cmd.applied = &soundGen_;
+  for (uint32_t t = 0; t < timeout; ++t)
+  {
+    if (t % retry == 0)
+    {
+      msg::send(soundTaskHandle, msg::SOUND_CHANGE_EFFECTOR_REQ, cmd); // 送れなかった時に備えて送り直す
+    }
+    osDelay(1);
+    if (soundGen_.load() == cmd.gen)
+    {
+      return true; // FIFOなので、これより前に送ったエフェクターも参照されない
+    }
+  }
+  return false;
+}
+
+void state::Property::sendFx() noexcept
+{
+  msg::SOUND_EFFECTOR cmd{};
+  for (size_t i = 0; i < countof(cmd.fx); ++i)
+  {
+    cmd.fx[i] = fx_[i];
+  }
+  cmd.gen = ++fxGen_;
+  cmd.applied = &soundGen_;
+  if (msg::send(soundTaskHandle, msg::SOUND_CHANGE_EFFECTOR_REQ, cmd) == osOK)
+  {
+    shared_ = true;
+  }
+}
+
 state::Property::Property(PatchTable *patch, SpiMaster *spi) //
     : bankNum_(0),                                           //
       patchNum_(0),                                          //
@@ -191,6 +269,9 @@ state::Property::Property(PatchTable *patch, SpiMaster *spi) //
                  Effectors(1, spi),                          //
                  Effectors(2, spi)},                         //
       patches_(patch),                                       //
+      fxGen_(0),                                             //
+      soundGen_(0),                                          //
+      shared_(false),                                        //
       editSelectedFxNum_(0),                                 //
       error_(msg::error::NONE)                               //
 {
@@ -279,15 +360,21 @@ void state::Property::savePatch() noexcept
   auto &pch = getCurrectPatch();
   for (size_t i = 0; i < countof(effectors_); ++i)
   {
-    pch.param[i].read(fx_[i]);
+    if (!effectors_[i].isSubstituted()) // メモリ不足で代用したバイパスは保存しない
+    {
+      pch.param[i].read(fx_[i]);
+    }
   }
   patches_->crc_ = patches_->calcCrc();
 }
 
 void state::Property::updateNextFx(bool up) noexcept
 {
-  auto *cur = fx_[editSelectedFxNum_];
-  auto *dst = effectors_[editSelectedFxNum_].getNext(cur, up);
+  auto &list = effectors_[editSelectedFxNum_];
+  const fx::ID id = list.getNextId(up);
+  bool detach[MAX_EFFECTOR_COUNT] = {};
+  detach[editSelectedFxNum_] = list.needsDetach(id);
+  auto *dst = list.select(id, detachFx(detach));
   dst->setDefaultParam();
   fx_[editSelectedFxNum_] = dst;
 }
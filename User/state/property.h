@@ -12,7 +12,9 @@
 #include "effector/tuner.h"
 #include "message/error.h"
 #include "peripheral/spi_master.h"
+#include <atomic>
 #include <memory>
+#include <type_traits> // std::is_constructible
 
 namespace satoh
 {
@@ -28,71 +30,128 @@ class Property;
 } // namespace satoh
 
 /// @brief エフェクター一覧型
+/// @note 起動時はエフェクターの生成方法だけを登録し、実体は選択された時にこのFX番号専用のアリーナへ生成する。
+///   登録時に一度だけ生成して必要なメモリ量を測り、アリーナは一覧の中で最大の必要量で確保する。
+///   アリーナに置けるのは1つだけなので、別のエフェクターを生成する時は、今のエフェクターを音声タスクから
+///   外してから（Property が行う）破棄し、アリーナをまとめて捨てて作り直す。作り直せなければバイパスで代用する。
+///   常駐するエフェクターは起動時に RTOS から確保したまま破棄しない。
 class satoh::state::Effectors
 {
   /// @brief デフォルトコンストラクタ削除
   Effectors() = delete;
   /// エフェクターポインタ型
   using Ptr = UniquePtr<fx::EffectorBase>;
+  /// エフェクター生成関数型
+  using Create = fx::EffectorBase *(*)(SpiMaster *spi);
+  /// @brief エフェクター一覧の要素
+  struct Entry
+  {
+    Create create; ///< 生成関数
+    fx::ID id;     ///< エフェクターID
+    bool resident; ///< 常駐（一度生成したら破棄しない）
+    size_t need;   ///< 生成に必要なアリーナのバイト数
+    Ptr fx;        ///< 生成したエフェクター（未生成ならば0）
+  };
   /// エフェクター一覧
-  Ptr list_[16];
+  Entry list_[20];
   /// エフェクター数
   size_t count_;
+  /// SPI SRAM通信オブジェクト
+  SpiMaster *spi_;
+  /// エフェクターを生成するアリーナ
+  Arena arena_;
+  /// 選択中のエフェクター
+  Entry *active_;
+  /// アリーナに生成しているエフェクター（0ならばアリーナは空）
+  Entry *occupant_;
+  /// 選択を要求されたエフェクターID（バイパスで代用している間は active_ と異なる）
+  fx::ID want_;
+  /// @brief エフェクターを生成する
+  /// @tparam FX エフェクター種類
+  /// @param [in] spi SPI SRAM通信オブジェクト（コンストラクタ引数に取るエフェクターのみに渡す）
+  /// @return エフェクター
+  template <typename FX>
+  static fx::EffectorBase *create(SpiMaster *spi) noexcept
+  {
+    return create<FX>(spi, std::is_constructible<FX, SpiMaster *>());
+  }
+  /// @brief エフェクターを生成する（SPI SRAMを使うエフェクター）
+  template <typename FX>
+  static fx::EffectorBase *create(SpiMaster *spi, std::true_type) noexcept
+  {
+    return alloc<FX>(spi);
+  }
+  /// @brief エフェクターを生成する（SPI SRAMを使わないエフェクター）
+  template <typename FX>
+  static fx::EffectorBase *create(SpiMaster *, std::false_type) noexcept
+  {
+    return alloc<FX>();
+  }
   /// @brief エフェクターを一覧に追加する
   /// @tparam FX エフェクター種類
-  /// @tparam Args エフェクタークラスコンストラクタ引数型
   /// @param [in] cond 追加条件（trueならば追加する）
-  /// @param [in] args エフェクタークラスコンストラクタ引数
-  template <typename FX, class... Args>
-  void addList(bool cond, Args... args)
+  /// @param [in] resident 常駐（trueならば起動時に生成したまま破棄しない）
+  /// @note 一度生成して必要なメモリ量を測る。生成に失敗したエフェクターは一覧に載せない。
+  template <typename FX>
+  void addList(bool cond, bool resident = false) noexcept
   {
-    if (cond)
+    if (!cond || count_ == sizeof(list_) / sizeof(list_[0]))
+    {
+      return;
+    }
+    Arena meter; // 確保量を数えるだけ（RTOSから確保する）
+    Ptr ptr;
     {
-      Ptr ptr(alloc<FX>(args...));
-      if (*ptr)
-      {
-        list_[count_++] = std::move(ptr);
-      }
+      Arena::Scope scope(&meter);
+      ptr.reset(create<FX>(spi_));
+    }
+    if (!*ptr)
+    {
+      return;
+    }
+    Entry &e = list_[count_++];
+    e.create = create<FX>;
+    e.id = ptr->getID();
+    e.resident = resident;
+    e.need = meter.getUsedSize();
+    if (resident)
+    {
+      e.fx = std::move(ptr);
     }
   }
+  /// @brief エフェクターIDから一覧の位置を検索する
+  /// @param [in] id エフェクターID
+  /// @return 一覧の位置（見つからなければ先頭）
+  size_t indexOf(fx::ID id) const noexcept;
 
 public:
   /// @brief コンストラクタ
   /// @param [in] n FX番号（0, 1, 2）
   /// @param [in] spi SPI SRAM通信オブジェクト
   explicit Effectors(uint8_t n, SpiMaster *spi) noexcept;
-  /// @brief エフェクター取得
-  /// @param [in] i インデックス
-  /// @return エフェクター
-  fx::EffectorBase *getFx(size_t i) noexcept;
-  /// @brief エフェクター取得
-  /// @param [in] i インデックス
-  /// @return エフェクター
-  fx::EffectorBase const *getFx(size_t i) const noexcept;
-  /// @brief エフェクター取得
+  /// @brief エフェクターを選択するために、アリーナのエフェクターを音声タスクから外す必要があるか
   /// @param [in] id エフェクターID
-  /// @return エフェクター
-  fx::EffectorBase *getFxById(fx::ID id) noexcept;
-  /// @brief エフェクター取得
-  /// @param [in] id エフェクターID
-  /// @return エフェクター
-  fx::EffectorBase const *getFxById(fx::ID id) const noexcept;
-  /// @brief エフェクター数を取得
-  /// @return エフェクター数
-  size_t count() const noexcept;
-  /// @brief エフェクター一覧から検索してインデックスを返す
-  /// @param [in] fx 検索対象のエフェクター
-  /// @retval 0以上 インデックス
-  /// @retval -1 見つからない
-  /// @retval -2 引数がNULL
-  int find(fx::EffectorBase const *fx);
-  /// @brief 次のエフェクターを取得
-  /// @param [in] cur 現在選択中のエフェクター
+  /// @retval true 外す必要がある（アリーナを作り直す）
+  /// @retval false 外さずに選択できる
+  bool needsDetach(fx::ID id) const noexcept;
+  /// @brief エフェクターを選択する（未生成ならばアリーナを作り直して生成する）
+  /// @param [in] id エフェクターID（一覧になければ先頭のエフェクター）
+  /// @param [in] detached アリーナのエフェクターを音声タスクから外した（falseならばアリーナは作り直さない）
+  /// @return 選択したエフェクター（生成できなければ先頭のエフェクター）
+  fx::EffectorBase *select(fx::ID id, bool detached) noexcept;
+  /// @brief 選択中の次のエフェクターIDを取得
   /// @param [in] next
   ///   @arg true 次のエフェクターを検索
   ///   @arg false 前のエフェクターを検索
-  /// @return 次 or 前のエフェクター
-  fx::EffectorBase *getNext(fx::EffectorBase const *cur, bool next) noexcept;
+  /// @return 次 or 前のエフェクターID
+  fx::ID getNextId(bool next) const noexcept;
+  /// @brief 選択を要求されたエフェクターの代わりにバイパスを使っているか
+  /// @retval true 代用している
+  /// @retval false 要求どおり
+  bool isSubstituted() const noexcept;
+  /// @brief アリーナを取得する（使用量の統計）
+  /// @return アリーナ
+  Arena const &getArena() const noexcept { return arena_; }
 };
 
 /// @brief １つのエフェクターが持つデータ
@@ -173,6 +232,12 @@ class satoh::state::Property
   PatchTable *patches_;
   /// 現在有効になっているエフェクター
   fx::EffectorBase *fx_[MAX_EFFECTOR_COUNT];
+  /// 音声タスクへ送ったエフェクターの世代
+  uint32_t fxGen_;
+  /// 音声タスクが反映したエフェクターの世代
+  std::atomic<uint32_t> soundGen_;
+  /// 音声タスクへエフェクターを渡したことがある
+  bool shared_;
   /// 編集中のエフェクト番号
   uint8_t editSelectedFxNum_;
   /// エラー原因
@@ -183,6 +248,11 @@ class satoh::state::Property
   Tap tap_;
   /// @brief パッチをロードする
   void loadPatch() noexcept;
+  /// @brief アリーナを作り直すFX番号のエフェクターを音声タスクから外し、反映されるまで待つ
+  /// @param [in] detach FX番号毎の外す・外さない
+  /// @retval true 外した（または音声タスクへまだ渡していない）
+  /// @retval false 音声タスクが応答しない
+  bool detachFx(bool const *detach) noexcept;
 
 public:
   /// @brief コンストラクタ
@@ -259,4 +329,8 @@ public:
   Tap *getTap() noexcept { return &tap_; }
   /// @brief TAPを取得する @return TAP
   Tap const *getTap() const noexcept { return &tap_; }
+  /// @brief 現在のエフェクターを音声タスクへ渡す
+  void sendFx() noexcept;
+  /// @brief FX番号毎のアリーナを取得する（使用量の統計） @param[in] n 0, 1, 2 @return アリーナ
+  Arena const &getArena(uint8_t n) const noexcept { return effectors_[n].getArena(); }
 };
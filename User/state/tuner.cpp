@@ -43,6 +43,21 @@ constexpr Tone TONES[] = {
     {110.0f, 113.2232f, "A"},    //
 };
 
+/// @brief 基準周波数とのずれを求める
+/// @param[in] freq 周波数
+/// @param[in] ref 基準周波数
+/// @return ずれ（-7 〜 7 0ならば一致している）
+int calcDiff(float freq, float ref)
+{
+  for (int i = -7; i <= 7; ++i)
+  {
+    if (freq < ref * std::pow(1.00828f, i))
+    {
+      return i;
+    }
+  }
+  return 7;
+}
 /// @brief 音名・ずれを分析する @param[in] freq 周波数 @return 分析結果
 msg::OLED_DISP_TUNER analyze(float freq)
 {
@@ -58,20 +73,26 @@ msg::OLED_DISP_TUNER analyze(float freq)
     if (freq < t.maxFreq)
     {
       strcpy(dst.name, t.name);
-      for (int i = -7; i <= 7; ++i)
-      {
-        float th = t.freq * std::pow(1.00828f, i);
-        if (freq < th)
-        {
-          dst.diff = i;
-          break;
-        }
-      }
+      dst.diff = calcDiff(freq, t.freq);
       break;
     }
   }
   return dst;
 }
+/// @brief 弦毎のずれを分析する @param[in] tuner チューナー @return 分析結果
+msg::OLED_DISP_TUNER analyzePoly(satoh::fx::Tuner const *tuner)
+{
+  msg::OLED_DISP_TUNER dst{};
+  dst.poly = true;
+  for (uint8_t n = 0; n < satoh::fx::Tuner::STRING_COUNT; ++n)
+  {
+    float freq = tuner->getStringFreq(n);
+    strcpy(dst.strName[n], satoh::fx::Tuner::getStringName(n));
+    dst.strEstimated[n] = 0.0f < freq;
+    dst.strDiff[n] = 0.0f < freq ? calcDiff(freq, satoh::fx::Tuner::getStringNominalFreq(n)) : 0;
+  }
+  return dst;
+}
 } // namespace
 
 state::ID state::Tuner::run(msg::MODE_KEY const *src) noexcept
@@ -84,11 +105,10 @@ state::ID state::Tuner::run(msg::MODE_KEY const *src) noexcept
   {
     return PLAYING;
   }
-  if (src->up == msg::BUTTON_DOWN)
-  {
-  }
-  if (src->down == msg::BUTTON_DOWN)
+  if (src->up == msg::BUTTON_DOWN || src->down == msg::BUTTON_DOWN)
   {
+    poly_ = !poly_;
+    start();
   }
   if (src->tap == msg::BUTTON_DOWN)
   {
@@ -137,9 +157,10 @@ state::ID state::Tuner::timer() noexcept
 {
   fx::Tuner *tuner = m_.getTuner();
   msg::OLED_DISP_TUNER cmd{};
+  cmd.poly = poly_;
   if (osKernelSysTick() - tuner->getLastUpdateTime() < 500)
   {
-    cmd = analyze(tuner->getEstimatedFreq());
+    cmd = poly_ ? analyzePoly(tuner) : analyze(tuner->getEstimatedFreq());
   }
   msg::send(i2cTaskHandle, msg::OLED_DISP_TUNER_REQ, cmd);
   return id();
@@ -155,5 +176,11 @@ void state::Tuner::init() noexcept
     cmd.fx[0] = m_.getTuner();
     msg::send(soundTaskHandle, msg::SOUND_CHANGE_EFFECTOR_REQ, cmd);
   }
+  start();
+}
+void state::Tuner::start() noexcept
+{
+  msg::TUNER_START cmd{m_.getTuner(), poly_};
+  msg::send(tunerTaskHandle, msg::TUNER_START_REQ, cmd);
 }
-void state::Tuner::deinit() noexcept {}
+void state::Tuner::deinit() noexcept { msg::send(tunerTaskHandle, msg::TUNER_STOP_REQ); }
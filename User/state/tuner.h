@@ -21,6 +21,10 @@ class satoh::state::Tuner : public satoh::state::Base
 {
   /// プロパティ
   Property &m_;
+  /// ポリフォニックモード
+  bool poly_;
+  /// @brief チューナータスクへ解析開始を依頼する
+  void start() noexcept;
   /// @brief MODE_KEYを処理する @param[in] src MODE_KEY @return 次の状態ID
   ID run(msg::MODE_KEY const *src) noexcept override;
   /// @brief EFFECT_KEYを処理する @param[in] src EFFECT_KEY @return 次の状態ID
@@ -37,7 +41,7 @@ class satoh::state::Tuner : public satoh::state::Base
 public:
   /// @brief コンストラクタ
   /// @param [in] prop プロパティ
-  explicit Tuner(Property &prop) : m_(prop) {}
+  explicit Tuner(Property &prop) : m_(prop), poly_(false) {}
   /// @brief デストラクタ
   ~Tuner() {}
   /// @brief 状態IDを取得する @return 状態ID
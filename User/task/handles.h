@@ -14,3 +14,8 @@ extern osThreadId neoPixelTaskHandle;
 extern osThreadId appTaskHandle;
 extern osThreadId soundTaskHandle;
 extern osThreadId adcTaskHandle;
+extern osThreadId tunerTaskHandle;
+extern osThreadId sramTaskHandle;
+
+/// i2cTaskが格納できる最大メッセージ数
+constexpr uint32_t I2C_TASK_MAIL_COUNT = 12;
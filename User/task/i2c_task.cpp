@@ -164,7 +164,7 @@ extern "C"
   void i2cTaskProc(void const *argument)
   {
     UNUSED(argument);
-    if (msg::registerThread(12) != osOK)
+    if (msg::registerThread(I2C_TASK_MAIL_COUNT) != osOK)
     {
       return;
     }
@@ -6,11 +6,16 @@
 
 #include "common/alloc.hpp"
 #include "common/dma_mem.h"
+#include "common/fpu.h"
+#include "effector/lib/lib_lfo.hpp"
+#include "effector/lib/lib_tempo.hpp"
+#include "effector/limiter.hpp"
 #include "effector/pop_noise_reductor.hpp"
 #include "handles.h"
 #include "main.h"
 #include "message/type.h"
 #include "peripheral/i2c.h"
+#include <cstdio> // snprintf
 
 namespace fx = satoh::fx;
 namespace msg = satoh::msg;
@@ -21,6 +26,22 @@ namespace
 constexpr int32_t SIG_INITADC = 1 << 0;
 /// 音声信号を整数・浮動小数変換するための係数
 constexpr uint32_t DIV = 0x80000000;
+/// int32に変換できる最大値（1.0f は int32 の範囲を超える）
+constexpr float MAX_FLOAT = 0.99999994f;
+
+/// @brief リミッター処理時間の計測結果
+struct LimiterStat
+{
+  uint32_t last; ///< 直近のブロックの処理サイクル数
+  uint32_t max;  ///< 最大処理サイクル数
+};
+
+/// @brief エフェクター毎の無音入力の状況
+struct IdleState
+{
+  uint32_t count; ///< 続けて無音を入力したサンプル数（テール長で飽和）
+  bool cleared;   ///< 内部状態を初期化して処理を省略している
+};
 
 /// @brief float(-1.0f 〜 1.0f)に変換する
 /// @param [in] src 入力音声
@@ -35,7 +56,7 @@ inline void toFloat(int32_t const *src, float *left, float *right, uint32_t size
     right[i] = static_cast<float>(src[i * 2 + 1]) / DIV;
   }
 }
-/// @brief int32に変換する
+/// @brief int32に変換する（範囲外は飽和させる）
 /// @param [in] left Left音声
 /// @param [in] right Right音声
 /// @param [out] dst 出力音声
@@ -44,30 +65,115 @@ inline void toInt32(float const *left, float const *right, int32_t *dst, uint32_
 {
   for (uint32_t i = 0; i < size; ++i)
   {
-    dst[i * 2] = static_cast<int32_t>(left[i] * DIV);
-    dst[i * 2 + 1] = static_cast<int32_t>(right[i] * DIV);
+    dst[i * 2] = static_cast<int32_t>(std::max(-1.0f, std::min(left[i], MAX_FLOAT)) * DIV);
+    dst[i * 2 + 1] = static_cast<int32_t>(std::max(-1.0f, std::min(right[i], MAX_FLOAT)) * DIV);
+  }
+}
+/// @brief 無音か判定する（完全に0の場合のみ無音とする）
+/// @param [in] left Left音声
+/// @param [in] right Right音声
+/// @param [in] size LRそれぞれの音声データ数
+/// @retval true 無音
+/// @retval false 無音ではない
+inline bool isSilent(float const *left, float const *right, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; ++i)
+  {
+    if (left[i] != 0.0f || right[i] != 0.0f)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+/// @brief エフェクターを実行する（無音入力が続き、出力も内部状態も落ち着いたエフェクターは処理を省略する）
+/// @param [in] effector エフェクター
+/// @param[inout] idle エフェクター毎の無音入力の状況
+/// @param[inout] left L音声データ
+/// @param[inout] right R音声データ
+/// @param [in] size 音声データ数
+/// @note 省略を始める時に clearState() で内部状態を初期化する（捨てるのは -120dB 以下の残りのみ）。
+///   初期化後に無音を入力しても出力は無音で内部状態も変わらないため、省略中の出力と再開後の出力は、
+///   初期化後に省略せず処理し続けた場合とビット単位で一致する。
+ITCM_CODE void runEffectors(msg::SOUND_EFFECTOR &effector, IdleState *idle, float *left, float *right, uint32_t size)
+{
+  bool silent = isSilent(left, right, size);
+  for (uint32_t n = 0; n < satoh::MAX_EFFECTOR_COUNT; ++n)
+  {
+    auto *fx = effector.fx[n];
+    if (!fx)
+    {
+      continue;
+    }
+    IdleState &st = idle[n];
+    if (!silent)
+    {
+      st.count = 0;
+      st.cleared = false;
+    }
+    else
+    {
+      const uint32_t tail = fx->getTailLength();
+      if (tail != fx::TAIL_INFINITE && tail <= st.count)
+      {
+        if (!st.cleared)
+        {
+          fx->clearState();
+          st.cleared = true;
+        }
+        continue; // 出力も無音
+      }
+      st.count += std::min(size, tail - st.count);
+    }
+    fx->effect(left, right, size);
+    silent = fx->isOutputSilent() || isSilent(left, right, size);
   }
 }
+/// @brief サイクルカウンタ（DWT CYCCNT）を有効にする
+inline void enableCycleCounter()
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->LAR = 0xC5ACCE55; // Cortex-M7 はロック解除が必要
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+/// @brief リミッターのレイテンシと処理時間をUSBへ送る
+/// @param [in] stat 処理時間の計測結果
+void sendLimiterReport(LimiterStat const &stat)
+{
+  char txt[64];
+  int len = snprintf(txt, sizeof(txt), "LIMITER latency %lu smp, %lu cyc/blk (max %lu)\r\n", //
+                     static_cast<unsigned long>(fx::Limiter::LOOKAHEAD),                       //
+                     static_cast<unsigned long>(stat.last),                                    //
+                     static_cast<unsigned long>(stat.max));
+  msg::send(usbTxTaskHandle, msg::USB_TX_REQ, txt, static_cast<uint16_t>(std::min<int>(len, sizeof(txt) - 1)));
+}
 /// @brief 音声処理
 /// @param [in] effector エフェクター
+/// @param[inout] idle エフェクター毎の無音入力の状況
+/// @param[inout] tempo テンポクロック
+/// @param[inout] lfo LFO プール
 /// @param [in] pop ポップノイズ除去
+/// @param [in] limiter 出力段リミッター
+/// @param [out] stat リミッター処理時間の計測結果
 /// @param [in] src 音声入力データ
 /// @param [out] dst 音声出力データ
 /// @param [in] left L音声計算用バッファ
 /// @param [in] right R音声計算用バッファ
 /// @param [in] size 音声データ数
-void soundProc(msg::SOUND_EFFECTOR &effector, fx::PopNoiseReductor &pop, int32_t const *src, int32_t *dst, float *left, float *right, uint32_t size)
+ITCM_CODE void soundProc(msg::SOUND_EFFECTOR &effector, IdleState *idle, satoh::TempoClock &tempo, satoh::LfoPool &lfo, fx::PopNoiseReductor &pop,
+                         fx::Limiter &limiter, LimiterStat &stat, int32_t const *src, int32_t *dst, float *left, float *right, uint32_t size)
 {
   LL_GPIO_SetOutputPin(TP13_GPIO_Port, TP13_Pin);
   toFloat(src, left, right, size);
-  for (auto *fx : effector.fx)
-  {
-    if (fx)
-    {
-      fx->effect(left, right, size);
-    }
-  }
+  lfo.update(size); // 購読されている LFO をブロック毎に1回だけ計算する
+  runEffectors(effector, idle, left, right, size);
+  tempo.advance(size); // 全エフェクターが同じブロック先頭の拍位置を使う
   pop.reduct(left, right, size);
+  uint32_t start = DWT->CYCCNT;
+  limiter.process(left, right, size);
+  stat.last = DWT->CYCCNT - start;
+  stat.max = std::max(stat.max, stat.last);
   toInt32(left, right, dst, size);
   LL_GPIO_ResetOutputPin(TP13_GPIO_Port, TP13_Pin);
 }
@@ -106,6 +212,7 @@ extern "C"
     {
       return;
     }
+    satoh::enableFlushToZero(); // 残響・フィードバックの減衰で非正規化数を作らない
     constexpr uint32_t BLOCK_SIZE_2 = satoh::BLOCK_SIZE * 2;
     constexpr uint32_t BLOCK_SIZE_4 = satoh::BLOCK_SIZE * 4;
     auto rxbuf = satoh::makeDmaMem<int32_t>(BLOCK_SIZE_4);    // 音声信号受信バッファ配列 Lch前半 Lch後半 Rch前半 Rch後半
@@ -123,7 +230,14 @@ extern "C"
     HAL_SAI_Transmit_DMA(&hsai_BlockB1, reinterpret_cast<uint8_t *>(txbuf.get()), BLOCK_SIZE_4);
     HAL_SAI_Receive_DMA(&hsai_BlockA1, reinterpret_cast<uint8_t *>(rxbuf.get()), BLOCK_SIZE_4);
     msg::SOUND_EFFECTOR effector{};
+    IdleState idle[satoh::MAX_EFFECTOR_COUNT]{};
+    satoh::TempoClock tempo;
+    satoh::LfoPool lfo;
+    lfo.setTempoClock(&tempo);
     fx::PopNoiseReductor pop(satoh::BLOCK_SIZE);
+    fx::Limiter limiter;
+    LimiterStat stat{};
+    enableCycleCounter();
     for (;;)
     {
       auto res = msg::recv();
@@ -135,14 +249,35 @@ extern "C"
       switch (msg->type)
       {
       case msg::SOUND_DMA_HALF_NOTIFY:
-        soundProc(effector, pop, rxbuf.get(), txbuf.get(), left.get(), right.get(), satoh::BLOCK_SIZE);
+        soundProc(effector, idle, tempo, lfo, pop, limiter, stat, rxbuf.get(), txbuf.get(), left.get(), right.get(), satoh::BLOCK_SIZE);
         break;
       case msg::SOUND_DMA_CPLT_NOTIFY:
-        soundProc(effector, pop, rxbuf.get() + BLOCK_SIZE_2, txbuf.get() + BLOCK_SIZE_2, left.get(), right.get(), satoh::BLOCK_SIZE);
+        soundProc(effector, idle, tempo, lfo, pop, limiter, stat, rxbuf.get() + BLOCK_SIZE_2, txbuf.get() + BLOCK_SIZE_2, left.get(), right.get(),
+                  satoh::BLOCK_SIZE);
         break;
       case msg::SOUND_CHANGE_EFFECTOR_REQ:
         effector = *msg->get<msg::SOUND_EFFECTOR>();
+        lfo.clear(); // 外れたエフェクターの購読を残さない（残ったエフェクターは次の処理で購読し直す）
+        for (auto *fx : effector.fx)
+        {
+          if (fx)
+          {
+            fx->setTempoClock(&tempo);
+            fx->setLfoPool(&lfo);
+          }
+        }
+        std::fill(idle, idle + satoh::MAX_EFFECTOR_COUNT, IdleState{});
         pop.init();
+        if (effector.applied)
+        {
+          effector.applied->store(effector.gen); // これ以降、外したエフェクターは参照しない
+        }
+        break;
+      case msg::SOUND_REPORT_REQ:
+        sendLimiterReport(stat);
+        break;
+      case msg::SOUND_TAP_NOTIFY:
+        tempo.tap(msg->get<msg::SOUND_TAP>()->interval);
         break;
       }
     }
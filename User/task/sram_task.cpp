@@ -0,0 +1,49 @@
+/// @file      task/sram_task.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#include "effector/lib/lib_loop_sram.hpp"
+#include "handles.h"
+#include "main.h"
+#include "message/type.h"
+
+namespace msg = satoh::msg;
+
+extern "C"
+{
+  /// @brief sramTask内部処理
+  /// @param [in] argument 未使用
+  /// @note SPI SRAM との通信は DMA 完了を待つため、音声タスクから要求を受けてこのタスクで行う。
+  ///   音声タスクより低く、アプリタスクより高い優先度で動かす。
+  void sramTaskProc(void const *argument)
+  {
+    UNUSED(argument);
+    if (msg::registerThread(4) != osOK)
+    {
+      return;
+    }
+    for (;;)
+    {
+      auto res = msg::recv();
+      auto *msg = res.msg();
+      if (!msg)
+      {
+        continue;
+      }
+      switch (msg->type)
+      {
+      case msg::SRAM_LOOP_NOTIFY:
+      {
+        auto *param = msg->get<msg::SRAM_LOOP>();
+        if (param->stream)
+        {
+          param->stream->serve(); // 通知が溢れて届かなくても、次の通知で溜まった要求をまとめて処理する
+        }
+        break;
+      }
+      }
+    }
+  }
+}
@@ -0,0 +1,67 @@
+/// @file      task/tuner_task.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#include "common/fpu.h"
+#include "effector/tuner.h"
+#include "handles.h"
+#include "main.h"
+#include "message/type.h"
+
+namespace fx = satoh::fx;
+namespace msg = satoh::msg;
+
+namespace
+{
+/// 解析中のポーリング間隔（ミリ秒）
+constexpr uint32_t POLLING_INTERVAL = 5;
+} // namespace
+
+extern "C"
+{
+  /// @brief tunerTask内部処理
+  /// @param [in] argument 未使用
+  /// @note 音声タスクの処理時間に影響しないよう、チューナーの周波数解析は低優先度のこのタスクで行う
+  void tunerTaskProc(void const *argument)
+  {
+    UNUSED(argument);
+    if (msg::registerThread(2) != osOK)
+    {
+      return;
+    }
+    satoh::enableFlushToZero(); // 解析用フィルタの減衰で非正規化数を作らない
+    fx::Tuner *tuner = 0;
+    for (;;)
+    {
+      auto res = msg::recv(tuner ? POLLING_INTERVAL : osWaitForever);
+      auto *msg = res.msg();
+      if (msg)
+      {
+        switch (msg->type)
+        {
+        case msg::TUNER_START_REQ:
+        {
+          auto *param = msg->get<msg::TUNER_START>();
+          tuner = param->tuner;
+          if (tuner)
+          {
+            tuner->reset(param->poly);
+          }
+          break;
+        }
+        case msg::TUNER_STOP_REQ:
+          tuner = 0;
+          break;
+        }
+      }
+      if (tuner)
+      {
+        while (tuner->analyze())
+        {
+        }
+      }
+    }
+  }
+}
@@ -1,6 +1,6 @@
 #!/bin/bash -eu
 HERE=$(cd $(dirname $0); pwd)
-TARGETS=(User)
+TARGETS=(User test)
 
 cd $HERE
 
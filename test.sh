@@ -0,0 +1,14 @@
+#!/bin/bash -eu
+HERE=$(cd $(dirname $0); pwd)
+BUILD=$HERE/build_test
+if [ ! -d $BUILD ]; then
+    mkdir $BUILD
+fi
+cd $BUILD
+CACHE=CMakeCache.txt
+if [ -e $CACHE ]; then
+    rm $CACHE
+fi
+cmake ../test
+make -j
+ctest --output-on-failure
@@ -0,0 +1,67 @@
+/// @file      bench_lib_conv.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// 均一分割畳み込みの IR長（分割数）毎の処理時間と、1ブロックの処理時間に収まる IR長
+// ホストでの計測値なので、実機の値は音声タスクのサイクル数（DWT CYCCNT）で確認する。
+
+#include "effector/lib/lib_conv.hpp"
+#include "test.h"
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr int REPEAT = 20000; ///< 計測するブロック数
+
+/// @brief 1ブロックの処理時間 @param [in] parts 分割数 @return ナノ秒
+double measure(uint32_t parts)
+{
+  UniformConvolver conv(parts);
+  std::vector<float> spec(parts * UniformConvolver::FFT_SIZE, 0.001f);
+  float block[BLOCK_SIZE] = {};
+  for (int i = 0; i < REPEAT / 10; ++i)
+  {
+    conv.process(block, block, spec.data(), parts); // 予熱
+  }
+  test::Stopwatch sw;
+  for (int i = 0; i < REPEAT; ++i)
+  {
+    block[i % BLOCK_SIZE] = 0.1f;
+    conv.process(block, block, spec.data(), parts);
+  }
+  return sw.ns() / REPEAT;
+}
+} // namespace
+
+int main()
+{
+  printf("block period %.0f ns\n", test::BLOCK_PERIOD_NS);
+  printf("%6s %8s %9s %12s %8s\n", "parts", "samples", "IR [ms]", "ns/block", "budget");
+  // 処理時間 = 固定分（FFT 2回） + 分割数 × 積和 として最小二乗法で当てはめる
+  double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (uint32_t parts : {1u, 2u, 5u, 10u, 20u, 40u, 80u, 160u})
+  {
+    const double ns = measure(parts);
+    printf("%6u %8u %9.1f %12.0f %7.1f%%\n", parts, parts * BLOCK_SIZE, 1e3f * parts * BLOCK_SIZE / SAMPLING_FREQ, ns, 100 * ns / test::BLOCK_PERIOD_NS);
+    n += 1;
+    sx += parts;
+    sy += ns;
+    sxx += static_cast<double>(parts) * parts;
+    sxy += parts * ns;
+  }
+  const double perPart = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+  const double fixed = (sy - perPart * sx) / n;
+  printf("fixed %.0f ns/block + %.0f ns/partition\n", fixed, perPart);
+  // ブロックの半分・全部に収まる IR長
+  for (double ratio : {0.5, 1.0})
+  {
+    const double parts = (ratio * test::BLOCK_PERIOD_NS - fixed) / perPart;
+    printf("IR that fits in %3.0f%% of the block : %.0f partitions = %.0f samples = %.0f ms\n", ratio * 100, parts, parts * BLOCK_SIZE,
+           1e3 * parts * BLOCK_SIZE / SAMPLING_FREQ);
+  }
+  return 0;
+}
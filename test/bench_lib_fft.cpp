@@ -0,0 +1,73 @@
+/// @file      bench_lib_fft.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// 実数FFT（RealFft）のサイズ毎の処理時間（インプレース・アウトオブプレース）
+// ホストでの計測値なので、実機の値は音声タスクのサイクル数（DWT CYCCNT）で確認する。
+
+#include "effector/lib/lib_fft.hpp"
+#include "test.h"
+#include <cmath>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t WORK = 1 << 24; ///< 1回の計測で処理するサンプル数の目安
+
+/// @brief N点の処理時間を表示する
+template <uint32_t N>
+void bench()
+{
+  RealFft<N> fft;
+  std::vector<float> a(N), b(N);
+  for (uint32_t i = 0; i < N; ++i)
+  {
+    a[i] = std::sin(0.1f * i);
+  }
+  const uint32_t repeat = WORK / N;
+  double ns[4] = {};
+  for (int mode = 0; mode < 4; ++mode)
+  {
+    test::Stopwatch sw;
+    for (uint32_t r = 0; r < repeat; ++r)
+    {
+      switch (mode)
+      {
+      case 0:
+        fft.forward(a.data(), b.data());
+        break;
+      case 1:
+        fft.inverse(b.data(), a.data());
+        break;
+      case 2:
+        fft.forward(a.data(), a.data());
+        break;
+      default:
+        fft.inverse(a.data(), a.data());
+        break;
+      }
+    }
+    ns[mode] = sw.ns() / repeat;
+  }
+  const double nlogn = N * std::log2(static_cast<double>(N));
+  printf("%5u %10.0f %10.0f %10.0f %10.0f %10.3f %7.2f%%\n", N, ns[0], ns[1], ns[2], ns[3], ns[0] / nlogn, 100 * ns[0] / test::BLOCK_PERIOD_NS);
+}
+} // namespace
+
+int main()
+{
+  printf("block period %.0f ns\n", test::BLOCK_PERIOD_NS);
+  printf("%5s %10s %10s %10s %10s %10s %8s\n", "N", "fwd [ns]", "inv [ns]", "fwd in", "inv in", "ns/NlogN", "budget");
+  bench<64>();
+  bench<128>();
+  bench<256>();
+  bench<512>();
+  bench<1024>();
+  bench<2048>();
+  bench<4096>();
+  return 0;
+}
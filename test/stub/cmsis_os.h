@@ -0,0 +1,63 @@
+/// @file      stub/cmsis_os.h
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+// ホストテスト用の RTOS 代替（テスト対象が使う関数だけを用意する）
+
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <cstdlib> // malloc, free
+
+typedef void *osThreadId;
+
+namespace stub
+{
+/// @brief RTOSのヒープの使用量（バイト）
+inline std::size_t &heapUsed() noexcept
+{
+  static std::size_t size = 0;
+  return size;
+}
+/// @brief RTOSのヒープから確保した回数
+inline uint32_t &heapAllocCount() noexcept
+{
+  static uint32_t count = 0;
+  return count;
+}
+} // namespace stub
+
+/// @brief メモリ確保（使用量を数えるため、先頭にバイト数を置く）
+inline void *pvPortMalloc(std::size_t size) noexcept
+{
+  auto *p = static_cast<std::size_t *>(std::malloc(size + 16));
+  if (!p)
+  {
+    return 0;
+  }
+  *p = size;
+  stub::heapUsed() += size;
+  ++stub::heapAllocCount();
+  return reinterpret_cast<uint8_t *>(p) + 16;
+}
+/// @brief メモリ開放
+inline void vPortFree(void *ptr) noexcept
+{
+  if (ptr)
+  {
+    auto *p = reinterpret_cast<std::size_t *>(static_cast<uint8_t *>(ptr) - 16);
+    stub::heapUsed() -= *p;
+    std::free(p);
+  }
+}
+/// @brief ヒープの空き容量（ホストでは使用量だけを数える）
+inline std::size_t xPortGetFreeHeapSize() noexcept { return 0; }
+/// @brief 呼び出したスレッド（ホストでは1スレッドのみ）
+inline osThreadId osThreadGetId() noexcept { return reinterpret_cast<osThreadId>(1); }
+/// @brief スケジューラー停止（ホストでは何もしない）
+inline void vTaskSuspendAll() noexcept {}
+/// @brief スケジューラー再開（ホストでは何もしない）
+inline long xTaskResumeAll() noexcept { return 0; }
@@ -0,0 +1,65 @@
+/// @file      test.h
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+#pragma once
+
+#include "constant.h"
+#include <chrono>
+#include <cstdio>
+
+namespace test
+{
+/// 1ブロックの処理に使える時間（ナノ秒）
+constexpr double BLOCK_PERIOD_NS = 1e9 * satoh::BLOCK_SIZE / satoh::SAMPLING_FREQ;
+
+/// @brief 失敗数
+inline int &failCount() noexcept
+{
+  static int count = 0;
+  return count;
+}
+/// @brief 判定する（失敗したら式と場所を表示する）
+/// @param [in] ok 判定結果
+/// @param [in] expr 式
+/// @param [in] file ファイル名
+/// @param [in] line 行番号
+inline void check(bool ok, char const *expr, char const *file, int line) noexcept
+{
+  if (!ok)
+  {
+    printf("%s:%d: NG %s\n", file, line, expr);
+    ++failCount();
+  }
+}
+/// @brief 結果を表示する
+/// @retval 0 成功
+/// @retval 1 失敗あり
+inline int result() noexcept
+{
+  if (failCount())
+  {
+    printf("NG (%d)\n", failCount());
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
+
+/// @brief 経過時間の計測
+class Stopwatch
+{
+  std::chrono::steady_clock::time_point start_; ///< 開始時刻
+
+public:
+  /// @brief コンストラクタ（計測開始）
+  Stopwatch() noexcept : start_(std::chrono::steady_clock::now()) {}
+  /// @brief 経過時間を取得 @return ナノ秒
+  double ns() const noexcept { return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count(); }
+};
+} // namespace test
+
+/// @brief 判定する（失敗しても続ける）
+#define CHECK(expr) test::check((expr), #expr, __FILE__, __LINE__)
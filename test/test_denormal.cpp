@@ -0,0 +1,167 @@
+/// @file      test_denormal.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// 各エフェクターに音を入れた後、60秒間無音を入れ続けて、ブロック毎の処理時間が増えない（非正規化数で遅くならない）ことを確かめる
+// 引数なしは Flush-to-zero を有効にして（音声タスクと同じ）、全エフェクターの処理時間が増えないことを確かめる。
+// 引数 off は無効のままで実行し、処理時間の増加を検出できる（この計測で非正規化数が見える）ことを確かめる。
+// SPI SRAM を使うエフェクター（DelaySpi・Looper）は対象外。
+
+#include "common/fpu.h"
+#include "effector/autowah.hpp"
+#include "effector/booster.hpp"
+#include "effector/bq_filter.hpp"
+#include "effector/cabinet.hpp"
+#include "effector/chorus.hpp"
+#include "effector/compressor.hpp"
+#include "effector/delay_ram.hpp"
+#include "effector/distortion.hpp"
+#include "effector/ensemble.hpp"
+#include "effector/freeze.hpp"
+#include "effector/harmonizer.hpp"
+#include "effector/limiter.hpp"
+#include "effector/noise_gate.hpp"
+#include "effector/overdrive.hpp"
+#include "effector/phaser.hpp"
+#include "effector/pitch_shifter.hpp"
+#include "effector/reverb.hpp"
+#include "effector/tremolo.hpp"
+#include "test.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t TONE_BLOCKS = static_cast<uint32_t>(1.0f * SAMPLING_FREQ / BLOCK_SIZE);     ///< 音を入れるブロック数（1秒）
+constexpr uint32_t SILENCE_BLOCKS = static_cast<uint32_t>(60.0f * SAMPLING_FREQ / BLOCK_SIZE); ///< 無音を入れるブロック数（60秒）
+constexpr uint32_t SEGMENT_COUNT = 10;                                                          ///< 無音区間の分割数（6秒毎）
+constexpr uint32_t SEGMENT_BLOCKS = SILENCE_BLOCKS / SEGMENT_COUNT;                             ///< 1区間のブロック数
+constexpr double MAX_GROWTH = 3.0; ///< 音を入れている間に対する処理時間の増加率の上限（非正規化数になると数十倍になる）
+
+/// @brief 処理時間の中央値 @param [in] v 処理時間 @return 中央値
+double median(std::vector<double> v)
+{
+  std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+  return v[v.size() / 2];
+}
+
+/// @brief 音を入れた後、無音を入れ続けて、区間毎の処理時間を音を入れている間と比べる
+/// @tparam FX エフェクター（effect(left, right, size) を持つ）
+/// @param [in] name 表示名
+/// @param [in] fx エフェクター
+/// @return 処理時間の増加率（無音区間の最大 / 音を入れている間）
+template <typename FX>
+double run(char const *name, FX &fx)
+{
+  float left[BLOCK_SIZE];
+  float right[BLOCK_SIZE];
+  uint32_t t = 0;
+  std::vector<double> ns(TONE_BLOCKS / 2);
+  for (uint32_t b = 0; b < TONE_BLOCKS; ++b)
+  {
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i, ++t)
+    {
+      right[i] = 0.3f * std::sin(2.0f * PI * 110.0f * t / SAMPLING_FREQ) + 0.1f * std::sin(2.0f * PI * 330.0f * t / SAMPLING_FREQ);
+      left[i] = right[i];
+    }
+    test::Stopwatch sw;
+    fx.effect(left, right, BLOCK_SIZE);
+    ns[b % ns.size()] = sw.ns(); // 後半の処理時間が残る
+  }
+  const double tone = median(ns);
+  ns.resize(SEGMENT_BLOCKS);
+  double seg[SEGMENT_COUNT];
+  for (uint32_t s = 0; s < SEGMENT_COUNT; ++s)
+  {
+    for (uint32_t b = 0; b < SEGMENT_BLOCKS; ++b)
+    {
+      memset(left, 0, sizeof(left));
+      memset(right, 0, sizeof(right));
+      test::Stopwatch sw;
+      fx.effect(left, right, BLOCK_SIZE);
+      ns[b] = sw.ns();
+    }
+    seg[s] = median(ns);
+  }
+  const double worst = *std::max_element(seg, seg + SEGMENT_COUNT);
+  const double growth = worst / tone;
+  printf("%-12s tone %8.0f  silence first 6s %8.0f  last 6s %8.0f ns/block  worst/tone %6.2f\n", name, tone, seg[0], seg[SEGMENT_COUNT - 1], growth);
+  return growth;
+}
+/// @brief エフェクターを生成して実行する
+/// @tparam FX エフェクター
+/// @param [in] name 表示名
+/// @return 処理時間の増加率
+template <typename FX>
+double run(char const *name)
+{
+  FX fx;
+  CHECK(static_cast<bool>(fx));
+  return run(name, fx);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  const bool ftz = argc < 2 || strcmp(argv[1], "off") != 0;
+  if (ftz)
+  {
+    enableFlushToZero();
+  }
+  printf("flush-to-zero %s\n", ftz ? "on" : "off");
+  struct
+  {
+    char const *name;
+    double growth;
+  } res[] = {
+      {"AutoWah", run<fx::AutoWah>("AutoWah")},
+      {"Booster", run<fx::Booster>("Booster")},
+      {"BqFilter", run<fx::BqFilter>("BqFilter")},
+      {"Cabinet", run<fx::Cabinet>("Cabinet")},
+      {"Chorus", run<fx::Chorus>("Chorus")},
+      {"Compressor", run<fx::Compressor>("Compressor")},
+      {"DelayRam", run<fx::DelayRam>("DelayRam")},
+      {"Distortion", run<fx::Distortion>("Distortion")},
+      {"Ensemble", run<fx::Ensemble>("Ensemble")},
+      {"Freeze", run<fx::Freeze>("Freeze")},
+      {"Harmonizer", run<fx::Harmonizer>("Harmonizer")},
+      {"NoiseGate", run<fx::NoiseGate>("NoiseGate")},
+      {"OverDrive", run<fx::OverDrive>("OverDrive")},
+      {"Phaser", run<fx::Phaser>("Phaser")},
+      {"PitchShifter", run<fx::PitchShifter>("PitchShifter")},
+      {"Reverb", run<fx::Reverb>("Reverb")},
+      {"Tremolo", run<fx::Tremolo>("Tremolo")},
+  };
+  fx::Limiter limiter; // 出力段
+  struct
+  {
+    fx::Limiter &limiter;
+    void effect(float *left, float *right, uint32_t size) noexcept { limiter.process(left, right, size); }
+  } stage{limiter};
+  const double limiterGrowth = run("Limiter", stage);
+  if (ftz)
+  {
+    for (auto const &r : res)
+    {
+      test::check(r.growth < MAX_GROWTH, r.name, __FILE__, __LINE__);
+    }
+    CHECK(limiterGrowth < MAX_GROWTH);
+  }
+  else
+  {
+    // 無効のままならば、減衰していくフィルタ・フィードバックのどれかで処理時間が増える
+    double worst = limiterGrowth;
+    for (auto const &r : res)
+    {
+      worst = std::max(worst, r.growth);
+    }
+    CHECK(MAX_GROWTH <= worst);
+  }
+  return test::result();
+}
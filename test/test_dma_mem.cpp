@@ -0,0 +1,290 @@
+/// @file      test_dma_mem.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// DMA転送用メモリ（allocDmaMem / freeDmaMem）を確かめる
+// 1. 分割・前後の空きブロックとの結合・ちょうど収まる場合
+// 2. 二重開放・範囲外の開放は無視する
+// 3. ランダムな確保・開放を、使用中のブロックを並べたモデルと比べる
+//    （8バイト境界・重なり・内容・使用量・空きブロック数・最大の空き・最大使用量・失敗回数）
+// 4. 演算用（allocDspMem）は別の領域で、DMA転送用の使用状況を変えない
+
+#include "common/dma_mem.h"
+#include "test.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <map>
+
+using namespace satoh;
+
+namespace
+{
+constexpr std::size_t HEADER_SIZE = 8;  ///< ブロックのヘッダーのバイト数
+constexpr uint32_t RANDOM_OPS = 200000; ///< ランダムな確保・開放の回数
+constexpr uint32_t CHECK_INTERVAL = 97; ///< モデルと使用状況を比べる間隔
+constexpr std::size_t MAX_LIVE = 200;   ///< 同時に確保しておく最大数
+
+/// @brief 使用中のブロック（モデル）
+struct Block
+{
+  std::size_t size;  ///< 要求したバイト数
+  std::size_t block; ///< ブロックのバイト数（ヘッダーを含む）
+  uint8_t tag;       ///< 書き込んだ値
+};
+
+/// @brief 使用中のブロックを並べたモデル
+class Model
+{
+  uintptr_t base_;                  ///< メモリの先頭
+  std::size_t total_;               ///< 全体のバイト数
+  std::map<uintptr_t, Block> live_; ///< 使用中のブロック（ブロックの先頭位置順）
+  std::size_t peak_;                ///< 使用中のバイト数の最大値
+  uint32_t fail_;                   ///< 確保に失敗した回数
+
+public:
+  /// @brief コンストラクタ（使用中のブロックがない状態から始める）
+  /// @param [in] base メモリの先頭
+  /// @param [in] total 全体のバイト数
+  Model(uintptr_t base, std::size_t total) : base_(base), total_(total), peak_(getDmaMemStat().peak), fail_(getDmaMemStat().failCount) {}
+  /// @brief 確保して、重ならないことを確かめ、値を書き込む
+  /// @param [in] size バイト数
+  /// @param [in] tag 書き込む値
+  /// @return 確保したメモリ（失敗は0）
+  uint8_t *alloc(std::size_t size, uint8_t tag)
+  {
+    const std::size_t before = getDmaMemStat().used;
+    auto *p = static_cast<uint8_t *>(allocDmaMem(size));
+    if (!p)
+    {
+      ++fail_;
+      CHECK(getDmaMemStat().used == before);
+      return 0;
+    }
+    const uintptr_t pos = reinterpret_cast<uintptr_t>(p) - HEADER_SIZE;
+    const std::size_t block = getDmaMemStat().used - before;
+    CHECK((reinterpret_cast<uintptr_t>(p) & 7) == 0);
+    CHECK(size + HEADER_SIZE <= block && block < size + HEADER_SIZE + 8 + 16); // 切り上げ＋分割しなかった余り
+    CHECK(base_ <= pos && pos + block <= base_ + total_);
+    auto next = live_.lower_bound(pos);
+    CHECK(next == live_.end() || pos + block <= next->first);
+    if (next != live_.begin())
+    {
+      auto prev = std::prev(next);
+      CHECK(prev->first + prev->second.block <= pos);
+    }
+    memset(p, tag, size);
+    live_[pos] = Block{size, block, tag};
+    peak_ = std::max(peak_, used());
+    return p;
+  }
+  /// @brief 内容が壊れていないことを確かめて開放する @param [in] p メモリ
+  void free(uint8_t *p)
+  {
+    auto it = live_.find(reinterpret_cast<uintptr_t>(p) - HEADER_SIZE);
+    CHECK(it != live_.end());
+    bool ok = true;
+    for (std::size_t i = 0; i < it->second.size; ++i)
+    {
+      ok = ok && p[i] == it->second.tag;
+    }
+    test::check(ok, "content", __FILE__, __LINE__);
+    live_.erase(it);
+    freeDmaMem(p);
+  }
+  /// @brief 使用中のバイト数 @return バイト数
+  std::size_t used() const
+  {
+    std::size_t n = 0;
+    for (auto const &b : live_)
+    {
+      n += b.second.block;
+    }
+    return n;
+  }
+  /// @brief 使用中のブロック数 @return ブロック数
+  std::size_t count() const { return live_.size(); }
+  /// @brief n 番目に確保しているメモリ @param [in] n 番号 @return メモリ
+  uint8_t *at(std::size_t n) const
+  {
+    auto it = live_.begin();
+    std::advance(it, n);
+    return reinterpret_cast<uint8_t *>(it->first + HEADER_SIZE);
+  }
+  /// @brief 使用状況をモデルと比べる
+  /// @note 空きブロックは必ず結合されるので、使用中のブロックの隙間がそれぞれ1つの空きブロックになる
+  void verify() const
+  {
+    const DmaMemStat s = getDmaMemStat();
+    std::size_t largest = 0;
+    uint32_t freeCount = 0;
+    uintptr_t end = base_;
+    for (auto const &b : live_)
+    {
+      if (end < b.first)
+      {
+        largest = std::max(largest, b.first - end - HEADER_SIZE);
+        ++freeCount;
+      }
+      end = b.first + b.second.block;
+    }
+    if (end < base_ + total_)
+    {
+      largest = std::max(largest, base_ + total_ - end - HEADER_SIZE);
+      ++freeCount;
+    }
+    CHECK(s.used == used());
+    CHECK(s.usedCount == live_.size());
+    CHECK(s.freeCount == freeCount);
+    CHECK(s.largest == largest);
+    CHECK(s.peak == peak_);
+    CHECK(s.failCount == fail_);
+    CHECK(getFreeDmaMemSize() == total_ - used());
+  }
+};
+} // namespace
+
+int main()
+{
+  // 初期状態は全体が1つの空きブロック
+  const DmaMemStat s0 = getDmaMemStat();
+  printf("total %zu largest %zu free blocks %u\n", s0.total, s0.largest, s0.freeCount);
+  CHECK(s0.used == 0 && s0.usedCount == 0 && s0.peak == 0 && s0.failCount == 0);
+  CHECK(s0.freeCount == 1 && s0.largest == s0.total - HEADER_SIZE);
+  // 全体を一度に確保できる 超えたら失敗
+  uint8_t *whole = static_cast<uint8_t *>(allocDmaMem(s0.largest));
+  CHECK(whole != 0);
+  CHECK(allocDmaMem(1) == 0);
+  freeDmaMem(whole);
+  CHECK(allocDmaMem(s0.total) == 0);
+  CHECK(getDmaMemStat().failCount == 2);
+  CHECK(getDmaMemStat().peak == s0.total);
+  const uintptr_t base = reinterpret_cast<uintptr_t>(whole) - HEADER_SIZE;
+  Model m(base, s0.total);
+  m.verify();
+  {
+    const std::size_t n = 104; // ブロック 112 バイト
+    const std::size_t blk = n + HEADER_SIZE;
+    uint8_t *a = m.alloc(n, 1);
+    uint8_t *b = m.alloc(n, 2);
+    uint8_t *c = m.alloc(n, 3);
+    uint8_t *d = m.alloc(n, 4); // 末尾の空きブロックと隔てる
+    CHECK(b == a + blk && c == b + blk && d == c + blk);
+    m.verify();
+    // 前の空きブロックと結合（a → b の順に開放）
+    m.free(a);
+    m.free(b);
+    m.verify();
+    CHECK(getDmaMemStat().freeCount == 2);
+    // 分割（2ブロック分の空きから1ブロック分を確保すると、残りは空きブロックになる）
+    a = m.alloc(n, 5);
+    CHECK(a == d - 3 * blk);
+    m.verify();
+    CHECK(getDmaMemStat().freeCount == 2);
+    // 後ろの空きブロックと結合（b の空きがある状態で a を開放）
+    m.free(a);
+    m.verify();
+    CHECK(getDmaMemStat().freeCount == 2);
+    uint8_t *ab = m.alloc(2 * blk - HEADER_SIZE, 6);
+    CHECK(ab == d - 3 * blk);
+    m.free(ab);
+    // 前後の空きブロックと結合（a・c を開放してから b を開放）
+    a = m.alloc(n, 7);
+    b = m.alloc(n, 8);
+    m.free(a);
+    m.free(c);
+    CHECK(getDmaMemStat().freeCount == 3);
+    m.free(b);
+    m.verify();
+    CHECK(getDmaMemStat().freeCount == 2);
+    uint8_t *abc = m.alloc(3 * blk - HEADER_SIZE, 9);
+    CHECK(abc == d - 3 * blk);
+    m.free(abc);
+    // ちょうど収まる場合・余りが最小ブロック未満の場合は分割しない
+    uint8_t *exact = m.alloc(3 * blk - HEADER_SIZE - 4, 10); // 8バイト境界に切り上げて同じサイズ
+    CHECK(exact == d - 3 * blk);
+    m.verify();
+    CHECK(getDmaMemStat().freeCount == 1);
+    m.free(exact);
+    uint8_t *rest8 = m.alloc(3 * blk - HEADER_SIZE - 8, 11); // 余り8バイト
+    CHECK(rest8 == d - 3 * blk);
+    m.verify();
+    CHECK(getDmaMemStat().freeCount == 1);
+    CHECK(getDmaMemStat().used == 4 * blk);
+    // 二重開放・範囲外・0・先頭より前は無視する
+    m.free(rest8);
+    const DmaMemStat before = getDmaMemStat();
+    freeDmaMem(rest8);
+    freeDmaMem(0);
+    int outside = 0;
+    freeDmaMem(&outside);
+    freeDmaMem(reinterpret_cast<void *>(base));
+    freeDmaMem(reinterpret_cast<void *>(base + s0.total));
+    const DmaMemStat after = getDmaMemStat();
+    CHECK(after.used == before.used && after.usedCount == before.usedCount && after.freeCount == before.freeCount);
+    CHECK(after.largest == before.largest && after.peak == before.peak && after.failCount == before.failCount);
+    m.verify();
+    m.free(d);
+    m.verify();
+  }
+  // ランダムな確保・開放（1/8 は大きな要求で断片化による失敗も起こす）
+  srand(1);
+  for (uint32_t k = 0; k < RANDOM_OPS; ++k)
+  {
+    if (m.count() == 0 || (rand() % 3 != 0 && m.count() < MAX_LIVE))
+    {
+      const std::size_t n = 1 + rand() % (rand() % 8 == 0 ? 4000 : 200);
+      m.alloc(n, static_cast<uint8_t>(rand()));
+    }
+    else
+    {
+      m.free(m.at(rand() % m.count()));
+    }
+    if (k % CHECK_INTERVAL == 0)
+    {
+      m.verify();
+    }
+  }
+  const DmaMemStat s1 = getDmaMemStat();
+  printf("random : live %u used %zu peak %zu largest %zu free blocks %u fail %u\n", s1.usedCount, s1.used, s1.peak, s1.largest, s1.freeCount, s1.failCount);
+  CHECK(2 < s1.failCount); // 断片化による失敗も数えている
+  while (m.count() != 0)
+  {
+    m.free(m.at(0));
+  }
+  m.verify();
+  const DmaMemStat s2 = getDmaMemStat();
+  CHECK(s2.used == 0 && s2.freeCount == 1 && s2.largest == s2.total - HEADER_SIZE);
+  // UniqueDmaPtr で開放したものを再利用できる
+  for (int k = 0; k < 1000; ++k)
+  {
+    auto a = makeDmaMem<float>(2000);
+    auto b = makeDmaMem<float>(2000);
+    CHECK(a && b);
+  }
+  CHECK(getDmaMemStat().used == 0);
+  // 演算用（MemTag::DTCM）は別の領域で、DMA転送用の使用状況を変えない
+  {
+    const DmaMemStat dma = getDmaMemStat();
+    const DmaMemStat d0 = getDspMemStat();
+    void *p = allocDspMem(1000);
+    CHECK(p != 0 && isDspMem(p) && !isDmaMem(p));
+    CHECK(getDspMemStat().used == d0.used + 1008);
+    CHECK(allocDspMem(d0.total) == 0);
+    void *q = allocDmaMem(1000);
+    CHECK(q != 0 && isDmaMem(q) && !isDspMem(q));
+    freeDspMem(q); // DMA転送用は開放しない
+    CHECK(isDmaMem(q) && getDmaMemStat().used == dma.used + 1008);
+    freeDmaMem(q);
+    freeDspMem(p);
+    const DmaMemStat d1 = getDspMemStat();
+    printf("dsp : total %zu peak %zu fail %u\n", d1.total, d1.peak, d1.failCount);
+    CHECK(d1.used == 0 && d1.failCount == d0.failCount + 1);
+    const DmaMemStat dma1 = getDmaMemStat();
+    CHECK(dma1.used == dma.used && dma1.failCount == dma.failCount && dma1.peak == dma.peak);
+  }
+  return test::result();
+}
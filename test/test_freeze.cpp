@@ -0,0 +1,145 @@
+/// @file      test_freeze.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// フリーズ（Freeze）を長時間フリーズしたままにして、処理時間が一定で、メモリを確保し続けないことを確かめる
+// あわせて、フリーズしていない間・解除した後はそのまま出力されること、フリーズ音が途切れず跳ばないことを確かめる。
+
+#include "common/fpu.h"
+#include "effector/freeze.hpp"
+#include "test.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t FROZEN_BLOCKS = 200000; ///< フリーズしたままにするブロック数（約7分）
+constexpr uint32_t TOGGLE_COUNT = 1000;    ///< フリーズ・解除を繰り返す回数
+constexpr double MAX_DRIFT = 1.5;          ///< 前半に対する後半の処理時間（中央値）の比の上限
+constexpr float MAX_DRY_ERROR = 1e-6f;     ///< フリーズしていない時の入力との差の上限
+constexpr float MAX_STEP = 0.05f;          ///< フリーズ音の隣り合うサンプルの差の上限（入力の最大変化量は約0.029）
+constexpr float MIN_RMS = 0.3f;            ///< フリーズ音の実効値の下限（入力は約0.38）
+constexpr double PI2 = 6.283185307179586;  ///< 2π
+
+/// @brief 入力音 @param [in] t サンプル番号 @return 音声データ
+float input(uint64_t t)
+{
+  return static_cast<float>(0.5 * std::sin(PI2 * 196.0 * t / SAMPLING_FREQ) + 0.2 * std::sin(PI2 * 523.0 * t / SAMPLING_FREQ));
+}
+/// @brief 処理時間の中央値 @param [in] v 処理時間 @return 中央値
+double median(std::vector<double> v)
+{
+  std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+  return v[v.size() / 2];
+}
+
+/// @brief テスト対象と入力位置
+struct Bench
+{
+  fx::Freeze fx;           ///< テスト対象
+  float left[BLOCK_SIZE];  ///< L音声データ
+  float right[BLOCK_SIZE]; ///< R音声データ
+  uint64_t t = 0;          ///< 入力位置
+
+  /// @brief 1ブロック処理する
+  /// @param [in] sound true:入力音 false:無音
+  void block(bool sound)
+  {
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      right[i] = sound ? input(t + i) : 0.0f;
+      left[i] = 0.0f;
+    }
+    t += BLOCK_SIZE;
+    fx.effect(left, right, BLOCK_SIZE);
+  }
+  /// @brief 入力音を1ブロック処理し、入力との差を求める @return 最大誤差
+  float dryError()
+  {
+    block(true);
+    float e = 0;
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      e = std::max(e, std::abs(right[i] - input(t - BLOCK_SIZE + i)));
+    }
+    return e;
+  }
+};
+} // namespace
+
+int main()
+{
+  enableFlushToZero();
+  Bench b;
+  CHECK(static_cast<bool>(b.fx));
+  b.fx.setParam(1, 100); // MIX 100%
+  for (int k = 0; k < 50; ++k)
+  {
+    b.block(true);
+  }
+  const float dry = b.dryError();
+  printf("dry error %g\n", dry);
+  CHECK(dry < MAX_DRY_ERROR);
+  // フリーズしたまま無音を入れ続ける
+  const std::size_t heap = stub::heapUsed();
+  const uint32_t allocs = stub::heapAllocCount();
+  b.fx.notifyEffectKey();
+  std::vector<double> ns(FROZEN_BLOCKS);
+  double sum2 = 0;
+  uint64_t n = 0;
+  float maxStep = 0;
+  float prev = 0;
+  for (uint32_t k = 0; k < FROZEN_BLOCKS; ++k)
+  {
+    std::fill(b.right, b.right + BLOCK_SIZE, 0.0f);
+    std::fill(b.left, b.left + BLOCK_SIZE, 0.0f);
+    test::Stopwatch sw;
+    b.fx.effect(b.left, b.right, BLOCK_SIZE);
+    ns[k] = sw.ns();
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      if (10 < k) // フェードインの後
+      {
+        sum2 += b.right[i] * b.right[i];
+        ++n;
+        maxStep = std::max(maxStep, std::abs(b.right[i] - prev));
+      }
+      prev = b.right[i];
+    }
+  }
+  const float rms = static_cast<float>(std::sqrt(sum2 / n));
+  const double first = median(std::vector<double>(ns.begin(), ns.begin() + FROZEN_BLOCKS / 2));
+  const double last = median(std::vector<double>(ns.begin() + FROZEN_BLOCKS / 2, ns.end()));
+  printf("frozen rms %.3f  max step %.4f\n", rms, maxStep);
+  printf("block ns : first half median %.0f  second half median %.0f  (block period %.0f ns)\n", first, last, test::BLOCK_PERIOD_NS);
+  CHECK(MIN_RMS < rms);
+  CHECK(maxStep < MAX_STEP);
+  CHECK(last < first * MAX_DRIFT);
+  // 解除 → フェードアウトした後はそのまま
+  b.fx.notifyEffectKey();
+  for (int k = 0; k < 20; ++k)
+  {
+    b.block(true);
+  }
+  const float released = b.dryError();
+  printf("released dry error %g\n", released);
+  CHECK(released < MAX_DRY_ERROR);
+  // フリーズ・解除を繰り返す
+  for (uint32_t k = 0; k < TOGGLE_COUNT; ++k)
+  {
+    b.fx.notifyEffectKey();
+    for (int j = 0; j < 7; ++j)
+    {
+      b.block(true);
+    }
+  }
+  printf("heap %zu -> %zu bytes  alloc count %u -> %u\n", heap, stub::heapUsed(), allocs, stub::heapAllocCount());
+  CHECK(stub::heapUsed() == heap);
+  CHECK(stub::heapAllocCount() == allocs);
+  return test::result();
+}
@@ -0,0 +1,204 @@
+/// @file      test_harmonizer.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// ハーモナイザー（Harmonizer）を確かめる
+// 1. PitchDetector::detectStep() を途中で入力を追加せずに最後まで呼ぶと、detect() と同じ結果（ビット単位）になる
+// 2. 合成した音列を入れて、キー・音階・度数毎にずらす半音数が音階に沿っている（updateTable() の対応表）
+//    期待値は、音階の音を並べた表から数えて求める（updateTable() とは別の計算）。
+
+#include "common/fpu.h"
+#include "effector/harmonizer.hpp"
+#include "test.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t NOTE_BLOCKS = static_cast<uint32_t>(0.7f * SAMPLING_FREQ / BLOCK_SIZE); ///< 1音のブロック数（0.7秒）
+constexpr float MAX_SEMITONE_ERROR = 0.2f;                                                  ///< ずらした半音数の誤差の上限
+constexpr double PI2 = 6.283185307179586;                                                   ///< 2π
+
+/// @brief 音階（キーからの半音数）
+const int MAJOR[] = {0, 2, 4, 5, 7, 9, 11};
+const int MINOR[] = {0, 2, 3, 5, 7, 8, 10};
+/// @brief 度数パラメータ毎の音階上の隔たり（-5度, -3度, +3度, +5度）
+const int DEGREE[] = {-4, -2, 2, 4};
+
+/// @brief MIDIノート番号の周波数 @param [in] note ノート番号 @return 周波数
+float noteFreq(int note) { return 440.0f * std::exp2((note - 69) / 12.0f); }
+
+/// @brief 期待するずらす半音数
+/// @param [in] key キー（0:C ～ 11:B）
+/// @param [in] scale 音階（0:メジャー 1:マイナー）
+/// @param [in] intv 度数パラメータ
+/// @param [in] note 入力音（MIDIノート番号）
+/// @return 半音数
+/// @note 音階の音を低い方から並べ、入力音以下で最も高い音から度数分だけ進めた音との差を求める（音階にない音は下の音と同じだけずらす）
+int expectShift(int key, int scale, int intv, int note)
+{
+  std::vector<int> notes;
+  for (int oct = -1; oct <= 11; ++oct)
+  {
+    for (int s : scale ? MINOR : MAJOR)
+    {
+      notes.push_back(12 * oct + key + s);
+    }
+  }
+  size_t i = 0;
+  while (notes[i + 1] <= note)
+  {
+    ++i;
+  }
+  return notes[i + DEGREE[intv]] - notes[i];
+}
+
+/// @brief detectStep() と detect() の結果を比べる
+/// @param [in] name 表示名
+/// @param [in] gen 入力音の生成（サンプル番号から値を返す）
+template <typename GEN>
+void compareDetect(char const *name, GEN gen)
+{
+  PitchDetector a;
+  PitchDetector b;
+  CHECK(static_cast<bool>(a) && static_cast<bool>(b));
+  float buf[BLOCK_SIZE];
+  uint32_t t = 0;
+  for (uint32_t k = 0; k < 40; ++k)
+  {
+    for (auto &x : buf)
+    {
+      x = gen(t++);
+    }
+    a.push(buf, BLOCK_SIZE);
+    b.push(buf, BLOCK_SIZE);
+  }
+  const float fa = a.detect();
+  const float pa = a.getAperiodicity();
+  for (uint32_t count : {1u, 7u, 30u, 1000u})
+  {
+    uint32_t steps = 1;
+    while (!b.detectStep(count))
+    {
+      ++steps;
+    }
+    printf("%-10s step %4u : detect %.4f Hz  detectStep %.4f Hz (%u steps)\n", name, count, fa, b.getFreq(), steps);
+    test::check(b.getFreq() == fa && b.getAperiodicity() == pa, name, __FILE__, __LINE__);
+  }
+}
+
+/// @brief 音列を入れて、ずらした半音数を確かめる
+/// @param [in] key キー
+/// @param [in] scale 音階
+/// @param [in] intv 度数パラメータ
+/// @param [in] notes 入力音（MIDIノート番号）
+/// @return ずらした半音数の最大誤差
+float checkSequence(int key, int scale, int intv, std::vector<int> const &notes)
+{
+  fx::Harmonizer fx;
+  CHECK(static_cast<bool>(fx));
+  fx.setParam(1, 100); // MIX 100%
+  fx.setParam(2, key);
+  fx.setParam(3, scale);
+  fx.setParam(4, intv);
+  float left[BLOCK_SIZE] = {};
+  float right[BLOCK_SIZE];
+  double ph = 0;
+  float worst = 0;
+  printf("key %2d %s %s :", key, scale ? "MIN" : "MAJ", fx.getValueTxt(4));
+  for (int note : notes)
+  {
+    // 減衰する鋸歯状波（6倍音まで）を弾き、後半の出力音程を測る
+    const float f0 = noteFreq(note);
+    PitchDetector pd;
+    float sum = 0;
+    int cnt = 0;
+    for (uint32_t b = 0; b < NOTE_BLOCKS; ++b)
+    {
+      for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+      {
+        const float env = std::exp(-static_cast<float>(b * BLOCK_SIZE + i) / (0.8f * SAMPLING_FREQ));
+        ph += f0 / SAMPLING_FREQ;
+        ph -= std::floor(ph);
+        double y = 0;
+        for (int h = 1; h <= 6; ++h)
+        {
+          y += std::sin(PI2 * h * ph) / h;
+        }
+        right[i] = static_cast<float>(0.25f * env * y);
+      }
+      fx.effect(left, right, BLOCK_SIZE);
+      pd.push(right, BLOCK_SIZE);
+      if (NOTE_BLOCKS / 2 < b && b % 8 == 0)
+      {
+        const float f = pd.detect();
+        if (0 < f)
+        {
+          sum += f;
+          ++cnt;
+        }
+      }
+    }
+    const float got = cnt ? 12 * std::log2(sum / cnt / f0) : 99;
+    const int expect = expectShift(key, scale, intv, note);
+    const float e = std::abs(got - expect);
+    worst = std::max(worst, e);
+    printf(" %d:%+.2f(%+d)", note, got, expect);
+    test::check(e < MAX_SEMITONE_ERROR, "shift", __FILE__, __LINE__);
+  }
+  printf("\n");
+  return worst;
+}
+} // namespace
+
+int main()
+{
+  enableFlushToZero();
+  // 1. detectStep() と detect()
+  compareDetect("A2 saw", [](uint32_t t) {
+    const double ph = 110.0 * t / SAMPLING_FREQ;
+    return static_cast<float>(0.3 * (ph - std::floor(ph)) - 0.15);
+  });
+  compareDetect("E2+E3", [](uint32_t t) {
+    const double w = PI2 * 82.41 * t / SAMPLING_FREQ;
+    return static_cast<float>(0.3 * std::sin(w) + 0.1 * std::sin(2 * w));
+  });
+  compareDetect("A4 sine", [](uint32_t t) { return static_cast<float>(0.3 * std::sin(PI2 * 440.0 * t / SAMPLING_FREQ)); });
+  compareDetect("noise", [](uint32_t) { return static_cast<float>(rand()) / RAND_MAX - 0.5f; });
+  compareDetect("silence", [](uint32_t) { return 0.0f; });
+  // 2. 期待値の計算が updateTable() のコメントの例と一致する（C メジャー +3RD）
+  {
+    const int cMajor3rd[] = {4, 3, 3, 4, 4, 3, 3};
+    for (int d = 0; d < 7; ++d)
+    {
+      CHECK(expectShift(0, 0, 2, 60 + MAJOR[d]) == cMajor3rd[d]);
+    }
+  }
+  // 3. 音列（音階の音・経過音・オクターブ違い）
+  float worst = 0;
+  worst = std::max(worst, checkSequence(0, 0, 2, {60, 62, 64, 65, 67, 55, 57, 59, 66, 48}));
+  worst = std::max(worst, checkSequence(9, 1, 3, {57, 59, 60, 62, 64, 65, 67, 45}));
+  worst = std::max(worst, checkSequence(7, 0, 1, {67, 69, 71, 72, 74, 76, 78}));
+  worst = std::max(worst, checkSequence(4, 0, 0, {64, 66, 68, 69, 71, 73, 75}));
+  // 4. 全ての音階・度数で半音階（経過音を含む12音）
+  for (int scale = 0; scale < 2; ++scale)
+  {
+    for (int intv = 0; intv < 4; ++intv)
+    {
+      const int key = (scale * 4 + intv) * 5 % 12;
+      std::vector<int> notes;
+      for (int n = 0; n < 12; ++n)
+      {
+        notes.push_back(52 + n);
+      }
+      worst = std::max(worst, checkSequence(key, scale, intv, notes));
+    }
+  }
+  printf("worst %.3f semitone\n", worst);
+  return test::result();
+}
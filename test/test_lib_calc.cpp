@@ -0,0 +1,169 @@
+/// @file      test_lib_calc.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// log2・2^x の高速近似（fastLog2 / fastExp2）と dB 変換（gainToDb / dbToGain）の誤差を確かめる
+// 1. 次数毎に使用範囲を細かく調べ、最大絶対誤差・最大相対誤差を表示して、多項式のコメントの値以下であること
+//    （log2 は結果を float に丸めた分を除く）
+// 2. オクターブの境界（2のべき乗）で正確な値になる（連続している）
+// 3. gainToDb は 1e-5 ～ 1、dbToGain は ±128dB で、dB 換算の誤差がコメントの値以下であること
+// 4. 配列版は1要素版と同じ結果になる
+
+#include "effector/lib/lib_calc.hpp"
+#include "test.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t STEPS = 2000000;           ///< 範囲を調べる刻み数
+constexpr double LOG2_MIN = 1e-30;            ///< fastLog2 を調べる最小値
+constexpr double LOG2_MAX = 1e30;             ///< fastLog2 を調べる最大値
+constexpr double EXP2_MIN = -126;             ///< fastExp2 を調べる最小値
+constexpr double EXP2_MAX = 127.99;           ///< fastExp2 を調べる最大値
+constexpr double GAIN_MIN = 1e-5;             ///< gainToDb を調べる最小値
+constexpr double DB_RANGE = 128;              ///< dbToGain を調べる範囲（±dB）
+constexpr double ROUNDING = 1.0 / (1 << 24);  ///< float の丸め誤差（相対）
+constexpr float GAIN_TO_DB_ERROR = 0.0054f;   ///< gainToDb の最大誤差（dB）
+constexpr float DB_TO_GAIN_ERROR = 0.0012f;   ///< dbToGain の最大誤差（dB）
+const float LOG2_ERROR[] = {0, 0.087f, 7.7e-3f, 8.8e-4f, 1.2e-4f, 1.6e-5f};   ///< 次数毎の fastLog2 の最大絶対誤差
+const float EXP2_ERROR[] = {0, 6.2e-2f, 3.3e-3f, 1.4e-4f, 7.1e-6f, 2.8e-6f}; ///< 次数毎の fastExp2 の最大相対誤差
+
+/// @brief fastLog2 の誤差
+/// @tparam ORDER 次数
+/// @param [out] wideErr 全範囲の最大絶対誤差（結果を float に丸めた分 |log2(x)| × 2^-24 を除く）
+/// @return 1 ≦ x < 2 の最大絶対誤差（多項式の誤差）
+template <uint8_t ORDER>
+double log2Error(double &wideErr)
+{
+  wideErr = 0;
+  const double r = std::log(LOG2_MAX / LOG2_MIN);
+  for (uint32_t i = 0; i <= STEPS; ++i)
+  {
+    const float x = static_cast<float>(LOG2_MIN * std::exp(r * i / STEPS));
+    const double ref = std::log2(static_cast<double>(x));
+    wideErr = std::max(wideErr, std::abs(fastLog2<ORDER>(x) - ref) - std::abs(ref) * ROUNDING);
+  }
+  double e = 0;
+  for (uint32_t i = 0; i < STEPS; ++i)
+  {
+    const float x = static_cast<float>(1.0 + static_cast<double>(i) / STEPS);
+    e = std::max(e, std::abs(fastLog2<ORDER>(x) - std::log2(static_cast<double>(x))));
+  }
+  return e;
+}
+/// @brief fastExp2 の誤差 @tparam ORDER 次数 @return 全範囲の最大相対誤差
+template <uint8_t ORDER>
+double exp2Error()
+{
+  double e = 0;
+  for (uint32_t i = 0; i <= STEPS; ++i)
+  {
+    const float x = static_cast<float>(EXP2_MIN + (EXP2_MAX - EXP2_MIN) * i / STEPS);
+    e = std::max(e, std::abs(fastExp2<ORDER>(x) / std::exp2(static_cast<double>(x)) - 1));
+  }
+  // 1オクターブ内はさらに細かく調べる
+  for (uint32_t i = 0; i < STEPS; ++i)
+  {
+    const float x = static_cast<float>(static_cast<double>(i) / STEPS);
+    e = std::max(e, std::abs(fastExp2<ORDER>(x) / std::exp2(static_cast<double>(x)) - 1));
+  }
+  return e;
+}
+/// @brief 次数毎の誤差を表示して確かめる @tparam ORDER 次数
+template <uint8_t ORDER>
+void checkOrder()
+{
+  double log2Wide = 0;
+  const double log2Err = log2Error<ORDER>(log2Wide);
+  const double exp2Err = exp2Error<ORDER>();
+  printf("  %u   | %.2e | %.2e | %.2e\n", ORDER, log2Err, log2Wide, exp2Err);
+  test::check(log2Err <= LOG2_ERROR[ORDER], "log2 error", __FILE__, __LINE__);
+  test::check(log2Wide <= LOG2_ERROR[ORDER], "log2 error (wide)", __FILE__, __LINE__);
+  test::check(exp2Err <= EXP2_ERROR[ORDER], "exp2 error", __FILE__, __LINE__);
+  // オクターブの境界
+  bool exact = true;
+  for (int k = -126; k <= 127; ++k)
+  {
+    const float p = std::ldexp(1.0f, k);
+    exact = exact && fastLog2<ORDER>(p) == static_cast<float>(k) && fastExp2<ORDER>(static_cast<float>(k)) == p;
+  }
+  test::check(exact, "octave boundary", __FILE__, __LINE__);
+  // 配列版
+  std::vector<float> src;
+  for (int i = 1; i <= 1000; ++i)
+  {
+    src.push_back(0.013f * i * i - 40.0f);
+  }
+  std::vector<float> dst(src.size());
+  fastExp2<ORDER>(src.data(), dst.data(), static_cast<uint32_t>(src.size()));
+  bool same = true;
+  for (size_t i = 0; i < src.size(); ++i)
+  {
+    same = same && dst[i] == fastExp2<ORDER>(src[i]);
+  }
+  fastLog2<ORDER>(dst.data(), src.data(), static_cast<uint32_t>(dst.size()));
+  for (size_t i = 0; i < dst.size(); ++i)
+  {
+    same = same && src[i] == fastLog2<ORDER>(dst[i]);
+  }
+  test::check(same, "array", __FILE__, __LINE__);
+}
+} // namespace
+
+int main()
+{
+  // 1. 2. 次数毎の誤差
+  printf("ORDER | log2 abs | log2 abs (1e-30 .. 1e30) | exp2 rel\n");
+  checkOrder<1>();
+  checkOrder<2>();
+  checkOrder<3>();
+  checkOrder<4>();
+  checkOrder<5>();
+  // 3. dB 変換
+  {
+    double e = 0;
+    const double r = std::log(1 / GAIN_MIN);
+    for (uint32_t i = 0; i <= STEPS; ++i)
+    {
+      const float x = static_cast<float>(GAIN_MIN * std::exp(r * i / STEPS));
+      e = std::max(e, std::abs(gainToDb(x) - 20 * std::log10(static_cast<double>(x))));
+    }
+    printf("gainToDb : max error %.5f dB (1e-5 .. 1)\n", e);
+    CHECK(e <= GAIN_TO_DB_ERROR);
+  }
+  {
+    double e = 0;
+    for (uint32_t i = 0; i <= STEPS; ++i)
+    {
+      const float x = static_cast<float>(-DB_RANGE + 2 * DB_RANGE * i / STEPS);
+      e = std::max(e, std::abs(20 * std::log10(static_cast<double>(dbToGain(x))) - x));
+    }
+    printf("dbToGain : max error %.5f dB (+-128 dB)\n", e);
+    CHECK(e <= DB_TO_GAIN_ERROR);
+  }
+  // 4. dB 変換の配列版
+  {
+    std::vector<float> src;
+    for (int i = 0; i <= 1000; ++i)
+    {
+      src.push_back(0.25f * i - 120.0f);
+    }
+    std::vector<float> gain(src.size());
+    std::vector<float> db(src.size());
+    dbToGain(src.data(), gain.data(), static_cast<uint32_t>(src.size()));
+    gainToDb(gain.data(), db.data(), static_cast<uint32_t>(gain.size()));
+    bool same = true;
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+      same = same && gain[i] == dbToGain(src[i]) && db[i] == gainToDb(gain[i]);
+    }
+    CHECK(same);
+  }
+  return test::result();
+}
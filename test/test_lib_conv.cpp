@@ -0,0 +1,133 @@
+/// @file      test_lib_conv.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// 均一分割畳み込み（UniformConvolver）・キャビネットを、直接畳み込みと比較する
+
+#include "effector/cabinet.hpp"
+#include "effector/lib/lib_conv.hpp"
+#include "test.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t BLOCKS = 40;                 ///< 処理するブロック数
+constexpr uint32_t TOTAL = BLOCK_SIZE * BLOCKS; ///< 処理するサンプル数
+
+/// @brief -0.5 ～ 0.5 の乱数列 @param [in] size 要素数 @return 乱数列
+std::vector<float> noise(uint32_t size)
+{
+  std::vector<float> v(size);
+  for (auto &x : v)
+  {
+    x = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+  }
+  return v;
+}
+/// @brief 直接畳み込み（倍精度）
+/// @param [in] x 入力
+/// @param [in] h IR
+/// @param [in] len IR長
+/// @return 出力（入力と同じ長さ）
+std::vector<float> direct(std::vector<float> const &x, float const *h, uint32_t len)
+{
+  std::vector<float> y(x.size());
+  for (size_t n = 0; n < x.size(); ++n)
+  {
+    double sum = 0;
+    for (uint32_t k = 0; k < len && k <= n; ++k)
+    {
+      sum += static_cast<double>(h[k]) * x[n - k];
+    }
+    y[n] = static_cast<float>(sum);
+  }
+  return y;
+}
+/// @brief 最大誤差 @param [in] a 比較対象 @param [in] b 比較対象 @return 最大誤差
+float maxError(std::vector<float> const &a, std::vector<float> const &b)
+{
+  float e = 0;
+  for (size_t i = 0; i < a.size(); ++i)
+  {
+    e = std::max(e, std::abs(a[i] - b[i]));
+  }
+  return e;
+}
+/// @brief UniformConvolver で畳み込む
+/// @param [in] x 入力
+/// @param [in] h IR
+/// @param [in] len IR長
+/// @param [in] count 処理に使う分割数（0ならばIR長から求める）
+/// @param [in] inPlace 入力と出力を同じ領域にする
+/// @return 出力
+std::vector<float> uniform(std::vector<float> const &x, float const *h, uint32_t len, uint32_t count, bool inPlace)
+{
+  const uint32_t parts = UniformConvolver::partitionCount(len);
+  UniformConvolver conv(parts);
+  std::vector<float> spec(parts * UniformConvolver::FFT_SIZE);
+  conv.makeSpectrum(h, len, spec.data());
+  std::vector<float> y(x.size());
+  for (size_t b = 0; b < x.size(); b += BLOCK_SIZE)
+  {
+    if (inPlace)
+    {
+      std::copy(&x[b], &x[b] + BLOCK_SIZE, &y[b]);
+      conv.process(&y[b], &y[b], spec.data(), count ? count : parts);
+    }
+    else
+    {
+      conv.process(&x[b], &y[b], spec.data(), count ? count : parts);
+    }
+  }
+  return y;
+}
+} // namespace
+
+int main()
+{
+  srand(1);
+  const auto x = noise(TOTAL);
+  // IR長（分割の境界前後・内蔵IRと同じ長さ・ブロック長を大きく超える長さ）
+  for (uint32_t len : {1u, 95u, 96u, 97u, 192u, fx::cabinet::IR_LENGTH, 1000u})
+  {
+    const auto h = noise(len);
+    const auto ref = direct(x, h.data(), len);
+    const float e = maxError(uniform(x, h.data(), len, 0, false), ref);
+    const float eInPlace = maxError(uniform(x, h.data(), len, 0, true), ref);
+    printf("len %4u : max error %.2e (in place %.2e)\n", len, e, eInPlace);
+    CHECK(e < 1e-4f * std::sqrt(static_cast<float>(len)));
+    CHECK(eInPlace == e);
+  }
+  // 分割数を減らすと、IRの先頭だけを畳み込む
+  {
+    const auto h = noise(fx::cabinet::IR_LENGTH);
+    const float e = maxError(uniform(x, h.data(), fx::cabinet::IR_LENGTH, 2, false), direct(x, h.data(), BLOCK_SIZE * 2));
+    printf("2 of %u partitions : max error %.2e\n", UniformConvolver::partitionCount(fx::cabinet::IR_LENGTH), e);
+    CHECK(e < 1e-4f);
+  }
+  // キャビネット（MIX 100%・LV 0dB）は内蔵IRの畳み込みになる
+  for (uint32_t type = 0; type < fx::cabinet::IR_COUNT; ++type)
+  {
+    fx::Cabinet cab;
+    CHECK(static_cast<bool>(cab));
+    cab.setParam(0, 0);
+    cab.setParam(1, 100);
+    cab.setParam(2, type);
+    std::vector<float> y = x;
+    std::vector<float> left(BLOCK_SIZE);
+    for (size_t b = 0; b < y.size(); b += BLOCK_SIZE)
+    {
+      cab.effect(left.data(), &y[b], BLOCK_SIZE);
+    }
+    const float e = maxError(y, direct(x, fx::cabinet::IR[type], fx::cabinet::IR_LENGTH));
+    printf("Cabinet %-8s : max error %.2e\n", fx::cabinet::IR_NAME[type], e);
+    CHECK(e < 1e-3f);
+  }
+  return test::result();
+}
@@ -0,0 +1,172 @@
+/// @file      test_lib_fft.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// 実数FFT（RealFft）を、倍精度の離散フーリエ変換（DFT）と比較する（64 ～ 4096点 インプレース・アウトオブプレース）
+
+#include "effector/lib/lib_fft.hpp"
+#include "test.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr double PI2 = 6.283185307179586; ///< 2π
+
+/// @brief -0.5 ～ 0.5 の乱数列 @param [in] size 要素数 @return 乱数列
+std::vector<float> noise(uint32_t size)
+{
+  std::vector<float> v(size);
+  for (auto &x : v)
+  {
+    x = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+  }
+  return v;
+}
+/// @brief 実数入力のDFT（RealFft と同じ格納形式）
+/// @param [in] x 実数入力
+/// @return スペクトル
+std::vector<double> dft(std::vector<float> const &x)
+{
+  const uint64_t n = x.size();
+  std::vector<double> X(n);
+  for (uint64_t k = 0; k <= n / 2; ++k)
+  {
+    double re = 0;
+    double im = 0;
+    for (uint64_t t = 0; t < n; ++t)
+    {
+      const double w = PI2 * static_cast<double>(k * t % n) / n;
+      re += x[t] * std::cos(w);
+      im -= x[t] * std::sin(w);
+    }
+    if (k == 0)
+    {
+      X[0] = re;
+    }
+    else if (k == n / 2)
+    {
+      X[1] = re;
+    }
+    else
+    {
+      X[k * 2] = re;
+      X[k * 2 + 1] = im;
+    }
+  }
+  return X;
+}
+/// @brief 逆DFT（RealFft と同じ格納形式のスペクトルから実数出力 1/Nのスケーリング込み）
+/// @param [in] X スペクトル
+/// @return 実数出力
+std::vector<double> idft(std::vector<float> const &X)
+{
+  const uint64_t n = X.size();
+  std::vector<double> x(n);
+  for (uint64_t t = 0; t < n; ++t)
+  {
+    double sum = X[0] + ((t & 1) ? -X[1] : X[1]);
+    for (uint64_t k = 1; k < n / 2; ++k)
+    {
+      const double w = PI2 * static_cast<double>(k * t % n) / n;
+      sum += 2 * (X[k * 2] * std::cos(w) - X[k * 2 + 1] * std::sin(w));
+    }
+    x[t] = sum / n;
+  }
+  return x;
+}
+/// @brief 最大誤差 @param [in] a 比較対象 @param [in] b 比較対象 @return 最大誤差
+template <typename A, typename B>
+double maxError(A const &a, B const &b)
+{
+  double e = 0;
+  for (size_t i = 0; i < a.size(); ++i)
+  {
+    e = std::max(e, std::abs(static_cast<double>(a[i]) - b[i]));
+  }
+  return e;
+}
+
+/// @brief N点のテスト
+template <uint32_t N>
+void testSize()
+{
+  RealFft<N> fft;
+  const auto x = noise(N);
+  // 順変換 : DFTと比較 インプレースとアウトオブプレースは同じ結果になる
+  std::vector<float> X(N);
+  fft.forward(x.data(), X.data());
+  std::vector<float> Xin = x;
+  fft.forward(Xin.data(), Xin.data());
+  const double eFwd = maxError(X, dft(x));
+  // 逆変換 : 逆DFTと比較
+  const auto S = noise(N);
+  std::vector<float> s(N);
+  fft.inverse(S.data(), s.data());
+  std::vector<float> sIn = S;
+  fft.inverse(sIn.data(), sIn.data());
+  const double eInv = maxError(s, idft(S));
+  // 往復
+  std::vector<float> y(N);
+  fft.inverse(X.data(), y.data());
+  const double eRound = maxError(y, x);
+  printf("N=%4u : forward %.2e  inverse %.2e  round trip %.2e\n", N, eFwd, eInv, eRound);
+  // 誤差は √N・log2(N) 程度で増える（入力は ±0.5）
+  const double tol = 2e-7 * std::sqrt(static_cast<double>(N)) * std::log2(static_cast<double>(N));
+  CHECK(eFwd < tol);
+  CHECK(eInv < tol / 100);
+  CHECK(eRound < tol / 10);
+  CHECK(Xin == X);
+  CHECK(sIn == s);
+}
+} // namespace
+
+int main()
+{
+  srand(1);
+  testSize<64>();
+  testSize<128>();
+  testSize<256>();
+  testSize<512>();
+  testSize<1024>();
+  testSize<2048>();
+  testSize<4096>();
+  // 回転因子テーブル
+  double e = 0;
+  for (uint32_t m = 0; m < fft::MAX_SIZE; ++m)
+  {
+    e = std::max(e, std::abs(fft::Twiddle<>::sin(m) - std::sin(PI2 * m / fft::MAX_SIZE)));
+    e = std::max(e, std::abs(fft::Twiddle<>::cos(m) - std::cos(PI2 * m / fft::MAX_SIZE)));
+  }
+  printf("twiddle : %.2e\n", e);
+  CHECK(e < 1e-7);
+  // スペクトルの積（周波数領域の積は巡回畳み込み）
+  {
+    constexpr uint32_t N = 64;
+    RealFft<N> fft;
+    const auto a = noise(N);
+    const auto b = noise(N);
+    std::vector<float> A(N), B(N), acc(N, 0.0f), c(N);
+    fft.forward(a.data(), A.data());
+    fft.forward(b.data(), B.data());
+    RealFft<N>::multiplyAdd(A.data(), B.data(), acc.data());
+    fft.inverse(acc.data(), c.data());
+    std::vector<double> ref(N);
+    for (uint32_t n = 0; n < N; ++n)
+    {
+      for (uint32_t k = 0; k < N; ++k)
+      {
+        ref[n] += static_cast<double>(a[k]) * b[(n - k) % N];
+      }
+    }
+    const double eMul = maxError(c, ref);
+    printf("multiplyAdd : %.2e\n", eMul);
+    CHECK(eMul < 1e-5);
+  }
+  return test::result();
+}
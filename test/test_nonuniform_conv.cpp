@@ -0,0 +1,155 @@
+/// @file      test_nonuniform_conv.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// 非均一分割畳み込み（NonUniformConvolver）を確かめる
+// 1. 短いIRから約1秒（44433タップ）のIRまで、直接畳み込みと比較する（各段の境界前後を含む）
+// 2. IR最大長より短いIRを設定した場合・clear() した後も同じ結果になる
+// 3. 約1秒のIRで、ブロック毎の処理時間（平均・最悪）を測る
+
+#include "effector/lib/lib_conv.hpp"
+#include "test.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t LONG_IR = 44433;        ///< 約1秒のIR長
+constexpr uint32_t TAIL = BLOCK_SIZE * 64; ///< IR長より後に処理するサンプル数（最終段の窓4つ分）
+constexpr float MAX_ERROR = 3e-6f;         ///< 出力の実効値に対する最大誤差の比の上限
+constexpr uint32_t COST_BLOCKS = 20000;    ///< 処理時間を測るブロック数
+constexpr double MAX_AVG_RATIO = 0.1;      ///< 1ブロックの処理時間に対する平均処理時間の上限（ホスト）
+constexpr double MAX_WORST_RATIO = 0.5;    ///< 1ブロックの処理時間に対する最悪処理時間（p99.9）の上限（ホスト）
+
+/// @brief -0.5 ～ 0.5 の乱数列 @param [in] size 要素数 @return 乱数列
+std::vector<float> noise(uint32_t size)
+{
+  std::vector<float> v(size);
+  for (auto &x : v)
+  {
+    x = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+  }
+  return v;
+}
+/// @brief 直接畳み込み（倍精度）
+/// @param [in] x 入力
+/// @param [in] h IR
+/// @return 出力（入力と同じ長さ）
+std::vector<double> direct(std::vector<float> const &x, std::vector<float> const &h)
+{
+  std::vector<double> y(x.size());
+  for (size_t n = 0; n < x.size(); ++n)
+  {
+    double sum = 0;
+    const size_t m = std::min(h.size(), n + 1);
+    for (size_t k = 0; k < m; ++k)
+    {
+      sum += static_cast<double>(h[k]) * x[n - k];
+    }
+    y[n] = sum;
+  }
+  return y;
+}
+/// @brief NonUniformConvolver で畳み込む
+/// @param [in] conv テスト対象（IR設定済み）
+/// @param [in] x 入力（BLOCK_SIZE の倍数）
+/// @return 出力
+std::vector<float> process(NonUniformConvolver &conv, std::vector<float> const &x)
+{
+  std::vector<float> y = x;
+  for (size_t b = 0; b < y.size(); b += BLOCK_SIZE)
+  {
+    conv.process(&y[b], &y[b]);
+  }
+  return y;
+}
+/// @brief 出力の実効値に対する最大誤差の比
+/// @param [in] y 比較対象
+/// @param [in] ref 直接畳み込みの結果
+/// @return 最大誤差の比
+float relError(std::vector<float> const &y, std::vector<double> const &ref)
+{
+  double e = 0;
+  double sum2 = 0;
+  for (size_t i = 0; i < y.size(); ++i)
+  {
+    e = std::max(e, std::abs(y[i] - ref[i]));
+    sum2 += ref[i] * ref[i];
+  }
+  return static_cast<float>(e / std::sqrt(sum2 / y.size()));
+}
+/// @brief 入力のサンプル数（IR長 + TAIL をブロック単位に切り上げる） @param [in] len IR長 @return サンプル数
+uint32_t inputSize(uint32_t len) { return (len + TAIL + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE; }
+} // namespace
+
+int main()
+{
+  srand(1);
+  // 1. IR長（0段目・各段の開始位置 2P の前後・各段の分割の途中・約1秒）
+  float worst = 0;
+  for (uint32_t len : {1u, 96u, 383u, 384u, 385u, 767u, 768u, 769u, 1535u, 1536u, 1537u, 3071u, 3072u, 3073u, 4700u, 10000u, LONG_IR})
+  {
+    const auto h = noise(len);
+    const auto x = noise(inputSize(len));
+    NonUniformConvolver conv(len);
+    CHECK(static_cast<bool>(conv));
+    conv.setIr(h.data(), len);
+    const float e = relError(process(conv, x), direct(x, h));
+    printf("len %5u : max error / rms %.2e\n", len, e);
+    worst = std::max(worst, e);
+    test::check(e < MAX_ERROR, "len", __FILE__, __LINE__);
+  }
+  printf("worst %.2e\n", worst);
+  // 2. 最大長より短いIR・clear() の後
+  {
+    const auto h = noise(5000);
+    const auto x = noise(inputSize(LONG_IR));
+    const auto ref = direct(x, h);
+    NonUniformConvolver conv(LONG_IR);
+    CHECK(static_cast<bool>(conv));
+    conv.setIr(h.data(), static_cast<uint32_t>(h.size()));
+    const auto y = process(conv, x);
+    const float e = relError(y, ref);
+    printf("len %u of %u : max error / rms %.2e\n", static_cast<uint32_t>(h.size()), LONG_IR, e);
+    CHECK(e < MAX_ERROR);
+    conv.clear();
+    CHECK(process(conv, x) == y);
+  }
+  // 3. 約1秒のIRでのブロック毎の処理時間
+  {
+    const auto h = noise(LONG_IR);
+    NonUniformConvolver conv(LONG_IR);
+    conv.setIr(h.data(), LONG_IR);
+    float buf[BLOCK_SIZE];
+    std::vector<double> ns(COST_BLOCKS);
+    for (uint32_t b = 0; b < COST_BLOCKS; ++b)
+    {
+      for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+      {
+        buf[i] = 0.3f * std::sin(0.05f * (b * BLOCK_SIZE + i));
+      }
+      test::Stopwatch sw;
+      conv.process(buf, buf);
+      ns[b] = sw.ns();
+    }
+    double sum = 0;
+    for (double v : ns)
+    {
+      sum += v;
+    }
+    std::sort(ns.begin(), ns.end());
+    const double avg = sum / COST_BLOCKS;
+    const double p999 = ns[COST_BLOCKS * 999 / 1000];
+    printf("len %u : avg %.0f ns/block  p99.9 %.0f ns/block  max %.0f ns/block  (block period %.0f ns)\n", LONG_IR, avg, p999, ns.back(),
+           test::BLOCK_PERIOD_NS);
+    CHECK(avg < test::BLOCK_PERIOD_NS * MAX_AVG_RATIO);
+    CHECK(p999 < test::BLOCK_PERIOD_NS * MAX_WORST_RATIO);
+  }
+  return test::result();
+}
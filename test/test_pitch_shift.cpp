@@ -0,0 +1,151 @@
+/// @file      test_pitch_shift.cpp
+/// @author    SATOH GADGET
+/// @copyright Copyright© 2021 SATOH GADGET
+///
+/// DO NOT USE THIS SOFTWARE WITHOUT THE SOFTWARE LICENSE AGREEMENT.
+
+// ピッチシフター（PitchShifter）の出力音程の精度と、ブロック毎の処理時間を確かめる
+// 出力音程は、ハン窓をかけた長い区間のスペクトル（DTFT）の最大ピークから求める（製品のピッチ検出器は使わない）。
+
+#include "common/fpu.h"
+#include "effector/pitch_shifter.hpp"
+#include "test.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace satoh;
+
+namespace
+{
+constexpr uint32_t SETTLE_BLOCKS = 100;   ///< 音程を測らずに捨てるブロック数（約0.2秒）
+constexpr uint32_t MEASURE_SIZE = 32768;  ///< 音程を測るサンプル数（約0.74秒）
+constexpr double MAX_CENT_ERROR = 3.0;    ///< 音程誤差の上限（セント）
+constexpr uint32_t COST_BLOCKS = 20000;   ///< 処理時間を測るブロック数
+constexpr double MAX_COST_RATIO = 0.25;   ///< 1ブロックの処理時間に対する平均処理時間の上限（ホスト）
+constexpr double PI2 = 6.283185307179586; ///< 2π
+
+/// @brief ハン窓をかけた信号の、周波数 f の振幅（DTFT）
+/// @param [in] x 信号（ハン窓をかけたもの）
+/// @param [in] f 周波数
+/// @return 振幅
+double dtft(std::vector<double> const &x, double f)
+{
+  const double w = PI2 * f / SAMPLING_FREQ;
+  double re = 0;
+  double im = 0;
+  for (size_t n = 0; n < x.size(); ++n)
+  {
+    re += x[n] * std::cos(w * n);
+    im -= x[n] * std::sin(w * n);
+  }
+  return std::sqrt(re * re + im * im);
+}
+/// @brief 期待する周波数 ±1半音 で最大ピークの周波数を求める
+/// @param [in] y 信号
+/// @param [in] expect 期待する周波数
+/// @return ピークの周波数
+double peakFreq(std::vector<float> const &y, double expect)
+{
+  std::vector<double> x(y.size());
+  for (size_t n = 0; n < y.size(); ++n)
+  {
+    x[n] = y[n] * (0.5 - 0.5 * std::cos(PI2 * n / y.size()));
+  }
+  // 1セント刻みで探し、放物線補間する
+  int best = 0;
+  double mag[201];
+  for (int c = -100; c <= 100; ++c)
+  {
+    mag[c + 100] = dtft(x, expect * std::exp2(c / 1200.0));
+    best = mag[c + 100] > mag[best + 100] ? c : best;
+  }
+  double d = 0;
+  if (-100 < best && best < 100)
+  {
+    const double ym = mag[best + 99];
+    const double y0 = mag[best + 100];
+    const double yp = mag[best + 101];
+    d = 0.5 * (ym - yp) / (ym - 2 * y0 + yp);
+  }
+  return expect * std::exp2((best + d) / 1200.0);
+}
+/// @brief 基音 f0 の音を semi 半音ずらし、出力音程の誤差を求める
+/// @param [in] f0 基音の周波数
+/// @param [in] semi 半音
+/// @return 誤差（セント）
+double centError(double f0, int semi)
+{
+  fx::PitchShifter fx;
+  fx.setParam(0, 0);   // LEVEL 0dB
+  fx.setParam(1, 100); // MIX 100%
+  fx.setParam(2, semi);
+  fx.setParam(3, 0); // FINE
+  float left[BLOCK_SIZE] = {};
+  float right[BLOCK_SIZE];
+  std::vector<float> y;
+  uint32_t t = 0;
+  for (uint32_t b = 0; y.size() < MEASURE_SIZE; ++b)
+  {
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i, ++t)
+    {
+      const double ph = PI2 * f0 * t / SAMPLING_FREQ;
+      right[i] = static_cast<float>(0.3 * std::sin(ph) + 0.1 * std::sin(2 * ph));
+    }
+    fx.effect(left, right, BLOCK_SIZE);
+    if (SETTLE_BLOCKS <= b)
+    {
+      y.insert(y.end(), right, right + BLOCK_SIZE);
+    }
+  }
+  y.resize(MEASURE_SIZE);
+  const double expect = f0 * std::exp2(semi / 12.0);
+  return 1200 * std::log2(peakFreq(y, expect) / expect);
+}
+} // namespace
+
+int main()
+{
+  enableFlushToZero();
+  // 出力音程（ギター6弦E ～ A4、-12 ～ +12半音）
+  double worst = 0;
+  for (double f0 : {82.41, 110.0, 196.0, 440.0})
+  {
+    printf("f0 %6.2f Hz :", f0);
+    for (int semi : {-12, -7, -5, -1, 1, 3, 4, 7, 12})
+    {
+      const double e = centError(f0, semi);
+      printf(" %+d:%+.2f", semi, e);
+      worst = std::max(worst, std::abs(e));
+    }
+    printf(" cent\n");
+  }
+  printf("worst %.2f cent\n", worst);
+  CHECK(worst < MAX_CENT_ERROR);
+  // ブロック毎の処理時間
+  fx::PitchShifter fx;
+  fx.setParam(2, 7);
+  float left[BLOCK_SIZE] = {};
+  float right[BLOCK_SIZE];
+  std::vector<double> ns(COST_BLOCKS);
+  for (uint32_t b = 0; b < COST_BLOCKS; ++b)
+  {
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
+    {
+      right[i] = 0.3f * std::sin(0.05f * (b * BLOCK_SIZE + i));
+    }
+    test::Stopwatch sw;
+    fx.effect(left, right, BLOCK_SIZE);
+    ns[b] = sw.ns();
+  }
+  double sum = 0;
+  for (double v : ns)
+  {
+    sum += v;
+  }
+  std::sort(ns.begin(), ns.end());
+  const double avg = sum / COST_BLOCKS;
+  printf("PitchShifter : avg %.0f ns/block  p99.9 %.0f ns/block  (block period %.0f ns)\n", avg, ns[COST_BLOCKS * 999 / 1000], test::BLOCK_PERIOD_NS);
+  CHECK(avg < test::BLOCK_PERIOD_NS * MAX_COST_RATIO);
+  return test::result();
+}